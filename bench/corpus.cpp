@@ -0,0 +1,169 @@
+/**
+ * @file corpus.cpp
+ * @brief Implements the page generators and the loading of checked-in pages.
+ */
+#include "corpus.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const kWords[] = {
+    "the",     "browser", "parses", "pages",   "quickly", "while",  "layout",  "waits",   "for",
+    "images",  "and",     "text",   "arrives", "over",    "slow",   "links",   "network", "cache",
+    "render",  "node",    "tree",   "vector",  "block",   "scroll", "memory",  "thread",  "decode",
+    "request", "server",  "header", "result",  "window",  "tab",    "offline", "search",  "article"};
+
+constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+// Deterministic choices for one page.
+class Chooser {
+public:
+    explicit Chooser(uint32_t seed) : random_(seed) {}
+
+    size_t below(size_t limit) { return std::uniform_int_distribution<size_t>(0, limit - 1)(random_); }
+    bool chance(unsigned percent) { return below(100) < percent; }
+    const char* word() { return kWords[below(kWordCount)]; }
+
+    std::string sentence(size_t words) {
+        std::string result;
+        for (size_t i = 0; i < words; ++i) {
+            if (i) result += ' ';
+            result += word();
+        }
+        return result;
+    }
+
+    std::string token(size_t length) {
+        static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789-_";
+        std::string result(length, 'a');
+        for (char& c : result) c = kAlphabet[below(sizeof(kAlphabet) - 1)];
+        return result;
+    }
+
+private:
+    std::mt19937 random_;
+};
+
+void appendMixed(Chooser& choose, std::string& html) {
+    const size_t roll = choose.below(100);
+    if (roll < 50) {
+        html += "    <p>";
+        html += choose.sentence(8 + choose.below(40));
+        if (choose.chance(20)) html += " &amp; " + choose.sentence(4) + " &mdash; " + choose.sentence(3);
+        if (choose.chance(30)) html += "\n      " + choose.sentence(6); // wrapped source line
+        html += "</p>\n";
+    } else if (roll < 60) {
+        const char* tag = choose.chance(50) ? "h1" : "h2";
+        html += std::string("    <") + tag + ">" + choose.sentence(2 + choose.below(6)) + "</" + tag + ">\n";
+    } else if (roll < 72) {
+        html += "    <a href=\"/" + std::string(choose.word()) + "/" + std::to_string(choose.below(100000)) + "\">" +
+                choose.sentence(1 + choose.below(4)) + "</a>\n";
+    } else if (roll < 85) {
+        html += "    <div class=\"" + std::string(choose.word()) + "\"><span>" + choose.sentence(3 + choose.below(10)) +
+                "</span></div>\n";
+    } else if (roll < 90) {
+        html += "    <img src=\"/img/" + choose.token(12) + ".png\" width=\"" + std::to_string(64 + choose.below(400)) +
+                "\" height=\"" + std::to_string(48 + choose.below(300)) + "\">\n";
+    } else if (roll < 95) {
+        html += "    <!-- " + choose.sentence(5) + " -->\n";
+    } else {
+        html += "    <ul><li>" + choose.sentence(4) + "</li><li>" + choose.sentence(4) + "</li></ul>\n";
+    }
+}
+
+void appendAttributes(Chooser& choose, std::string& html) {
+    // Nested containers, each element heavy with attributes and light on text.
+    const size_t depth = 2 + choose.below(6);
+    for (size_t level = 0; level < depth; ++level) {
+        const char* tag = level % 2 ? "span" : "div";
+        html += std::string(level * 2, ' ') + "<" + tag;
+        html += " id=\"n" + choose.token(10) + "\"";
+        html += " class=\"" + std::string(choose.word()) + " " + choose.word() + " " + choose.token(8) + "\"";
+        const size_t extra = 10 + choose.below(14);
+        for (size_t i = 0; i < extra; ++i) {
+            switch (choose.below(4)) {
+            case 0: html += " data-" + std::string(choose.word()) + "=\"" + choose.token(8 + choose.below(32)) + "\""; break;
+            case 1: html += " aria-" + std::string(choose.word()) + "=\"" + choose.sentence(2 + choose.below(4)) + "\""; break;
+            case 2: html += " style=\"color: #" + choose.token(6) + "; margin: " + std::to_string(choose.below(20)) + "px\""; break;
+            default: html += " title=\"" + choose.sentence(3 + choose.below(6)) + "\""; break;
+            }
+        }
+        html += ">";
+        if (choose.chance(40)) html += choose.sentence(2 + choose.below(5));
+        html += "\n";
+    }
+    for (size_t level = depth; level-- > 0;) {
+        html += std::string(level * 2, ' ') + (level % 2 ? "</span>\n" : "</div>\n");
+    }
+}
+
+void appendImages(Chooser& choose, std::string& html) {
+    html += "    <img src=\"https://images.example.com/" + choose.token(16) + (choose.chance(80) ? ".jpg" : ".svg") +
+            "\" width=\"" + std::to_string(100 + choose.below(700)) + "\" height=\"" +
+            std::to_string(80 + choose.below(500)) + "\" alt=\"" + choose.sentence(3) + "\"" +
+            (choose.chance(30) ? " loading=\"eager\"" : " loading=\"lazy\"") + ">\n";
+    if (choose.chance(60)) html += "    <p>" + choose.sentence(3 + choose.below(8)) + "</p>\n";
+}
+
+std::string sizeName(size_t bytes) {
+    if (bytes >= (1u << 20)) return std::to_string(bytes >> 20) + "MB";
+    return std::to_string(bytes >> 10) + "KB";
+}
+
+const char* kindName(PageKind kind) {
+    switch (kind) {
+    case PageKind::Mixed: return "mixed";
+    case PageKind::Attributes: return "attributes";
+    case PageKind::Images: return "images";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+std::string generatePage(PageKind kind, size_t bytes, uint32_t seed) {
+    Chooser choose(seed);
+    std::string html = "<!DOCTYPE html>\n<html>\n  <head><title>" + choose.sentence(4) + "</title></head>\n  <body>\n";
+    html.reserve(bytes + 4096);
+    while (html.size() < bytes) {
+        switch (kind) {
+        case PageKind::Mixed: appendMixed(choose, html); break;
+        case PageKind::Attributes: appendAttributes(choose, html); break;
+        case PageKind::Images: appendImages(choose, html); break;
+        }
+    }
+    html += "  </body>\n</html>\n";
+    return html;
+}
+
+std::vector<CorpusPage> loadCorpusDirectory(const std::string& directory) {
+    std::vector<CorpusPage> pages;
+    std::error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".html") continue;
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::ostringstream html;
+        html << file.rdbuf();
+        pages.push_back(CorpusPage{"real/" + entry.path().stem().string(), html.str()});
+    }
+    std::sort(pages.begin(), pages.end(),
+              [](const CorpusPage& a, const CorpusPage& b) { return a.name < b.name; });
+    return pages;
+}
+
+std::vector<CorpusPage> buildCorpus(const std::string& directory) {
+    std::vector<CorpusPage> pages;
+    for (PageKind kind : {PageKind::Mixed, PageKind::Attributes, PageKind::Images}) {
+        for (size_t bytes : {size_t(1) << 10, size_t(64) << 10, size_t(1) << 20, size_t(20) << 20}) {
+            pages.push_back(CorpusPage{std::string(kindName(kind)) + "/" + sizeName(bytes), generatePage(kind, bytes)});
+        }
+    }
+    for (CorpusPage& page : loadCorpusDirectory(directory)) pages.push_back(std::move(page));
+    return pages;
+}
\ No newline at end of file
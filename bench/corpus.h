@@ -0,0 +1,52 @@
+/**
+ * @file corpus.h
+ * @brief Defines the pages the benchmarks parse and render.
+ */
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One page of the benchmark corpus.
+ */
+struct CorpusPage {
+    std::string name; // "<kind>/<size>" for generated pages, "real/<file>" for checked-in ones
+    std::string html;
+};
+
+/**
+ * @brief Shapes of generated pages.
+ */
+enum class PageKind {
+    Mixed,      // text, headers, links and a few images, pretty-printed, some entities
+    Attributes, // nested elements carrying a dozen or more long attributes each
+    Images      // mostly img elements with width, height and alt, and short captions
+};
+
+/**
+ * @brief Generates a page of a kind, at least the given size.
+ *
+ * Output depends only on the arguments, so every run and every machine
+ * benchmarks the same bytes.
+ */
+std::string generatePage(PageKind kind, size_t bytes, uint32_t seed = 1);
+
+/**
+ * @brief Loads the *.html files of a directory, sorted by name.
+ * @return The pages; empty if the directory is missing.
+ */
+std::vector<CorpusPage> loadCorpusDirectory(const std::string& directory);
+
+/**
+ * @brief Returns the whole corpus.
+ *
+ * Generated pages of every kind at 1 KB, 64 KB, 1 MB and 20 MB, then the
+ * checked-in pages of the directory.
+ */
+std::vector<CorpusPage> buildCorpus(const std::string& directory);
+
+#endif // CORPUS_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ * @file quickdom_bench.cpp
+ * @brief Parser throughput and render speed over the benchmark corpus.
+ *
+ * parse/<parser>/<page> reports MB/s of HTML turned into a Document.
+ * display_list/<page> builds, lays out and paints the first screen the way
+ * a tab does; widgets/<page> runs Renderer::render into a layout. Both
+ * report nodes/s. Qt runs on the offscreen platform unless QT_QPA_PLATFORM
+ * says otherwise, so the benchmarks need no display.
+ */
+#include <benchmark/benchmark.h>
+#include <QApplication>
+#include <QBuffer>
+#include <QByteArray>
+#include <QImage>
+#include <QPainter>
+#include <QVBoxLayout>
+#include <QWidget>
+#include "corpus.h"
+#include "html_parser.h"
+#include "image_cache.h"
+#include "media_buffer.h"
+#include "parser_factory.h"
+#include "renderer.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef QUICKDOM_BENCH_CORPUS_DIR
+#define QUICKDOM_BENCH_CORPUS_DIR "bench/corpus"
+#endif
+
+namespace {
+
+constexpr int kViewportWidth = 800;
+constexpr int kViewportHeight = 600;
+// A widget per element stops being meaningful, and affordable, past this.
+constexpr size_t kMaxWidgetPageBytes = 1u << 20;
+
+const ParserKind kParsers[] = {ParserKind::Scalar, ParserKind::Sse2, ParserKind::Avx2, ParserKind::Avx512,
+                               ParserKind::Neon};
+
+void setNodeRate(benchmark::State& state, const Document& document) {
+    state.counters["nodes/s"] = benchmark::Counter(
+        static_cast<double>(document.nodeCount()) * static_cast<double>(state.iterations()),
+        benchmark::Counter::kIsRate);
+}
+
+// Every parse copies the page, as a load moves the downloaded body into the
+// document; the copy is part of what a page load pays.
+void parsePage(benchmark::State& state, ParserKind kind, const CorpusPage* page) {
+    if (!parserKindSupported(kind)) {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    std::unique_ptr<HtmlParser> parser = createParser(kind);
+    size_t nodes = 0;
+    for (auto _ : state) {
+        Document document = parser->parseDocument(page->html);
+        nodes = document.nodeCount();
+        benchmark::DoNotOptimize(nodes);
+    }
+    const double bytes = static_cast<double>(page->html.size()) * static_cast<double>(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["MB/s"] = benchmark::Counter(bytes / 1e6, benchmark::Counter::kIsRate);
+    state.counters["nodes"] = static_cast<double>(nodes);
+}
+
+// The path a tab takes: lazy images, deferred decodes, one view painted.
+void buildDisplayList(benchmark::State& state, const CorpusPage* page) {
+    const Document document = createParser()->parseDocument(page->html);
+    DisplayListOptions options;
+    options.defer_decodes = true;
+    options.lazy_images = true;
+    Renderer renderer;
+    QImage screen(kViewportWidth, kViewportHeight, QImage::Format_ARGB32_Premultiplied);
+    for (auto _ : state) {
+        DisplayList list = renderer.buildDisplayList(document, nullptr, options);
+        list.layout(kViewportWidth);
+        QPainter painter(&screen);
+        list.paint(painter, QRect(0, 0, kViewportWidth, kViewportHeight));
+    }
+    setNodeRate(state, document);
+}
+
+// One small PNG under every image source of the page, as fetched media.
+MediaMap imageMedia(const Document& document) {
+    QImage image(64, 48, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::darkGray);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    const std::string bytes(png.constData(), static_cast<size_t>(png.size()));
+
+    MediaMap media;
+    document.forEachNode([&](NodeId id) {
+        const std::string src(document.attribute(id, "src"));
+        if (!src.empty() && !media.count(src)) media[src] = MediaBuffer::fromBytes(bytes, "image/png", src);
+    });
+    return media;
+}
+
+// Renderer::render into a layout; each iteration deletes the widgets it built.
+void renderWidgets(benchmark::State& state, const CorpusPage* page) {
+    const Document document = createParser()->parseDocument(page->html);
+    const MediaMap media = imageMedia(document);
+    QWidget view;
+    view.resize(kViewportWidth, kViewportHeight);
+    auto* layout = new QVBoxLayout(&view);
+    Renderer renderer;
+    for (auto _ : state) {
+        renderer.render(document, layout, &media);
+        while (QLayoutItem* item = layout->takeAt(0)) {
+            delete item->widget();
+            delete item;
+        }
+    }
+    setNodeRate(state, document);
+    ImageCache::instance().clear();
+}
+
+void registerBenchmarks(const std::vector<CorpusPage>& corpus) {
+    for (ParserKind kind : kParsers) {
+        for (const CorpusPage& page : corpus) {
+            const std::string name = std::string("parse/") + parserKindName(kind) + "/" + page.name;
+            benchmark::RegisterBenchmark(name.c_str(), parsePage, kind, &page)->Unit(benchmark::kMillisecond);
+        }
+    }
+    for (const CorpusPage& page : corpus) {
+        benchmark::RegisterBenchmark(("display_list/" + page.name).c_str(), buildDisplayList, &page)
+            ->Unit(benchmark::kMillisecond);
+    }
+    for (const CorpusPage& page : corpus) {
+        if (page.html.size() > kMaxWidgetPageBytes) continue;
+        benchmark::RegisterBenchmark(("widgets/" + page.name).c_str(), renderWidgets, &page)
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    const char* directory = std::getenv("QUICKDOM_BENCH_CORPUS");
+    static const std::vector<CorpusPage> corpus = buildCorpus(directory ? directory : QUICKDOM_BENCH_CORPUS_DIR);
+    registerBenchmarks(corpus);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
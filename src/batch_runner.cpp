@@ -0,0 +1,232 @@
+/**
+ * @file batch_runner.cpp
+ * @brief Implements the headless batch mode.
+ */
+#include "batch_runner.h"
+#include <QMetaObject>
+#include <QThread>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include "json_text.h"
+#include "timeline.h"
+#include "trace.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Loads queued per worker thread, so a worker never waits for the GUI
+// thread to start the next one.
+constexpr size_t kLoadsPerThread = 2;
+
+int64_t microseconds(std::chrono::microseconds duration) {
+    return static_cast<int64_t>(duration.count());
+}
+
+// Appends the href of every link, in document order.
+void appendLinks(std::string& out, const Document& document) {
+    out += "\"links\":[";
+    bool first = true;
+    document.forEachNode([&](NodeId id) {
+        std::string_view href;
+        if (document.node(id).tag == TagAtom::A && document.findAttribute(id, "href", href) && !href.empty()) {
+            if (!first) out += ',';
+            first = false;
+            appendJsonString(out, href);
+        }
+    });
+    out += ']';
+}
+
+// Appends the element tree as nested {"tag","attributes","text","children"}
+// objects, leaving out empty members. Walks with an explicit stack, so deep
+// pages cannot overflow the worker's stack.
+void appendDom(std::string& out, const Document& document) {
+    out += "\"dom\":";
+    struct Frame {
+        NodeId id;
+        bool open; // false once the node's children have been written
+    };
+    std::vector<Frame> stack{{document.root(), true}};
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        const NodeId id = frame.id;
+        const DomNode& node = document.node(id);
+        if (!frame.open) {
+            stack.pop_back();
+            out += node.first_child != kNoNode ? "]}" : "}";
+            if (!stack.empty() && node.next_sibling != kNoNode) {
+                out += ',';
+                stack.push_back({node.next_sibling, true});
+            }
+            continue;
+        }
+        frame.open = false;
+        out += "{\"tag\":";
+        const std::string_view tag = tagName(node.tag);
+        appendJsonString(out, tag.empty() ? nodeTypeName(node.tag) : tag);
+        if (const size_t count = document.attributeCount(id)) {
+            out += ",\"attributes\":{";
+            for (size_t i = 0; i < count; ++i) {
+                if (i) out += ',';
+                appendJsonString(out, document.attributeName(id, i));
+                out += ':';
+                appendJsonString(out, document.attributeValue(id, i));
+            }
+            out += '}';
+        }
+        if (!document.text(id).empty()) {
+            out += ",\"text\":";
+            appendJsonString(out, document.text(id));
+        }
+        if (node.first_child != kNoNode) {
+            out += ",\"children\":[";
+            stack.push_back({node.first_child, true});
+        }
+    }
+}
+
+struct RenderSummary {
+    bool done = false;
+    int height = 0;
+    size_t items = 0;
+    std::chrono::microseconds time{0};
+};
+
+std::string pageRecord(size_t index, const PageLoadResult& result, const RenderSummary& render,
+                       std::chrono::microseconds total, bool dom) {
+    const Document& document = result.document;
+    std::string out;
+    out.reserve(256 + (dom ? document.source().size() : 0));
+    out += "{\"index\":" + std::to_string(index) + ",\"url\":";
+    appendJsonString(out, result.url);
+    out += ",\"complete\":";
+    out += result.complete ? "true" : "false";
+    out += ",\"bytes\":" + std::to_string(document.source().size());
+    out += ",\"nodes\":" + std::to_string(document.nodeCount());
+    out += ",\"images\":" + std::to_string(result.media.size());
+    out += ",\"timings\":{\"fetch_us\":" + std::to_string(microseconds(result.timings.fetch));
+    out += ",\"parse_us\":" + std::to_string(microseconds(result.timings.parse));
+    out += ",\"media_us\":" + std::to_string(microseconds(result.timings.media));
+    if (render.done) out += ",\"render_us\":" + std::to_string(microseconds(render.time));
+    out += ",\"total_us\":" + std::to_string(microseconds(total)) + "},";
+    appendLinks(out, document);
+    if (render.done) {
+        out += ",\"height\":" + std::to_string(render.height);
+        out += ",\"items\":" + std::to_string(render.items);
+    }
+    if (dom) {
+        out += ',';
+        appendDom(out, document);
+    }
+    out += '}';
+    return out;
+}
+
+} // namespace
+
+std::string batchUrl(std::string_view entry) {
+    const std::string url(entry);
+    if (url.find("://") != std::string::npos) return url;
+    std::error_code error;
+    const std::filesystem::path path = std::filesystem::absolute(url, error);
+    return "file://" + (error ? url : path.string());
+}
+
+std::vector<std::string> readBatchList(std::istream& in) {
+    std::vector<std::string> urls;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+        const size_t end = line.find_last_not_of(" \t\r");
+        urls.push_back(batchUrl(std::string_view(line).substr(begin, end - begin + 1)));
+    }
+    return urls;
+}
+
+BatchRunner::BatchRunner(Network& network, HtmlParser& parser, std::ostream& out, BatchOptions options,
+                         QObject* parent)
+    : QObject(parent), network_(network), parser_(parser), out_(out), options_(options) {
+    pool_.setMaxThreadCount(options_.threads > 0 ? options_.threads : QThread::idealThreadCount());
+}
+
+BatchRunner::~BatchRunner() {
+    // Loads use the network and parser from the workers; stop them first.
+    for (PageLoad* load : findChildren<PageLoad*>()) load->cancel();
+    pool_.waitForDone();
+}
+
+void BatchRunner::start(std::vector<std::string> urls) {
+    urls_ = std::move(urls);
+    next_ = 0;
+    QUICKDOM_TRACE_INFO("Batch started", "pages=", urls_.size(), " threads=", pool_.maxThreadCount());
+    if (urls_.empty()) {
+        emit finished();
+        return;
+    }
+    startLoads();
+}
+
+void BatchRunner::startLoads() {
+    const size_t window = static_cast<size_t>(pool_.maxThreadCount()) * kLoadsPerThread;
+    while (next_ < urls_.size() && in_flight_ < window) {
+        const size_t index = next_++;
+        ++in_flight_;
+        auto* load = new PageLoad(network_, parser_, urls_[index], options_.timeout, this);
+        load->setLazyImages(options_.lazy_images);
+        load->setTimelineTab(index); // the page's position in the list stands in for a tab
+        const Clock::time_point started = Clock::now();
+        connect(load, &PageLoad::finished, this, [this, load, index, started]() { onLoaded(load, index, started); });
+        load->start(&pool_);
+    }
+}
+
+void BatchRunner::onLoaded(PageLoad* load, size_t index, Clock::time_point started) {
+    load->deleteLater();
+    auto result = std::make_shared<PageLoadResult>(load->takeResult());
+    if (!result->complete) {
+        QUICKDOM_TRACE_WARN("Batch page incomplete", result->url);
+    }
+
+    // Widgets and pixmaps belong to the GUI thread, so rendering stays here,
+    // with the options a tab uses.
+    RenderSummary render;
+    if (options_.render) {
+        TimelineTabScope tab(index);
+        TimelineSpan span("render", "load", result->url);
+        const Clock::time_point render_start = Clock::now();
+        DisplayListOptions options;
+        options.defer_decodes = true;
+        options.lazy_images = options_.lazy_images;
+        DisplayList list = renderer_.buildDisplayList(result->document, &result->media, options);
+        render.height = list.layout(options_.width);
+        render.items = list.size();
+        render.time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - render_start);
+        render.done = true;
+    }
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started);
+
+    const bool dom = options_.dom;
+    pool_.start([this, index, result, render, total, dom]() {
+        const bool complete = result->complete;
+        QMetaObject::invokeMethod(this, [this, record = pageRecord(index, *result, render, total, dom), complete]() {
+            write(record, complete);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void BatchRunner::write(const std::string& record, bool complete) {
+    out_ << record << '\n';
+    out_.flush(); // let consumers read records while the batch runs
+    ++written_;
+    if (complete) ++complete_;
+    --in_flight_;
+    if (written_ == urls_.size()) {
+        QUICKDOM_TRACE_INFO("Batch finished", "pages=", written_, " complete=", complete_);
+        emit finished();
+        return;
+    }
+    startLoads();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file batch_runner.h
+ * @brief Defines the headless batch mode that loads many pages in parallel.
+ */
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "page_load.h"
+#include "renderer.h"
+#include <QObject>
+#include <QThreadPool>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief What a batch does with each page besides loading it.
+ */
+struct BatchOptions {
+    int threads = 0;          // worker threads; 0 uses one per core
+    bool render = false;      // build and lay out each page's display list
+    bool dom = false;         // include the element tree in each record
+    bool lazy_images = true;  // fetch only loading="eager" images, as a tab does
+    int width = 800;          // layout width when rendering
+    std::chrono::milliseconds timeout = PageLoad::kDefaultTimeout;
+};
+
+/**
+ * @brief Turns an entry of a page list into a URL; local paths become file:// URLs.
+ */
+std::string batchUrl(std::string_view entry);
+
+/**
+ * @brief Reads a page list: one URL or path per line, blank lines and # comments skipped.
+ */
+std::vector<std::string> readBatchList(std::istream& in);
+
+/**
+ * @class BatchRunner
+ * @brief Loads a list of pages without a window and writes one JSON line per page.
+ *
+ * Every page goes through PageLoad, the pipeline a tab uses: streamed fetch
+ * and parse, then the eager images, on the runner's worker threads. With
+ * render set, the display list is built and laid out on the GUI thread as
+ * BrowserWindow::showPage() does, against an offscreen platform when there
+ * is no display. Records are serialized on the workers too, so the GUI
+ * thread only dispatches, renders and writes. A bounded number of loads is
+ * in flight at once, which keeps memory flat on long lists.
+ *
+ * Records come out in completion order and carry the page's index in the
+ * list:
+ *
+ *     {"index":0,"url":"...","complete":true,"bytes":5120,"nodes":88,"images":3,
+ *      "timings":{"fetch_us":..,"parse_us":..,"media_us":..,"render_us":..,"total_us":..},
+ *      "links":["/a","/b"],"height":2400,"items":61,"dom":{"tag":"#root","children":[...]}}
+ *
+ * height and items appear only when rendering, dom only when requested.
+ */
+class BatchRunner : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @param network Network to fetch with; must outlive the runner.
+     * @param parser Parser shared by all loads; must outlive the runner.
+     * @param out Receives the records, one per line.
+     */
+    BatchRunner(Network& network, HtmlParser& parser, std::ostream& out, BatchOptions options = BatchOptions(),
+                QObject* parent = nullptr);
+    ~BatchRunner() override;
+
+    /**
+     * @brief Starts loading the pages; finished() follows the last record.
+     */
+    void start(std::vector<std::string> urls);
+
+    size_t pageCount() const { return urls_.size(); }
+    size_t writtenCount() const { return written_; }
+    size_t completeCount() const { return complete_; }
+
+signals:
+    void finished();
+
+private:
+    void startLoads();
+    void onLoaded(PageLoad* load, size_t index, std::chrono::steady_clock::time_point started);
+    void write(const std::string& record, bool complete);
+
+    Network& network_;
+    HtmlParser& parser_;
+    std::ostream& out_;
+    BatchOptions options_;
+    std::vector<std::string> urls_;
+    size_t next_ = 0;      // first page not started yet
+    size_t in_flight_ = 0; // started and not yet written
+    size_t written_ = 0;
+    size_t complete_ = 0;
+    Renderer renderer_;
+    QThreadPool pool_; // runs loads and serializes their records
+};
+
+#endif // BATCH_RUNNER_H
\ No newline at end of file
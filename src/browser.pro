@@ -10,7 +10,7 @@ INCLUDEPATH += $$PWD/include
 macx {
     message("Configuring for macOS")
     INCLUDEPATH += /opt/homebrew/include
-    LIBS += -L/opt/homebrew/lib -lcurl
+    LIBS += -L/opt/homebrew/lib -lcurl -lz
     LIBS += -framework QtWidgets -framework QtSvg -framework QtGui
     LIBS += -framework QtTest -framework QtCore
 }
@@ -18,16 +18,18 @@ macx {
 unix:!macx {
     message("Configuring for Linux")
     INCLUDEPATH += /usr/include /usr/local/include
-    LIBS += -L/usr/lib -L/usr/local/lib -lcurl
+    LIBS += -L/usr/lib -L/usr/local/lib -lcurl -lz
     LIBS += -lQt5Widgets -lQt5Svg -lQt5Gui -lQt5Test -lQt5Core
 }
 
 win32 {
     message("Configuring for Windows")
     INCLUDEPATH += $$quote(C:/Program Files/libcurl/include)
+    INCLUDEPATH += $$quote(C:/Program Files/zlib/include)
     LIBS += -L$$quote(C:/Program Files/libcurl/lib) -lcurl
+    LIBS += -L$$quote(C:/Program Files/zlib/lib) -lzlib
     # For Qt libraries, rely on Qt's built-in paths on Windows
-    # Ensure libcurl is installed (e.g., via vcpkg or manual installation)
+    # Ensure libcurl and zlib are installed (e.g., via vcpkg or manual installation)
 }
 
 # Main application target
@@ -39,15 +41,56 @@ SOURCES = \
     main.cpp \
     browser_window.cpp \
     html_parser.cpp \
+    dom.cpp \
+    cpu_features.cpp \
+    text_normalizer.cpp \
+    parser_factory.cpp \
+    trace.cpp \
+    timeline.cpp \
+    json_text.cpp \
+    http_cache.cpp \
+    media_buffer.cpp \
+    media_cache.cpp \
     network.cpp \
+    image_cache.cpp \
+    image_decoder.cpp \
+    computed_style.cpp \
+    display_list.cpp \
     renderer.cpp \
+    page_view.cpp \
+    page_load.cpp \
+    batch_runner.cpp \
+    tab_snapshot.cpp \
+    tab_lifecycle.cpp \
     link_label.cpp
 
 HEADERS = \
     browser_window.h \
     html_parser.h \
+    dom.h \
+    tag_atoms.h \
+    cpu_features.h \
+    text_normalizer.h \
+    parser_factory.h \
+    trace.h \
+    timeline.h \
+    ring_registry.h \
+    json_text.h \
+    hash_combine.h \
+    http_cache.h \
+    media_buffer.h \
+    media_cache.h \
     network.h \
+    image_cache.h \
+    image_decoder.h \
+    computed_style.h \
+    display_list.h \
     renderer.h \
+    page_view.h \
+    page_load.h \
+    batch_runner.h \
+    tab_snapshot.h \
+    tab_lifecycle.h \
     link_label.h
 
 # Test configuration
@@ -63,8 +106,25 @@ test {
     SOURCES += \
         ../tests/main_test.cpp \
         ../tests/test_html_parser.cpp \
+        ../tests/test_dom.cpp \
+        ../tests/test_tag_atoms.cpp \
+        ../tests/test_text_normalizer.cpp \
+        ../tests/test_parser_factory.cpp \
+        ../tests/test_trace.cpp \
+        ../tests/test_timeline.cpp \
+        ../tests/test_http_cache.cpp \
+        ../tests/test_media_buffer.cpp \
+        ../tests/test_media_cache.cpp \
         ../tests/test_network.cpp \
+        ../tests/test_image_cache.cpp \
+        ../tests/test_image_decoder.cpp \
         ../tests/test_renderer.cpp \
+        ../tests/test_computed_style.cpp \
+        ../tests/test_display_list.cpp \
+        ../tests/test_page_load.cpp \
+        ../tests/test_batch_runner.cpp \
+        ../tests/test_tab_snapshot.cpp \
+        ../tests/test_tab_lifecycle.cpp \
         ../tests/test_browser_window.cpp \
         ../tests/test_link_label.cpp
 
@@ -84,6 +144,37 @@ test {
     OBJECTS_DIR = ../tests/build/obj
     MOC_DIR = ../tests/build/moc
 }
+else:bench {
+    message("Building benchmarks")
+    TEMPLATE = app
+    TARGET = quickdom_bench
+    CONFIG += console release
+    CONFIG -= app_bundle debug
+
+    # Benchmarks replace the application entry point
+    SOURCES -= main.cpp
+    SOURCES += \
+        ../bench/corpus.cpp \
+        ../bench/quickdom_bench.cpp
+    HEADERS += ../bench/corpus.h
+    INCLUDEPATH += ../bench
+    DEFINES += QUICKDOM_BENCH_CORPUS_DIR=\\\"$$PWD/../bench/corpus\\\"
+
+    # Google Benchmark dependencies
+    macx {
+        LIBS += -L/opt/homebrew/lib -lbenchmark -pthread
+    }
+    unix:!macx {
+        LIBS += -L/usr/lib -L/usr/local/lib -lbenchmark -pthread
+    }
+    win32 {
+        LIBS += -L$$quote(C:/Program Files/benchmark/lib) -lbenchmark -lshlwapi
+    }
+
+    DESTDIR = ../bench/build
+    OBJECTS_DIR = ../bench/build/obj
+    MOC_DIR = ../bench/build/moc
+}
 else {
     message("Building main application")
     DESTDIR = ./build
@@ -3,26 +3,65 @@
  * @brief Implements browser GUI and tab management.
  */
 #include "browser_window.h"
-#include "link_label.h"
+#include "page_view.h"
+#include "timeline.h"
+#include "trace.h"
 #include <QApplication>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QScrollArea>
-#include <QFile>
-#include <QTextStream>
+#include <QThread>
+#include <QScrollBar>
+#include <QShortcut>
+#include <QSignalBlocker>
+#include <QTimer>
 #include <QPalette>
+#include <QRunnable>
+#include <algorithm>
 
-BrowserWindow::BrowserWindow(QWidget *parent)
+namespace {
+
+// Rough cost of a page's scroll area and view widgets.
+constexpr size_t kWidgetBytes = 8192;
+// How often tab footprints and system memory pressure are checked.
+constexpr int kMemoryCheckMs = 5000;
+
+// Fetches a batch of a page's lazy images concurrently on the load pool.
+class LazyImageTask : public QRunnable {
+public:
+    LazyImageTask(Network& network, std::vector<std::string> sources, std::string base_url,
+                  std::shared_ptr<TransferControl> control, PageView::MediaDone done, uint64_t tab)
+        : network_(network), sources_(std::move(sources)), base_url_(std::move(base_url)),
+          control_(std::move(control)), done_(std::move(done)), tab_(tab) {}
+
+    void run() override {
+        if (control_->cancelled.load(std::memory_order_relaxed)) return;
+        TimelineTabScope tab(tab_);
+        TimelineSpan span("lazy_media", "load", base_url_);
+        MediaBatchOptions options;
+        options.control = control_.get();
+        network_.fetchMediaBuffers(sources_, base_url_, [this](size_t index, const MediaBufferPtr& buffer) {
+            done_(index, buffer);
+        }, options);
+    }
+
+private:
+    Network& network_;
+    std::vector<std::string> sources_;
+    std::string base_url_;
+    std::shared_ptr<TransferControl> control_;
+    PageView::MediaDone done_;
+    uint64_t tab_;
+};
+
+} // namespace
+
+BrowserWindow::BrowserWindow(QWidget *parent, ParserKind parser_kind)
     : QMainWindow(parent),
-      parser_(
-#if defined(__x86_64__) || defined(__i386__)
-          new SimdParser()
-#elif defined(__arm64__)
-          new NeonParser()
-#else
-          new ScalarParser()
-#endif
-      ) {
+      parser_(createParser(parser_kind)) {
+    // Loads mostly wait on the network, so allow a few even on small machines.
+    load_pool_.setMaxThreadCount(std::max(4, QThread::idealThreadCount()));
+
     // Set dark theme
     QPalette palette;
     palette.setColor(QPalette::Window, Qt::black);
@@ -53,63 +92,191 @@ BrowserWindow::BrowserWindow(QWidget *parent)
     layout->addWidget(tabs_);
     connect(tabs_, &QTabWidget::currentChanged, this, &BrowserWindow::onTabChanged);
 
+    auto* timeline_shortcut = new QShortcut(QKeySequence("Ctrl+Shift+E"), this);
+    connect(timeline_shortcut, &QShortcut::activated, this, &BrowserWindow::toggleTimeline);
+
+    auto* memory_timer = new QTimer(this);
+    connect(memory_timer, &QTimer::timeout, this, &BrowserWindow::enforceMemoryBudget);
+    memory_timer->start(kMemoryCheckMs);
+
     setWindowTitle("QuickDOM");
     resize(800, 600);
 }
 
+BrowserWindow::~BrowserWindow() {
+    // Loads use network_ and parser_ from worker threads; stop them before those go.
+    for (PageLoad* load : findChildren<PageLoad*>()) load->cancel();
+    for (const auto& fetches : page_fetches_) fetches->cancel();
+    load_pool_.waitForDone();
+}
+
+void BrowserWindow::setTabMemoryBudget(size_t bytes) {
+    lifecycle_.setBudget(bytes);
+    enforceMemoryBudget();
+}
+
 void BrowserWindow::openNewTab() {
-    std::string url = url_bar_->text().toStdString();
-    std::string html = network_.fetch(url);
-    Node root = parser_->parse(html);
-
-    // Load media
-    for (auto& child : root.children) {
-        if (child.type == "image") {
-            auto src_it = child.attributes.find("src");
-            if (src_it != child.attributes.end()) {
-                std::string media_path = network_.fetchMedia(src_it->second, url);
-                if (!media_path.empty()) {
-                    child.attributes["src"] = media_path;
-                }
-            }
-        }
-    }
+    const QString url = url_bar_->text();
+    QScrollArea* page = createPage();
+    int index = tabs_->addTab(page, url);
+    frozen_tabs_[index] = url;
+    lifecycle_.touch(static_cast<uint64_t>(index));
+    loadPage(page, url);
+}
 
+QScrollArea* BrowserWindow::createPage() {
     auto* scroll_area = new QScrollArea(this);
     scroll_area->setStyleSheet("QScrollArea { background: black; }");
-    auto* content_widget = new QWidget();
-    content_widget->setStyleSheet("background: black;");
-    auto* content_layout = new QVBoxLayout(content_widget);
-    content_layout->setAlignment(Qt::AlignTop);
-    renderer_.render(root, content_layout);
-
-    // Connect link clicks
-    for (int i = 0; i < content_layout->count(); ++i) {
-        auto* item = content_layout->itemAt(i);
-        if (item && item->widget()) {
-            if (auto* label = qobject_cast<QLabel*>(item->widget())) {
-                if (label->property("isLink").toBool()) {
-                    auto* link_label = new LinkLabel(content_widget);
-                    link_label->setText(label->text());
-                    link_label->setStyleSheet(label->styleSheet());
-                    link_label->setProperty("href", label->property("href"));
-                    connect(link_label, &LinkLabel::clicked, this, &BrowserWindow::handleLinkClicked);
-                    content_layout->replaceWidget(label, link_label);
-                    label->deleteLater();
-                }
-            }
+    scroll_area->setWidgetResizable(true);
+    auto* loading = new QLabel("Loading...");
+    loading->setStyleSheet("color: white; background: black;");
+    loading->setAlignment(Qt::AlignCenter);
+    scroll_area->setWidget(loading);
+    return scroll_area;
+}
+
+void BrowserWindow::loadPage(QScrollArea* page, const QString& url) {
+    // Owned by the page, so freezing or closing the tab cancels the load.
+    auto* load = new PageLoad(network_, *parser_, url.toStdString(), PageLoad::kDefaultTimeout, page);
+    load->setTimelineTab(timelineTabOf(page));
+    connect(load, &PageLoad::finished, this, [this, page, load]() {
+        load->deleteLater();
+        showPage(page, load->takeResult());
+    });
+    load->start(&load_pool_);
+}
+
+void BrowserWindow::showPage(QScrollArea* page, PageLoadResult result) {
+    if (!result.complete) {
+        QUICKDOM_TRACE_WARN("Showing incomplete page", result.url);
+    }
+    // One painted widget per page; links are hit-tested in its display list.
+    // Images the load did not fetch wait as placeholders until scrolled near.
+    TimelineTabScope tab(timelineTabOf(page));
+    DisplayListOptions options;
+    options.defer_decodes = true;
+    options.lazy_images = true;
+    options.device_pixel_ratio = page->devicePixelRatioF();
+    DisplayList list;
+    {
+        TimelineSpan span("render", "load", result.url);
+        list = renderer_.buildDisplayList(result.document, &result.media, options);
+    }
+    {
+        // Link handling, lazy fetching and decodes hang off the view.
+        TimelineSpan span("attach", "load", result.url);
+        auto* view = new PageView(std::move(list), startDecodes(page));
+        connect(view, &PageView::linkClicked, this, &BrowserWindow::openLink);
+        startFetches(page, view, result.url);
+        page->setWidget(view); // replaces the loading label
+    }
+    // Kept so freezing the tab can snapshot it instead of discarding it.
+    page_contents_[page] = std::move(result);
+
+    const int index = tabs_->indexOf(page);
+    if (index >= 0) lifecycle_.setFootprint(static_cast<uint64_t>(index), pageFootprint(page));
+}
+
+void BrowserWindow::restorePage(QScrollArea* page, TabSnapshot snapshot) {
+    PageLoadResult result;
+    result.url = snapshot.url;
+    result.document = std::move(snapshot.document);
+    result.complete = true;
+    for (const MediaReference& reference : snapshot.media) {
+        if (MediaBufferPtr buffer = network_.cachedMedia(reference.url)) {
+            result.media[reference.src] = buffer;
         }
     }
+    showPage(page, std::move(result));
+    // Scroll once the restored content has been laid out.
+    const int scroll_x = snapshot.scroll_x;
+    const int scroll_y = snapshot.scroll_y;
+    QTimer::singleShot(0, page, [page, scroll_x, scroll_y]() {
+        page->horizontalScrollBar()->setValue(scroll_x);
+        page->verticalScrollBar()->setValue(scroll_y);
+    });
+}
 
-    scroll_area->setWidget(content_widget);
-    scroll_area->setWidgetResizable(true);
+void BrowserWindow::replaceTab(int index, QWidget* widget, const QString& title) {
+    // Swapping a tab's widget emits currentChanged for its neighbours; the
+    // current tab has not really changed.
+    const QSignalBlocker blocker(tabs_);
+    const int current = tabs_->currentIndex();
+    tabs_->removeTab(index);
+    tabs_->insertTab(index, widget, title);
+    tabs_->setCurrentIndex(current);
+}
+
+DecodeGroupPtr BrowserWindow::startDecodes(QWidget* page) {
+    auto decodes = std::make_shared<DecodeGroup>();
+    decodes->setTimelineTab(timelineTabOf(page));
+    page_decodes_[page] = decodes;
+    // A page closed without being frozen, including with the window, cancels
+    // its decodes on destruction; the window's members may already be gone.
+    connect(page, &QObject::destroyed, [decodes]() { decodes->cancel(); });
+    return decodes;
+}
+
+void BrowserWindow::cancelDecodes(QWidget* page) {
+    DecodeGroupPtr decodes = page_decodes_.take(page);
+    if (decodes) decodes->cancel();
+}
+
+void BrowserWindow::startFetches(QWidget* page, PageView* view, const std::string& base_url) {
+    auto control = std::make_shared<TransferControl>();
+    page_fetches_[page] = control;
+    connect(page, &QObject::destroyed, [control]() { control->cancel(); });
+    const uint64_t tab = timelineTabOf(page);
+    view->setMediaFetcher([this, control, base_url, tab](const std::vector<std::string>& sources,
+                                                         PageView::MediaDone done) {
+        load_pool_.start(new LazyImageTask(network_, sources, base_url, control, std::move(done), tab));
+    }, lazy_image_margin_);
+}
 
-    int index = tabs_->addTab(scroll_area, QString::fromStdString(url));
-    frozen_tabs_[index] = QString::fromStdString(url);
+void BrowserWindow::cancelFetches(QWidget* page) {
+    std::shared_ptr<TransferControl> control = page_fetches_.take(page);
+    if (control) control->cancel();
+}
+
+size_t BrowserWindow::pageFootprint(QScrollArea* page) const {
+    size_t bytes = 0;
+    auto it = page_contents_.find(page);
+    if (it != page_contents_.end()) {
+        bytes += it->second.document.memoryBytes();
+        // Mapped media is page cache the kernel can reclaim; downloads are heap.
+        for (const auto& media : it->second.media) {
+            if (!media.second->isMapped()) bytes += media.second->size();
+        }
+    }
+    // Decoded pixmaps may be shared with the image cache and other tabs, but
+    // hibernating the tab is what lets the cache evict them.
+    if (auto* view = qobject_cast<PageView*>(page->widget())) bytes += view->memoryBytes();
+    return bytes + kWidgetBytes;
+}
+
+uint64_t BrowserWindow::timelineTabOf(QWidget* page) const {
+    // Tabs are identified by index, as in the lifecycle and snapshot store.
+    const int index = tabs_->indexOf(page);
+    return index >= 0 ? static_cast<uint64_t>(index) : kNoTimelineTab;
+}
+
+void BrowserWindow::toggleTimeline() {
+    if (!timelineEnabled()) {
+        clearTimeline();
+        setTimelineEnabled(true);
+        setWindowTitle("QuickDOM (recording timeline)");
+        return;
+    }
+    setTimelineEnabled(false);
+    writeTimeline(timeline_path_.toStdString());
+    setWindowTitle("QuickDOM");
 }
 
 void BrowserWindow::handleLinkClicked(QLabel* label) {
-    QString href = label->property("href").toString();
+    openLink(label->property("href").toString());
+}
+
+void BrowserWindow::openLink(const QString& href) {
     if (!href.isEmpty()) {
         url_bar_->setText(href);
         openNewTab();
@@ -117,79 +284,79 @@ void BrowserWindow::handleLinkClicked(QLabel* label) {
 }
 
 void BrowserWindow::onTabChanged(int index) {
-    if (tabs_->widget(index) == nullptr) {
+    if (index < 0) return;
+    // Live tabs are scroll areas; a frozen tab holds an empty placeholder.
+    if (!qobject_cast<QScrollArea*>(tabs_->widget(index))) {
         unfreezeTab(index);
     }
+    lifecycle_.touch(static_cast<uint64_t>(index));
+    // Other tabs stay live; thawing this one may have pushed them over budget.
+    enforceMemoryBudget();
+}
+
+void BrowserWindow::enforceMemoryBudget() {
+    // Images decode after a page is shown, so footprints are refreshed here.
     for (int i = 0; i < tabs_->count(); ++i) {
-        if (i != index && tabs_->widget(i) != nullptr) {
-            freezeTab(i);
+        if (auto* page = qobject_cast<QScrollArea*>(tabs_->widget(i))) {
+            lifecycle_.setFootprint(static_cast<uint64_t>(i), pageFootprint(page));
         }
     }
+    const MemoryStatus status = memory_monitor_.sample();
+    for (uint64_t tab : lifecycle_.selectVictims(status)) {
+        const int index = static_cast<int>(tab);
+        if (index == tabs_->currentIndex()) continue;
+        QUICKDOM_TRACE_INFO("Hibernating tab", index, ", live tabs use ", lifecycle_.liveBytes(), " bytes");
+        freezeTab(index);
+    }
 }
 
 void BrowserWindow::freezeTab(int index) {
     auto* scroll_area = qobject_cast<QScrollArea*>(tabs_->widget(index));
     if (!scroll_area) return;
+    lifecycle_.hibernated(static_cast<uint64_t>(index));
 
-    QString url = frozen_tabs_[index];
-    QFile file(QString("tab_%1.html").arg(index));
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << url;
-        file.close();
+    // Snapshot a loaded page; one still loading is simply loaded again.
+    auto it = page_contents_.find(scroll_area);
+    if (it != page_contents_.end()) {
+        TabSnapshot snapshot;
+        snapshot.url = it->second.url;
+        snapshot.document = std::move(it->second.document);
+        for (const auto& media : it->second.media) {
+            snapshot.media.push_back(MediaReference{media.first, media.second->source()});
+        }
+        snapshot.scroll_x = scroll_area->horizontalScrollBar()->value();
+        snapshot.scroll_y = scroll_area->verticalScrollBar()->value();
+        snapshots_.put(static_cast<uint64_t>(index), encodeSnapshot(snapshot));
+        page_contents_.erase(it);
     }
 
-    tabs_->removeTab(index);
-    tabs_->insertTab(index, new QWidget(), url);
+    // Pending fetches and decodes are of no use to a frozen page; the page itself goes too.
+    cancelFetches(scroll_area);
+    cancelDecodes(scroll_area);
+    replaceTab(index, new QWidget(), frozen_tabs_[index]);
+    scroll_area->deleteLater();
 }
 
 void BrowserWindow::unfreezeTab(int index) {
     QString url = frozen_tabs_[index];
-    std::string html = network_.fetch(url.toStdString());
-    Node root = parser_->parse(html);
-
-    // Load media
-    for (auto& child : root.children) {
-        if (child.type == "image") {
-            auto src_it = child.attributes.find("src");
-            if (src_it != child.attributes.end()) {
-                std::string media_path = network_.fetchMedia(src_it->second, url.toStdString());
-                if (!media_path.empty()) {
-                    child.attributes["src"] = media_path;
-                }
-            }
-        }
-    }
+    QWidget* frozen = tabs_->widget(index);
+    QScrollArea* page = createPage();
+    replaceTab(index, page, url);
+    if (frozen) frozen->deleteLater();
 
-    auto* scroll_area = new QScrollArea(this);
-    scroll_area->setStyleSheet("QScrollArea { background: black; }");
-    auto* content_widget = new QWidget();
-    content_widget->setStyleSheet("background: black;");
-    auto* content_layout = new QVBoxLayout(content_widget);
-    content_layout->setAlignment(Qt::AlignTop);
-    renderer_.render(root, content_layout);
-
-    // Connect link clicks
-    for (int i = 0; i < content_layout->count(); ++i) {
-        auto* item = content_layout->itemAt(i);
-        if (item && item->widget()) {
-            if (auto* label = qobject_cast<QLabel*>(item->widget())) {
-                if (label->property("isLink").toBool()) {
-                    auto* link_label = new LinkLabel(content_widget);
-                    link_label->setText(label->text());
-                    link_label->setStyleSheet(label->styleSheet());
-                    link_label->setProperty("href", label->property("href"));
-                    connect(link_label, &LinkLabel::clicked, this, &BrowserWindow::handleLinkClicked);
-                    content_layout->replaceWidget(label, link_label);
-                    label->deleteLater();
-                }
-            }
-        }
+    // Thaw from the snapshot without network or parse work when there is one.
+    std::string bytes;
+    TabSnapshot snapshot;
+    bool restored = false;
+    {
+        const std::string page_url = url.toStdString();
+        TimelineTabScope tab(static_cast<uint64_t>(index));
+        TimelineSpan span("restore", "load", page_url);
+        restored = snapshots_.take(static_cast<uint64_t>(index), &bytes) && decodeSnapshot(bytes, &snapshot);
+    }
+    if (restored) {
+        restorePage(page, std::move(snapshot));
+    } else {
+        loadPage(page, url);
     }
-
-    scroll_area->setWidget(content_widget);
-    scroll_area->setWidgetResizable(true);
-
-    tabs_->removeTab(index);
-    tabs_->insertTab(index, scroll_area, url);
 }
\ No newline at end of file
@@ -6,34 +6,96 @@
 #define BROWSER_WINDOW_H
 
 #include "html_parser.h"
+#include "parser_factory.h"
 #include "network.h"
+#include "page_load.h"
+#include "page_view.h"
 #include "renderer.h"
+#include "tab_lifecycle.h"
+#include "tab_snapshot.h"
 #include <QMainWindow>
 #include <QLineEdit>
 #include <QTabWidget>
 #include <QLabel> // Added for QLabel
 #include <QMap>
+#include <memory>
+#include <unordered_map>
+#include <QScrollArea>
+#include <QThreadPool>
 
 class BrowserWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit BrowserWindow(QWidget *parent = nullptr);
+    /**
+     * @brief Creates the main window.
+     * @param parent Parent widget.
+     * @param parser_kind Parser to use; Auto picks the fastest for this CPU.
+     */
+    explicit BrowserWindow(QWidget *parent = nullptr, ParserKind parser_kind = ParserKind::Auto);
+    ~BrowserWindow() override;
+
+    /**
+     * @brief Sets the memory the live tabs may use together before the least
+     * recently used are hibernated.
+     */
+    void setTabMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Sets how close to the visible area, in pixels, an image must come
+     * before it is fetched.
+     */
+    void setLazyImageMargin(int pixels) { lazy_image_margin_ = pixels; }
+
+    /**
+     * @brief Sets the file a timeline recording is written to when it stops.
+     */
+    void setTimelinePath(const QString& path) { timeline_path_ = path; }
+    const QString& timelinePath() const { return timeline_path_; }
+
+public slots:
+    /**
+     * @brief Starts a timeline recording, or stops the running one and writes
+     * it as Chrome trace-event JSON. Bound to Ctrl+Shift+E.
+     */
+    void toggleTimeline();
 
 private slots:
     void openNewTab();
     void onTabChanged(int index);
-    void handleLinkClicked(QLabel* label); // Handle link clicks
+    void handleLinkClicked(QLabel* label); // Test/compat shim: tabs report links via PageView::linkClicked
+    void openLink(const QString& href);
+    void enforceMemoryBudget();
 
 private:
     void freezeTab(int index);
     void unfreezeTab(int index);
+    QScrollArea* createPage();
+    void loadPage(QScrollArea* page, const QString& url);
+    void showPage(QScrollArea* page, PageLoadResult result);
+    void restorePage(QScrollArea* page, TabSnapshot snapshot);
+    void replaceTab(int index, QWidget* widget, const QString& title);
+    DecodeGroupPtr startDecodes(QWidget* page);
+    void cancelDecodes(QWidget* page);
+    void startFetches(QWidget* page, PageView* view, const std::string& base_url);
+    void cancelFetches(QWidget* page);
+    size_t pageFootprint(QScrollArea* page) const;
+    uint64_t timelineTabOf(QWidget* page) const;
 
     QLineEdit* url_bar_;
     QTabWidget* tabs_;
     QMap<int, QString> frozen_tabs_;
+    QMap<QWidget*, DecodeGroupPtr> page_decodes_; // image decodes of each rendered page
+    QMap<QWidget*, std::shared_ptr<TransferControl>> page_fetches_; // lazy image fetches of each page
+    std::unordered_map<QWidget*, PageLoadResult> page_contents_; // what each live page shows
+    SnapshotStore snapshots_; // frozen tabs by index
+    TabLifecycle lifecycle_; // footprint and recency of tabs by index
+    MemoryMonitor memory_monitor_;
+    int lazy_image_margin_ = PageView::kDefaultLazyMargin;
+    QString timeline_path_ = "quickdom-timeline.json";
     Network network_;
     Renderer renderer_;
     std::unique_ptr<HtmlParser> parser_;
+    QThreadPool load_pool_; // runs PageLoad pipelines so tabs load in parallel
 };
 
 #endif // BROWSER_WINDOW_H
\ No newline at end of file
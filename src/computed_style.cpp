@@ -0,0 +1,278 @@
+/**
+ * @file computed_style.cpp
+ * @brief Implements style parsing, interning and application to widgets.
+ */
+#include "computed_style.h"
+#include "hash_combine.h"
+#include "trace.h"
+#include <QPalette>
+#include <QString>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// What em and % resolve against while the font keeps the application's size.
+constexpr int kEmFallback = 14;
+// Lengths are clamped to this, so a page cannot ask for absurd fonts or gaps.
+constexpr int kMaxLength = 512;
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    return text;
+}
+
+std::string lower(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return result;
+}
+
+std::vector<std::string_view> words(std::string_view text) {
+    std::vector<std::string_view> result;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        const size_t start = pos;
+        while (pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        if (pos > start) result.push_back(text.substr(start, pos - start));
+    }
+    return result;
+}
+
+// Reads "12px", "9pt", "1.5em", "120%" or "0" in pixels; em and % relative to em.
+bool parseLength(std::string_view value, int em, int* pixels) {
+    const std::string text(value);
+    char* end = nullptr;
+    const double number = std::strtod(text.c_str(), &end);
+    if (end == text.c_str()) return false;
+    const std::string_view unit(end);
+    double result;
+    if (unit == "px" || (unit.empty() && number == 0)) {
+        result = number;
+    } else if (unit == "pt") {
+        result = number * 4 / 3;
+    } else if (unit == "em" || unit == "rem") {
+        result = number * em;
+    } else if (unit == "%") {
+        result = number * em / 100;
+    } else {
+        return false;
+    }
+    *pixels = static_cast<int>(std::clamp(result + 0.5, 0.0, static_cast<double>(kMaxLength)));
+    return true;
+}
+
+// Reads a color name, #rgb, #rrggbb, rgb() or rgba() as ARGB.
+bool parseColor(std::string_view value, uint32_t* argb) {
+    if (value == "transparent") {
+        *argb = 0;
+        return true;
+    }
+    const bool rgba = value.substr(0, 5) == "rgba(";
+    if (rgba || value.substr(0, 4) == "rgb(") {
+        if (value.back() != ')') return false;
+        std::string arguments(value.substr(rgba ? 5 : 4));
+        arguments.pop_back();
+        std::replace(arguments.begin(), arguments.end(), ',', ' ');
+        const std::vector<std::string_view> parts = words(arguments);
+        if (parts.size() != (rgba ? 4u : 3u)) return false;
+        double channels[4] = {0, 0, 0, 1};
+        for (size_t i = 0; i < parts.size(); ++i) {
+            const std::string part(parts[i]);
+            char* end = nullptr;
+            channels[i] = std::strtod(part.c_str(), &end);
+            if (end == part.c_str() || *end != '\0') return false;
+        }
+        auto channel = [](double number, double scale) {
+            return static_cast<uint32_t>(std::clamp(number * scale + 0.5, 0.0, 255.0));
+        };
+        *argb = channel(channels[3], 255) << 24 | channel(channels[0], 1) << 16 | channel(channels[1], 1) << 8 |
+                channel(channels[2], 1);
+        return true;
+    }
+    const QColor color(QString::fromUtf8(value.data(), static_cast<int>(value.size())));
+    if (!color.isValid()) return false;
+    *argb = color.rgba();
+    return true;
+}
+
+// Applies one declaration; property and value are trimmed and lower case.
+void applyDeclaration(StyleValues& values, const std::string& property, const std::string& value) {
+    const int em = values.pixel_size > 0 ? values.pixel_size : kEmFallback;
+    if (property == "color") {
+        parseColor(value, &values.color);
+    } else if (property == "background" || property == "background-color") {
+        if (value == "none") {
+            values.background = 0;
+        } else {
+            parseColor(value, &values.background);
+        }
+    } else if (property == "font-size") {
+        int pixels;
+        if (parseLength(value, em, &pixels) && pixels > 0) values.pixel_size = pixels;
+    } else if (property == "font-weight") {
+        if (value == "bold" || value == "bolder") {
+            values.bold = true;
+        } else if (value == "normal" || value == "lighter") {
+            values.bold = false;
+        } else {
+            const int weight = std::atoi(value.c_str());
+            if (weight > 0) values.bold = weight >= 600;
+        }
+    } else if (property == "font-style") {
+        values.italic = value == "italic" || value == "oblique";
+    } else if (property == "text-decoration" || property == "text-decoration-line") {
+        values.underline = value.find("underline") != std::string::npos;
+        values.strike_out = value.find("line-through") != std::string::npos;
+    } else if (property == "padding") {
+        const std::vector<std::string_view> parts = words(value);
+        int pixels;
+        if (!parts.empty() && parseLength(parts[0], em, &pixels)) values.padding = pixels;
+    } else if (property == "margin" || property == "margin-bottom") {
+        // margin: all | vertical horizontal | top horizontal bottom | top right bottom left
+        const std::vector<std::string_view> parts = words(value);
+        const size_t bottom = property == "margin" && parts.size() >= 3 ? 2 : 0;
+        int pixels;
+        if (bottom < parts.size() && parseLength(parts[bottom], em, &pixels)) values.spacing = pixels;
+    }
+}
+
+} // namespace
+
+bool StyleValues::operator==(const StyleValues& other) const {
+    return pixel_size == other.pixel_size && bold == other.bold && italic == other.italic &&
+           underline == other.underline && strike_out == other.strike_out && color == other.color &&
+           background == other.background && padding == other.padding && spacing == other.spacing;
+}
+
+ComputedStyle::ComputedStyle(const StyleValues& values) : values_(values) {
+    if (values.pixel_size > 0) font_.setPixelSize(values.pixel_size);
+    font_.setBold(values.bold);
+    font_.setItalic(values.italic);
+    font_.setUnderline(values.underline);
+    font_.setStrikeOut(values.strike_out);
+    color_ = QColor::fromRgba(values.color);
+    if (hasBackground()) background_ = QColor::fromRgba(values.background);
+}
+
+void ComputedStyle::apply(QWidget* widget) const {
+    widget->setFont(font_);
+    QPalette palette = widget->palette();
+    palette.setColor(QPalette::WindowText, color_);
+    if (hasBackground()) palette.setColor(QPalette::Window, background_);
+    widget->setPalette(palette);
+    widget->setAutoFillBackground(hasBackground());
+    widget->setContentsMargins(values_.padding, values_.padding, values_.padding, values_.padding);
+}
+
+void ComputedStyle::clear(QWidget* widget) {
+    // Default-constructed fonts and palettes set nothing, so the parent's apply.
+    widget->setFont(QFont());
+    widget->setPalette(QPalette());
+    widget->setAutoFillBackground(false);
+    widget->setContentsMargins(0, 0, 0, 0);
+}
+
+size_t StyleTable::ValuesHash::operator()(const StyleValues& values) const {
+    size_t hash = std::hash<uint32_t>()(values.color);
+    hashCombine(hash, values.background);
+    hashCombine(hash, static_cast<size_t>(values.pixel_size));
+    hashCombine(hash, static_cast<size_t>(values.padding));
+    hashCombine(hash, static_cast<size_t>(values.spacing));
+    hashCombine(hash, static_cast<size_t>(values.bold) | static_cast<size_t>(values.italic) << 1 |
+                          static_cast<size_t>(values.underline) << 2 | static_cast<size_t>(values.strike_out) << 3);
+    return hash;
+}
+
+StyleTable& StyleTable::instance() {
+    static StyleTable table;
+    return table;
+}
+
+StyleTable::StyleTable() {
+    for (size_t role = 0; role < static_cast<size_t>(TextStyle::Count); ++role) {
+        defaults_[role] = intern(defaultValues(static_cast<TextStyle>(role)));
+    }
+}
+
+StyleValues StyleTable::defaultValues(TextStyle role) {
+    StyleValues values;
+    switch (role) {
+    case TextStyle::Body:
+        values.pixel_size = 14;
+        break;
+    case TextStyle::Header:
+        values.pixel_size = 18;
+        values.bold = true;
+        break;
+    case TextStyle::Link:
+        values.underline = true;
+        values.color = 0xff00008bu; // dark blue
+        break;
+    case TextStyle::Notice:
+        values.background = QColor(Qt::gray).rgba();
+        values.padding = 5;
+        break;
+    case TextStyle::Count:
+        break;
+    }
+    return values;
+}
+
+StyleValues StyleTable::parse(StyleValues base, std::string_view declarations) {
+    while (!declarations.empty()) {
+        const size_t end = std::min(declarations.find(';'), declarations.size());
+        const std::string_view declaration = declarations.substr(0, end);
+        declarations.remove_prefix(std::min(end + 1, declarations.size()));
+        const size_t colon = declaration.find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string value = lower(trim(declaration.substr(colon + 1)));
+        // !important changes nothing when there is nothing to override.
+        const size_t important = value.find("!important");
+        if (important != std::string::npos) value = std::string(trim(std::string_view(value).substr(0, important)));
+        if (value.empty()) continue;
+        applyDeclaration(base, lower(trim(declaration.substr(0, colon))), value);
+    }
+    return base;
+}
+
+const ComputedStyle* StyleTable::intern(const StyleValues& values) {
+    auto it = by_values_.find(values);
+    if (it != by_values_.end()) return it->second.get();
+    if (by_values_.size() >= kMaxStyles) return nullptr;
+    std::unique_ptr<ComputedStyle> style(new ComputedStyle(values));
+    const ComputedStyle* result = style.get();
+    by_values_.emplace(values, std::move(style));
+    return result;
+}
+
+const ComputedStyle* StyleTable::resolve(TextStyle role, std::string_view inline_style) {
+    if (inline_style.empty()) return defaultStyle(role);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Reused per thread, so a lookup allocates only for the longest style yet.
+    thread_local std::string key;
+    key.assign(1, static_cast<char>(role));
+    key.append(inline_style.data(), inline_style.size());
+    auto it = by_text_.find(key);
+    if (it != by_text_.end()) return it->second;
+
+    const ComputedStyle* style = intern(parse(defaultValues(role), inline_style));
+    if (!style) {
+        QUICKDOM_TRACE_WARN("Too many distinct styles", "using the default for ", key.substr(1));
+        style = defaultStyle(role);
+    }
+    // Records stay; only the text cache restarts, so its size is bounded.
+    if (by_text_.size() >= kMaxStyleTexts) by_text_.clear();
+    by_text_.emplace(key, style);
+    return style;
+}
+
+size_t StyleTable::styleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return by_values_.size();
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+/**
+ * @file computed_style.h
+ * @brief Defines interned computed styles and the table that resolves elements to them.
+ */
+#ifndef COMPUTED_STYLE_H
+#define COMPUTED_STYLE_H
+
+#include <QColor>
+#include <QFont>
+#include <QWidget>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief The role of a text block, which picks its default style.
+ */
+enum class TextStyle : uint8_t {
+    Body,   // paragraphs and plain text
+    Header, // h1-h6
+    Link,   // a, clickable
+    Notice, // "Image not loaded" and similar boxes
+    Count
+};
+
+/**
+ * @brief The properties a style sets, fully resolved.
+ */
+struct StyleValues {
+    static constexpr int kDefaultSpacing = 6; // pixels below a block
+
+    int pixel_size = 0; // font size; 0 keeps the application font's
+    bool bold = false;
+    bool italic = false;
+    bool underline = false;
+    bool strike_out = false;
+    uint32_t color = 0xffffffffu; // ARGB
+    uint32_t background = 0;      // ARGB; fully transparent paints nothing
+    int padding = 0;
+    int spacing = kDefaultSpacing;
+
+    bool operator==(const StyleValues& other) const;
+    bool operator!=(const StyleValues& other) const { return !(*this == other); }
+};
+
+/**
+ * @class ComputedStyle
+ * @brief An immutable style record shared by every element that resolves to it.
+ *
+ * Records are created by StyleTable only and live as long as the process,
+ * so items and widgets hold plain pointers to them. The QFont and colors
+ * are built once per record, not per element.
+ */
+class ComputedStyle {
+public:
+    const StyleValues& values() const { return values_; }
+    const QFont& font() const { return font_; }
+    const QColor& color() const { return color_; }
+    const QColor& background() const { return background_; }
+    bool hasBackground() const { return (values_.background >> 24) != 0; }
+    int padding() const { return values_.padding; }
+    int spacing() const { return values_.spacing; }
+
+    /**
+     * @brief Shows a widget in this style through its font, palette and margins.
+     *
+     * Unlike a style sheet, nothing is parsed and the widget keeps the
+     * application style.
+     */
+    void apply(QWidget* widget) const;
+
+    /**
+     * @brief Undoes apply(); the widget inherits font and palette again.
+     */
+    static void clear(QWidget* widget);
+
+private:
+    friend class StyleTable;
+
+    explicit ComputedStyle(const StyleValues& values);
+
+    StyleValues values_;
+    QFont font_;
+    QColor color_;
+    QColor background_;
+};
+
+/**
+ * @class StyleTable
+ * @brief Interns computed styles and resolves elements to them.
+ *
+ * An element's style is its role's default plus its inline style attribute.
+ * Elements without one take the default from an array. Otherwise the pair is
+ * looked up in a hash table, and only the first element with a given style
+ * text parses it; elements whose styles differ in text but not in effect
+ * share a record too. Safe to use from any thread.
+ */
+class StyleTable {
+public:
+    /**
+     * @brief Returns the process-wide table.
+     */
+    static StyleTable& instance();
+
+    StyleTable();
+    StyleTable(const StyleTable&) = delete;
+    StyleTable& operator=(const StyleTable&) = delete;
+
+    /**
+     * @brief Returns the style of a role without inline style.
+     */
+    const ComputedStyle* defaultStyle(TextStyle role) const { return defaults_[static_cast<size_t>(role)]; }
+
+    /**
+     * @brief Returns the style of an element.
+     * @param role What the element renders as.
+     * @param inline_style Value of its style attribute, possibly empty.
+     */
+    const ComputedStyle* resolve(TextStyle role, std::string_view inline_style);
+
+    /**
+     * @brief Applies CSS declarations ("color: red; font-size: 20px") to values.
+     *
+     * Knows color, background(-color), font-size (px, pt, em), font-weight,
+     * font-style, text-decoration, padding and margin(-bottom); anything else
+     * is ignored, as are values it cannot read.
+     */
+    static StyleValues parse(StyleValues base, std::string_view declarations);
+
+    /**
+     * @brief Returns the default values of a role.
+     */
+    static StyleValues defaultValues(TextStyle role);
+
+    /**
+     * @brief Returns how many distinct records exist.
+     */
+    size_t styleCount() const;
+
+    static constexpr size_t kMaxStyleTexts = 4096; // cached style attributes before the cache restarts
+    static constexpr size_t kMaxStyles = 65536;    // records before new styles fall back to defaults
+
+private:
+    struct ValuesHash {
+        size_t operator()(const StyleValues& values) const;
+    };
+
+    const ComputedStyle* intern(const StyleValues& values);
+
+    mutable std::mutex mutex_;
+    // Role byte followed by the style attribute.
+    std::unordered_map<std::string, const ComputedStyle*> by_text_;
+    std::unordered_map<StyleValues, std::unique_ptr<ComputedStyle>, ValuesHash> by_values_;
+    const ComputedStyle* defaults_[static_cast<size_t>(TextStyle::Count)];
+};
+
+#endif // COMPUTED_STYLE_H
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * @file cpu_features.cpp
+ * @brief Implements CPUID/HWCAP based feature detection.
+ */
+#include "cpu_features.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QUICKDOM_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__)
+#define QUICKDOM_ARM 1
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(QUICKDOM_X86)
+// Fills regs with EAX, EBX, ECX, EDX for the given leaf/subleaf.
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(out[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures features;
+#if defined(QUICKDOM_X86)
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    const unsigned max_leaf = regs[0];
+    if (max_leaf < 1) return features;
+
+    cpuid(1, 0, regs);
+    features.sse2 = (regs[3] >> 26) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+    if (!osxsave || !avx || max_leaf < 7) return features;
+
+    // The OS must save YMM (bits 1-2) and, for AVX-512, opmask/ZMM state (bits 5-7).
+    const uint64_t xcr0 = xgetbv0();
+    const bool os_avx = (xcr0 & 0x6) == 0x6;
+    const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, regs);
+    features.avx2 = os_avx && ((regs[1] >> 5) & 1);
+    features.avx512bw = os_avx512 && ((regs[1] >> 16) & 1) && ((regs[1] >> 30) & 1);
+#elif defined(QUICKDOM_ARM)
+#if defined(__aarch64__) || defined(_M_ARM64)
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+    features.neon = (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+    features.neon = true; // Advanced SIMD is mandatory on AArch64
+#endif
+#elif defined(__linux__) && defined(HWCAP_NEON)
+    features.neon = (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+#endif
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
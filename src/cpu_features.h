@@ -0,0 +1,29 @@
+/**
+ * @file cpu_features.h
+ * @brief Runtime detection of the vector instruction sets the parsers use.
+ */
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/**
+ * @brief Instruction-set extensions available on the running CPU.
+ *
+ * Each flag is set only when both the CPU and the operating system support
+ * the extension (e.g. AVX state must be enabled in XCR0).
+ */
+struct CpuFeatures {
+    bool sse2 = false;     // x86 SSE2
+    bool avx2 = false;     // x86 AVX2
+    bool avx512bw = false; // x86 AVX-512 Foundation + Byte/Word
+    bool neon = false;     // ARM Advanced SIMD
+};
+
+/**
+ * @brief Returns the features of the running CPU.
+ *
+ * Detection runs once (CPUID/XGETBV on x86, HWCAP on ARM Linux); later calls
+ * return the cached result.
+ */
+const CpuFeatures& cpuFeatures();
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,144 @@
+/**
+ * @file display_list.cpp
+ * @brief Implements display list layout, queries and painting.
+ */
+#include "display_list.h"
+#include <QColor>
+#include <QFontMetrics>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// Height text may wrap into; far beyond any real block.
+constexpr int kUnboundedHeight = 1 << 24;
+
+} // namespace
+
+void DisplayList::addText(TextStyle style, QString text, QString href, const ComputedStyle* computed) {
+    DisplayItem item;
+    item.kind = DisplayItem::Kind::Text;
+    item.style = style;
+    item.computed = computed ? computed : StyleTable::instance().defaultStyle(style);
+    item.text = std::move(text);
+    item.href = std::move(href);
+    items_.push_back(std::move(item));
+    layout_width_ = -1;
+}
+
+size_t DisplayList::addImage(const QSize& size, QPixmap pixmap) {
+    DisplayItem item;
+    item.kind = DisplayItem::Kind::Image;
+    item.size = size;
+    item.pixmap = std::move(pixmap);
+    items_.push_back(std::move(item));
+    layout_width_ = -1;
+    return items_.size() - 1;
+}
+
+void DisplayList::setPixmap(size_t index, const QPixmap& pixmap) {
+    items_[index].pixmap = pixmap;
+}
+
+void DisplayList::setImageSize(size_t index, const QSize& size) {
+    if (items_[index].size == size) return;
+    items_[index].size = size;
+    layout_width_ = -1;
+}
+
+void DisplayList::setText(size_t index, TextStyle style, QString text) {
+    DisplayItem& item = items_[index];
+    item.kind = DisplayItem::Kind::Text;
+    item.style = style;
+    item.computed = StyleTable::instance().defaultStyle(style);
+    item.text = std::move(text);
+    item.pixmap = QPixmap();
+    layout_width_ = -1;
+}
+
+int DisplayList::layout(int width) {
+    if (width == layout_width_) return height_;
+    layout_width_ = width;
+    const int available = std::max(1, width - 2 * kMargin);
+    // Pages use a handful of styles, each shared by many items.
+    std::unordered_map<const ComputedStyle*, QFontMetrics> metrics;
+
+    int y = kMargin;
+    int spacing = 0;
+    for (DisplayItem& item : items_) {
+        QSize size = item.size;
+        spacing = kSpacing;
+        if (item.kind == DisplayItem::Kind::Text) {
+            const ComputedStyle& style = *item.computed;
+            auto it = metrics.find(&style);
+            if (it == metrics.end()) it = metrics.emplace(&style, QFontMetrics(style.font())).first;
+            const int padding = style.padding();
+            const QRect bounds = it->second.boundingRect(
+                QRect(0, 0, std::max(1, available - 2 * padding), kUnboundedHeight), Qt::TextWordWrap, item.text);
+            size = QSize(bounds.width() + 2 * padding, bounds.height() + 2 * padding);
+            spacing = style.spacing();
+        }
+        item.rect = QRect(kMargin, y, size.width(), size.height());
+        y += size.height() + spacing;
+    }
+    height_ = items_.empty() ? 2 * kMargin : y - spacing + kMargin;
+    return height_;
+}
+
+std::pair<size_t, size_t> DisplayList::itemsIn(int top, int bottom) const {
+    // Items never overlap vertically, so both edges are sorted.
+    auto first = std::partition_point(items_.begin(), items_.end(),
+                                      [top](const DisplayItem& item) { return item.rect.bottom() < top; });
+    auto last = std::partition_point(first, items_.end(),
+                                     [bottom](const DisplayItem& item) { return item.rect.top() < bottom; });
+    return {static_cast<size_t>(first - items_.begin()), static_cast<size_t>(last - items_.begin())};
+}
+
+std::pair<size_t, size_t> DisplayList::lazyImagesIn(int top, int bottom) const {
+    const auto items = itemsIn(top, bottom);
+    auto first = std::partition_point(lazy_.begin(), lazy_.end(),
+                                      [&items](const LazyImage& lazy) { return lazy.item < items.first; });
+    auto last = std::partition_point(first, lazy_.end(),
+                                     [&items](const LazyImage& lazy) { return lazy.item < items.second; });
+    return {static_cast<size_t>(first - lazy_.begin()), static_cast<size_t>(last - lazy_.begin())};
+}
+
+const DisplayItem* DisplayList::linkAt(const QPoint& point) const {
+    const auto range = itemsIn(point.y(), point.y() + 1);
+    for (size_t i = range.first; i < range.second; ++i) {
+        const DisplayItem& item = items_[i];
+        if (item.style == TextStyle::Link && item.rect.contains(point)) return &item;
+    }
+    return nullptr;
+}
+
+void DisplayList::paint(QPainter& painter, const QRect& clip) const {
+    const auto range = itemsIn(clip.top(), clip.bottom() + 1);
+    for (size_t i = range.first; i < range.second; ++i) {
+        const DisplayItem& item = items_[i];
+        if (item.kind == DisplayItem::Kind::Image) {
+            if (item.pixmap.isNull()) {
+                painter.fillRect(item.rect, Qt::gray);
+            } else {
+                painter.drawPixmap(item.rect.topLeft(), item.pixmap);
+            }
+            continue;
+        }
+        const ComputedStyle& style = *item.computed;
+        if (style.hasBackground()) painter.fillRect(item.rect, style.background());
+        const int padding = style.padding();
+        painter.setFont(style.font());
+        painter.setPen(style.color());
+        painter.drawText(item.rect.adjusted(padding, padding, -padding, -padding), Qt::TextWordWrap, item.text);
+    }
+}
+
+size_t DisplayList::memoryBytes() const {
+    size_t bytes = items_.capacity() * sizeof(DisplayItem) + pending_.capacity() * sizeof(PendingImage) +
+                   lazy_.capacity() * sizeof(LazyImage);
+    for (const DisplayItem& item : items_) {
+        bytes += static_cast<size_t>(item.text.capacity() + item.href.capacity()) * sizeof(QChar);
+        if (!item.pixmap.isNull()) bytes += ImageCache::costOf(item.pixmap);
+    }
+    return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+/**
+ * @file display_list.h
+ * @brief Defines the flat display list a page is painted from.
+ */
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include "computed_style.h"
+#include "image_cache.h"
+#include "image_decoder.h"
+#include <QPainter>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One thing to paint: a wrapped text block or an image.
+ */
+struct DisplayItem {
+    enum class Kind : uint8_t { Text, Image };
+
+    Kind kind = Kind::Text;
+    TextStyle style = TextStyle::Body;     // text items: links are hit-tested
+    const ComputedStyle* computed = nullptr; // text items: font, colors and box; never null
+    QRect rect;      // in page coordinates; set by DisplayList::layout()
+    QString text;    // text items
+    QString href;    // links only
+    QSize size;      // images: display size, fixed before the pixels arrive
+    QPixmap pixmap;  // images: null while decoding, painted as a placeholder
+};
+
+/**
+ * @brief An image whose pixels are still to be decoded.
+ */
+struct PendingImage {
+    size_t item;           // index of its DisplayItem
+    ImageKey key;          // where the decoded pixmap is cached
+    DecodeRequest request; // what to decode, already sized for display
+};
+
+/**
+ * @brief An image whose bytes are fetched only once it nears the viewport.
+ */
+struct LazyImage {
+    size_t item;        // index of its placeholder DisplayItem
+    std::string src;    // as written in the page
+    std::string width;  // width attribute, possibly empty
+    std::string height; // height attribute, possibly empty
+};
+
+/**
+ * @class DisplayList
+ * @brief The items of a page in document order, laid out top to bottom.
+ *
+ * Items stack vertically, so their rectangles are sorted by top edge and the
+ * items in a band of the page, or under a point, are found by binary search.
+ * Painting a viewport therefore costs the same on a page of ten items as on
+ * one of ten thousand.
+ */
+class DisplayList {
+public:
+    /**
+     * @brief Appends a text block.
+     * @param href Target of a link item; empty otherwise.
+     * @param computed How it looks; nullptr for the default of its style.
+     */
+    void addText(TextStyle style, QString text, QString href = QString(), const ComputedStyle* computed = nullptr);
+
+    /**
+     * @brief Appends an image of a fixed display size.
+     * @param pixmap Decoded pixmap, or null to paint a placeholder until setPixmap().
+     * @return Index of the item.
+     */
+    size_t addImage(const QSize& size, QPixmap pixmap = QPixmap());
+
+    /**
+     * @brief Records a decode to run for an image item.
+     */
+    void addPendingImage(PendingImage pending) { pending_.push_back(std::move(pending)); }
+
+    /**
+     * @brief Records an image to fetch when it nears the viewport.
+     */
+    void addLazyImage(LazyImage lazy) { lazy_.push_back(std::move(lazy)); }
+
+    /**
+     * @brief Fills in an image once decoded; its size and the layout stay the same.
+     */
+    void setPixmap(size_t index, const QPixmap& pixmap);
+
+    /**
+     * @brief Resizes an image item; the next layout() moves the items below it.
+     */
+    void setImageSize(size_t index, const QSize& size);
+
+    /**
+     * @brief Turns an item into a text block, e.g. a notice for an image that failed.
+     */
+    void setText(size_t index, TextStyle style, QString text);
+
+    /**
+     * @brief Positions the items for a page width; text wraps to fit.
+     * @return The page height.
+     */
+    int layout(int width);
+
+    /**
+     * @brief Returns the width of the last layout, or -1 before the first.
+     */
+    int layoutWidth() const { return layout_width_; }
+    int height() const { return height_; }
+
+    size_t size() const { return items_.size(); }
+    const DisplayItem& item(size_t index) const { return items_[index]; }
+
+    /**
+     * @brief Returns the index range [first, last) of items overlapping a band.
+     */
+    std::pair<size_t, size_t> itemsIn(int top, int bottom) const;
+
+    /**
+     * @brief Returns the link item under a point, or nullptr.
+     */
+    const DisplayItem* linkAt(const QPoint& point) const;
+
+    /**
+     * @brief Paints the items overlapping a rectangle of the page.
+     */
+    void paint(QPainter& painter, const QRect& clip) const;
+
+    /**
+     * @brief Returns the images still to be decoded.
+     */
+    const std::vector<PendingImage>& pendingImages() const { return pending_; }
+
+    /**
+     * @brief Returns the images to fetch on demand, in document order.
+     */
+    const std::vector<LazyImage>& lazyImages() const { return lazy_; }
+
+    /**
+     * @brief Returns the index range [first, last) of lazyImages() whose
+     *        placeholders overlap a band of the page.
+     */
+    std::pair<size_t, size_t> lazyImagesIn(int top, int bottom) const;
+
+    /**
+     * @brief Returns the approximate bytes held, decoded pixmaps included.
+     */
+    size_t memoryBytes() const;
+
+    static constexpr int kMargin = 9;  // around the page
+    static constexpr int kSpacing = StyleValues::kDefaultSpacing; // below images
+
+private:
+    std::vector<DisplayItem> items_;
+    std::vector<PendingImage> pending_;
+    std::vector<LazyImage> lazy_;
+    int layout_width_ = -1;
+    int height_ = 0;
+};
+
+#endif // DISPLAY_LIST_H
\ No newline at end of file
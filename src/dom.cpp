@@ -0,0 +1,280 @@
+/**
+ * @file dom.cpp
+ * @brief Implements the arena-backed document.
+ */
+#include "dom.h"
+#include "html_parser.h"
+#include "text_normalizer.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace {
+
+// Ranges with this bit set refer to the side buffer instead of the source.
+constexpr uint32_t kSideBit = 0x80000000u;
+
+constexpr size_t kMinArenaBytes = 4096;
+
+struct NodeTypeName {
+    TagAtom tag;
+    const char* name;
+};
+
+// Names the parsers have always used for Node::type.
+const NodeTypeName kNodeTypeNames[] = {
+    {TagAtom::Unknown, "unknown"},
+    {TagAtom::Root, "root"},
+    {TagAtom::Text, "text"},
+    {TagAtom::P, "p"},
+    {TagAtom::Img, "image"},
+    {TagAtom::A, "link"},
+    {TagAtom::H1, "header"},
+    {TagAtom::H2, "header"},
+    {TagAtom::Div, "div"},
+    {TagAtom::Span, "span"},
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != b[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const char* nodeTypeName(TagAtom tag) {
+    for (const auto& entry : kNodeTypeNames) {
+        if (entry.tag == tag) return entry.name;
+    }
+    return tagName(tag).data();
+}
+
+TagAtom tagFromNodeType(std::string_view type) {
+    for (const auto& entry : kNodeTypeNames) {
+        if (type == entry.name) return entry.tag;
+    }
+    return TagAtom::Unknown;
+}
+
+DomArena::DomArena(size_t initial_bytes) {
+    if (initial_bytes > 0) {
+        capacity_ = (initial_bytes + 7) & ~size_t(7);
+        block_.reset(new unsigned char[capacity_]);
+    }
+}
+
+DomArena::DomArena(DomArena&& other) noexcept
+    : block_(std::move(other.block_)),
+      capacity_(other.capacity_),
+      node_count_(other.node_count_),
+      attribute_count_(other.attribute_count_) {
+    other.capacity_ = 0;
+    other.node_count_ = 0;
+    other.attribute_count_ = 0;
+}
+
+DomArena& DomArena::operator=(DomArena&& other) noexcept {
+    if (this != &other) {
+        block_ = std::move(other.block_);
+        capacity_ = other.capacity_;
+        node_count_ = other.node_count_;
+        attribute_count_ = other.attribute_count_;
+        other.capacity_ = 0;
+        other.node_count_ = 0;
+        other.attribute_count_ = 0;
+    }
+    return *this;
+}
+
+size_t DomArena::usedBytes() const {
+    return node_count_ * sizeof(DomNode) + attribute_count_ * sizeof(DomAttribute);
+}
+
+void DomArena::grow() {
+    const size_t new_capacity = std::max(kMinArenaBytes, capacity_ * 2);
+    std::unique_ptr<unsigned char[]> block(new unsigned char[new_capacity]);
+    const size_t node_bytes = node_count_ * sizeof(DomNode);
+    const size_t attribute_bytes = attribute_count_ * sizeof(DomAttribute);
+    if (node_bytes) std::memcpy(block.get(), block_.get(), node_bytes);
+    if (attribute_bytes) {
+        std::memcpy(block.get() + new_capacity - attribute_bytes,
+                    block_.get() + capacity_ - attribute_bytes, attribute_bytes);
+    }
+    block_ = std::move(block);
+    capacity_ = new_capacity;
+}
+
+NodeId DomArena::addNode() {
+    if (usedBytes() + sizeof(DomNode) > capacity_) grow();
+    new (nodes() + node_count_) DomNode();
+    return static_cast<NodeId>(node_count_++);
+}
+
+uint32_t DomArena::addAttribute() {
+    if (usedBytes() + sizeof(DomAttribute) > capacity_) grow();
+    const uint32_t index = static_cast<uint32_t>(attribute_count_++);
+    new (&attribute(index)) DomAttribute();
+    return index;
+}
+
+Document::Document() : arena_(kMinArenaBytes) {
+    arena_.node(arena_.addNode()).tag = TagAtom::Root;
+}
+
+Document::Document(std::string source)
+    // Typical markup yields one node per few dozen bytes; size the block so
+    // most pages never need to grow it.
+    : source_(std::move(source)), arena_(std::max(kMinArenaBytes, source_.size() / 4)) {
+    arena_.node(arena_.addNode()).tag = TagAtom::Root;
+}
+
+std::string_view Document::view(TextRange range) const {
+    if (range.offset & kSideBit) {
+        return std::string_view(side_.data() + (range.offset & ~kSideBit), range.length);
+    }
+    return std::string_view(source_.data() + range.offset, range.length);
+}
+
+TextRange Document::store(std::string_view value) {
+    TextRange range;
+    range.offset = static_cast<uint32_t>(side_.size()) | kSideBit;
+    range.length = static_cast<uint32_t>(value.size());
+    side_.append(value.data(), value.size());
+    return range;
+}
+
+std::string_view Document::attributeName(NodeId id, size_t index) const {
+    const DomNode& n = arena_.node(id);
+    return view(arena_.attribute(n.first_attribute + static_cast<uint32_t>(index)).name);
+}
+
+std::string_view Document::attributeValue(NodeId id, size_t index) const {
+    const DomNode& n = arena_.node(id);
+    return view(arena_.attribute(n.first_attribute + static_cast<uint32_t>(index)).value);
+}
+
+bool Document::findAttribute(NodeId id, std::string_view name, std::string_view& value) const {
+    const DomNode& n = arena_.node(id);
+    for (uint32_t i = n.attribute_count; i-- > 0;) {
+        const DomAttribute& attr = arena_.attribute(n.first_attribute + i);
+        if (equalsIgnoreCase(view(attr.name), name)) {
+            value = view(attr.value);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view Document::attribute(NodeId id, std::string_view name) const {
+    std::string_view value;
+    findAttribute(id, name, value);
+    return value;
+}
+
+NodeId Document::appendChild(NodeId parent, TagAtom tag) {
+    const NodeId id = arena_.addNode();
+    arena_.node(id).tag = tag;
+    DomNode& p = arena_.node(parent);
+    if (p.last_child == kNoNode) {
+        p.first_child = id;
+    } else {
+        arena_.node(p.last_child).next_sibling = id;
+    }
+    p.last_child = id;
+    return id;
+}
+
+void Document::setText(NodeId id, size_t offset, size_t length) {
+    arena_.node(id).text = TextRange{static_cast<uint32_t>(offset), static_cast<uint32_t>(length)};
+}
+
+void Document::setNormalizedText(NodeId id, size_t offset, size_t length) {
+    const size_t side_offset = side_.size();
+    if (normalizeText(std::string_view(source_.data() + offset, length), &side_)) {
+        setText(id, offset, length);
+        return;
+    }
+    arena_.node(id).text = TextRange{static_cast<uint32_t>(side_offset) | kSideBit,
+                                     static_cast<uint32_t>(side_.size() - side_offset)};
+}
+
+void Document::addAttribute(NodeId id, TextRange name, TextRange value) {
+    const uint32_t index = arena_.addAttribute();
+    DomAttribute& attr = arena_.attribute(index);
+    attr.name = name;
+    attr.value = value;
+    DomNode& n = arena_.node(id);
+    if (n.attribute_count == 0) n.first_attribute = index;
+    ++n.attribute_count;
+}
+
+bool Document::replaceAttribute(NodeId id, std::string_view name, std::string_view value) {
+    const DomNode& n = arena_.node(id);
+    for (uint32_t i = n.attribute_count; i-- > 0;) {
+        DomAttribute& attr = arena_.attribute(n.first_attribute + i);
+        if (equalsIgnoreCase(view(attr.name), name)) {
+            attr.value = store(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+Node Document::toNode() const {
+    Node result;
+    result.type = nodeTypeName(node(root()).tag);
+    result.text = std::string(text(root()));
+    // Iterative pre-order walk keeps deep documents off the call stack.
+    struct Frame {
+        NodeId id;
+        Node* out;
+    };
+    std::vector<Frame> stack{{root(), &result}};
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+        const DomNode& n = node(frame.id);
+        size_t count = 0;
+        for (NodeId child = n.first_child; child != kNoNode; child = node(child).next_sibling) ++count;
+        frame.out->children.resize(count);
+        size_t i = 0;
+        for (NodeId child = n.first_child; child != kNoNode; child = node(child).next_sibling, ++i) {
+            Node& out = frame.out->children[i];
+            out.type = nodeTypeName(node(child).tag);
+            out.text = std::string(text(child));
+            for (size_t a = 0; a < attributeCount(child); ++a) {
+                std::string name(attributeName(child, a));
+                for (char& c : name) {
+                    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+                }
+                out.attributes[std::move(name)] = std::string(attributeValue(child, a));
+            }
+            stack.push_back({child, &out});
+        }
+    }
+    return result;
+}
+
+void Document::appendNode(NodeId parent, const Node& source) {
+    const NodeId id = appendChild(parent, tagFromNodeType(source.type));
+    if (!source.text.empty()) arena_.node(id).text = store(source.text);
+    for (const auto& attr : source.attributes) {
+        TextRange name = store(attr.first);
+        addAttribute(id, name, store(attr.second));
+    }
+    for (const auto& child : source.children) appendNode(id, child);
+}
+
+Document Document::fromNode(const Node& root) {
+    Document document;
+    document.arena_.node(document.root()).tag = tagFromNodeType(root.type);
+    if (!root.text.empty()) document.arena_.node(document.root()).text = document.store(root.text);
+    for (const auto& child : root.children) document.appendNode(document.root(), child);
+    return document;
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+/**
+ * @file dom.h
+ * @brief Defines the compact, arena-backed document representation.
+ */
+#ifndef DOM_H
+#define DOM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "tag_atoms.h"
+
+struct Node;
+
+/**
+ * @brief Index of a node inside its document. The root is always 0.
+ */
+using NodeId = uint32_t;
+
+/**
+ * @brief Marks a missing child or sibling link.
+ */
+constexpr NodeId kNoNode = 0xFFFFFFFFu;
+
+/**
+ * @brief Returns the legacy Node::type string for a tag ("p", "image", "link", ...).
+ *
+ * Tags outside the legacy vocabulary map to their HTML name.
+ */
+const char* nodeTypeName(TagAtom tag);
+
+/**
+ * @brief Maps a legacy Node::type string back to a tag.
+ * @return The tag, or TagAtom::Unknown for names outside the legacy vocabulary.
+ */
+TagAtom tagFromNodeType(std::string_view type);
+
+/**
+ * @brief Byte range of a string owned by a Document.
+ */
+struct TextRange {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+/**
+ * @brief A DOM node stored by value in the document arena.
+ *
+ * Children form a singly linked list through node indices; attributes are a
+ * contiguous run in the arena's attribute region.
+ */
+struct DomNode {
+    TextRange text;
+    NodeId first_child = kNoNode;
+    NodeId last_child = kNoNode;
+    NodeId next_sibling = kNoNode;
+    uint32_t first_attribute = 0;
+    uint32_t attribute_count = 0;
+    TagAtom tag = TagAtom::Root;
+};
+
+/**
+ * @brief A name/value attribute pair stored in the document arena.
+ */
+struct DomAttribute {
+    TextRange name;
+    TextRange value;
+};
+
+/**
+ * @class DomArena
+ * @brief Single-block storage for nodes and attributes.
+ *
+ * Nodes grow up from the start of the block and attributes grow down from
+ * its end, so one allocation holds both. When the two regions meet the block
+ * is doubled; records are addressed by index, so growth never invalidates
+ * links between them.
+ */
+class DomArena {
+public:
+    /**
+     * @brief Creates an arena.
+     * @param initial_bytes Initial block size; 0 defers allocation.
+     */
+    explicit DomArena(size_t initial_bytes = 0);
+
+    DomArena(DomArena&& other) noexcept;
+    DomArena& operator=(DomArena&& other) noexcept;
+    DomArena(const DomArena&) = delete;
+    DomArena& operator=(const DomArena&) = delete;
+
+    /**
+     * @brief Appends a default-initialized node.
+     * @return Index of the new node.
+     */
+    NodeId addNode();
+
+    /**
+     * @brief Appends an attribute record.
+     * @return Index of the new attribute.
+     */
+    uint32_t addAttribute();
+
+    DomNode& node(NodeId id) { return nodes()[id]; }
+    const DomNode& node(NodeId id) const { return nodes()[id]; }
+    DomAttribute& attribute(uint32_t index) { return attributesEnd()[-1 - static_cast<ptrdiff_t>(index)]; }
+    const DomAttribute& attribute(uint32_t index) const {
+        return attributesEnd()[-1 - static_cast<ptrdiff_t>(index)];
+    }
+
+    size_t nodeCount() const { return node_count_; }
+    size_t attributeCount() const { return attribute_count_; }
+
+    /**
+     * @brief Returns the size of the arena block in bytes.
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    DomNode* nodes() { return reinterpret_cast<DomNode*>(block_.get()); }
+    const DomNode* nodes() const { return reinterpret_cast<const DomNode*>(block_.get()); }
+    DomAttribute* attributesEnd() { return reinterpret_cast<DomAttribute*>(block_.get() + capacity_); }
+    const DomAttribute* attributesEnd() const {
+        return reinterpret_cast<const DomAttribute*>(block_.get() + capacity_);
+    }
+    size_t usedBytes() const;
+    void grow();
+
+    std::unique_ptr<unsigned char[]> block_;
+    size_t capacity_ = 0;
+    size_t node_count_ = 0;
+    size_t attribute_count_ = 0;
+};
+
+/**
+ * @class Document
+ * @brief A parsed page: the retained source text plus an arena of nodes.
+ *
+ * Text and attribute values are views into the source buffer, so parsing
+ * allocates only the arena. Values replaced after parsing (e.g. resolved
+ * media paths) are kept in a side buffer. Views returned by accessors stay
+ * valid until the document is modified or destroyed.
+ */
+class Document {
+public:
+    /**
+     * @brief Creates an empty document holding only the root node.
+     */
+    Document();
+
+    /**
+     * @brief Creates a document that takes ownership of its source text.
+     * @param source HTML the node ranges refer to.
+     */
+    explicit Document(std::string source);
+
+    Document(Document&&) noexcept = default;
+    Document& operator=(Document&&) noexcept = default;
+
+    /**
+     * @brief Returns the retained source text.
+     */
+    const std::string& source() const { return source_; }
+
+    /**
+     * @brief Appends text to the source, for incremental parsing.
+     *
+     * Node ranges are offsets, so nodes stay valid; views returned earlier
+     * do not.
+     */
+    void appendSource(const char* data, size_t size) { source_.append(data, size); }
+
+    NodeId root() const { return 0; }
+    size_t nodeCount() const { return arena_.nodeCount(); }
+
+    /**
+     * @brief Returns the bytes the document holds: source, side text and arena.
+     */
+    size_t memoryBytes() const { return source_.capacity() + side_.capacity() + arena_.capacity(); }
+    const DomNode& node(NodeId id) const { return arena_.node(id); }
+
+    /**
+     * @brief Returns the text content of a node.
+     */
+    std::string_view text(NodeId id) const { return view(arena_.node(id).text); }
+
+    /**
+     * @brief Returns the number of attributes on a node.
+     */
+    size_t attributeCount(NodeId id) const { return arena_.node(id).attribute_count; }
+
+    /**
+     * @brief Returns an attribute name as written in the source.
+     */
+    std::string_view attributeName(NodeId id, size_t index) const;
+
+    /**
+     * @brief Returns an attribute value.
+     */
+    std::string_view attributeValue(NodeId id, size_t index) const;
+
+    /**
+     * @brief Looks up an attribute by ASCII case-insensitive name.
+     * @param id Node to search.
+     * @param name Lowercase attribute name.
+     * @param value Receives the value if found (last duplicate wins).
+     * @return True if the attribute exists.
+     */
+    bool findAttribute(NodeId id, std::string_view name, std::string_view& value) const;
+
+    /**
+     * @brief Returns an attribute value, or an empty view if it is missing.
+     */
+    std::string_view attribute(NodeId id, std::string_view name) const;
+
+    /**
+     * @brief Calls visit(id) for every node in document order, root first.
+     *
+     * Walks with an explicit stack, so deep documents cannot overflow the
+     * caller's stack.
+     */
+    template <typename Visit>
+    void forEachNode(Visit&& visit) const;
+
+    /**
+     * @brief Appends a child element.
+     * @param parent Parent node.
+     * @param tag Element tag.
+     * @return Index of the new node.
+     */
+    NodeId appendChild(NodeId parent, TagAtom tag);
+
+    /**
+     * @brief Sets a node's text to a range of the source.
+     */
+    void setText(NodeId id, size_t offset, size_t length);
+
+    /**
+     * @brief Sets a node's text to a range of the source, normalized for display.
+     *
+     * See normalizeText(). Text that is already normal, the usual case, stays
+     * a range of the source; other text is written once, normalized, into the
+     * side buffer.
+     */
+    void setNormalizedText(NodeId id, size_t offset, size_t length);
+
+    /**
+     * @brief Adds an attribute whose name and value are ranges of the source.
+     *
+     * A node's attributes must be added back to back, before attributes of
+     * any other node, so they stay contiguous in the arena.
+     */
+    void addAttribute(NodeId id, TextRange name, TextRange value);
+
+    /**
+     * @brief Replaces the value of an existing attribute.
+     * @param id Node to modify.
+     * @param name Lowercase attribute name.
+     * @param value New value, copied into the side buffer.
+     * @return False if the node has no such attribute.
+     */
+    bool replaceAttribute(NodeId id, std::string_view name, std::string_view value);
+
+    /**
+     * @brief Converts to the legacy owning Node tree.
+     */
+    Node toNode() const;
+
+    /**
+     * @brief Builds a document from a legacy Node tree.
+     *
+     * Strings are copied into the side buffer; used to adapt parsers that only
+     * produce Node trees.
+     */
+    static Document fromNode(const Node& root);
+
+private:
+    std::string_view view(TextRange range) const;
+    TextRange store(std::string_view value);
+    void appendNode(NodeId parent, const Node& node);
+
+    std::string source_;
+    std::string side_;
+    DomArena arena_;
+};
+
+template <typename Visit>
+void Document::forEachNode(Visit&& visit) const {
+    std::vector<NodeId> stack{root()};
+    while (!stack.empty()) {
+        const NodeId id = stack.back();
+        stack.pop_back();
+        visit(id);
+        // Push children last to first so they are visited in order.
+        const size_t first = stack.size();
+        for (NodeId child = node(id).first_child; child != kNoNode; child = node(child).next_sibling) {
+            stack.push_back(child);
+        }
+        std::reverse(stack.begin() + static_cast<ptrdiff_t>(first), stack.end());
+    }
+}
+
+#endif // DOM_H
\ No newline at end of file
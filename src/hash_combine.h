@@ -0,0 +1,17 @@
+/**
+ * @file hash_combine.h
+ * @brief Defines combining of hash values for composite cache keys.
+ */
+#ifndef HASH_COMBINE_H
+#define HASH_COMBINE_H
+
+#include <cstddef>
+
+/**
+ * @brief Mixes value into hash, as boost::hash_combine does.
+ */
+inline void hashCombine(size_t& hash, size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+}
+
+#endif // HASH_COMBINE_H
\ No newline at end of file
@@ -3,11 +3,66 @@
  * @brief Implements HTML parsing with scalar, SIMD, and NEON optimizations.
  */
 #include "html_parser.h"
-#include <arm_neon.h>
+#include "cpu_features.h"
+#include "text_normalizer.h"
+#include "trace.h"
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
-#include <iostream>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QUICKDOM_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Elements the parsers turn into nodes; every other tag is skipped.
+bool isParsedTag(TagAtom tag) {
+    switch (tag) {
+        case TagAtom::P:
+        case TagAtom::Img:
+        case TagAtom::A:
+        case TagAtom::H1:
+        case TagAtom::H2:
+        case TagAtom::Div:
+        case TagAtom::Span:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Adapts a parser without incremental support: buffers, then parses once.
+class BufferedParseStream : public ParseStream {
+public:
+    explicit BufferedParseStream(HtmlParser& parser) : parser_(parser) {}
+
+    void feed(const char* data, size_t size) override { html_.append(data, size); }
+    Document finish() override { return parser_.parseDocument(std::move(html_)); }
+
+private:
+    HtmlParser& parser_;
+    std::string html_;
+};
+
+} // namespace
+
+Document HtmlParser::parseDocument(std::string html) {
+    return Document::fromNode(parse(html));
+}
+
+std::unique_ptr<ParseStream> HtmlParser::stream() {
+    return std::make_unique<BufferedParseStream>(*this);
+}
 
 Node ScalarParser::parse(const std::string& html) {
     Node root;
@@ -27,8 +82,9 @@ Node ScalarParser::parse(const std::string& html) {
                     tag += std::tolower(html[pos++]);
                 }
                 Node node;
-                if (tag == "p" || tag == "img" || tag == "a" || tag == "h1" || tag == "h2" || tag == "div" || tag == "span") {
-                    node.type = (tag == "img") ? "image" : (tag == "a") ? "link" : (tag == "h1" || tag == "h2") ? "header" : tag;
+                const TagAtom atom = lookupTag(tag);
+                if (isParsedTag(atom)) {
+                    node.type = nodeTypeName(atom);
                     // Parse attributes
                     while (pos < html.length() && html[pos] != '>') {
                         if (html[pos] == ' ') {
@@ -44,12 +100,12 @@ Node ScalarParser::parse(const std::string& html) {
                                     while (pos < html.length() && html[pos] != '"') {
                                         attr_value += html[pos++];
                                     }
-                                    ++pos;
+                                    if (pos < html.length()) ++pos; // closing quote, if any
                                 }
                             }
                             if (!attr_key.empty()) {
                                 node.attributes[attr_key] = attr_value;
-                                std::cout << "Attr: " << attr_key << "=\"" << attr_value << "\"\n";
+                                QUICKDOM_TRACE_DEBUG("Attr", attr_key, "=\"", attr_value, "\"");
                             }
                         } else {
                             ++pos;
@@ -57,20 +113,20 @@ Node ScalarParser::parse(const std::string& html) {
                     }
                     if (pos < html.length() && html[pos] == '>') ++pos;
                     // Parse text content for p, a, h1, h2, div, span
-                    if (tag != "img") {
-                        std::string text;
-                        while (pos < html.length() && html[pos] != '<') {
-                            text += html[pos++];
-                        }
+                    if (atom != TagAtom::Img) {
+                        const size_t text_begin = pos;
+                        while (pos < html.length() && html[pos] != '<') ++pos;
+                        const std::string text =
+                            normalizedText(std::string_view(html.data() + text_begin, pos - text_begin));
                         if (!text.empty()) {
                             node.text = text;
-                            if (tag == "p" || tag == "h1" || tag == "h2" || tag == "div" || tag == "span") {
-                                std::cout << "Parsed text: " << text << "\n";
+                            if (atom != TagAtom::A) {
+                                QUICKDOM_TRACE_DEBUG("Parsed text", text);
                             }
                         }
                     }
                     root.children.push_back(node);
-                    std::cout << "Parsed tag: <" << tag << ">\n";
+                    QUICKDOM_TRACE_DEBUG("Parsed tag", "<", tag, ">");
                 } else {
                     // Skip unsupported tags
                     while (pos < html.length() && html[pos] != '>') ++pos;
@@ -84,90 +140,491 @@ Node ScalarParser::parse(const std::string& html) {
     return root;
 }
 
-Node SimdParser::parse(const std::string& html) {
-    // Fallback to scalar for simplicity
-    return ScalarParser().parse(html);
+namespace {
+
+// Structural character classes tracked by the scanner.
+enum CharClass : unsigned {
+    kLt = 1u << 0,    // '<'
+    kGt = 1u << 1,    // '>'
+    kQuote = 1u << 2, // '"'
+    kEq = 1u << 3,    // '='
+    kSpace = 1u << 4  // ' '
+};
+
+constexpr size_t kBlockSize = 64;
+
+// One bit per byte of a 64-byte block for every structural class.
+struct BlockMasks {
+    uint64_t lt;
+    uint64_t gt;
+    uint64_t quote;
+    uint64_t eq;
+    uint64_t space;
+};
+
+using ClassifyBlockFn = void (*)(const char* block, BlockMasks* masks);
+
+void classifyScalar(const char* block, BlockMasks* masks) {
+    BlockMasks m{};
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        const uint64_t bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '<': m.lt |= bit; break;
+            case '>': m.gt |= bit; break;
+            case '"': m.quote |= bit; break;
+            case '=': m.eq |= bit; break;
+            case ' ': m.space |= bit; break;
+            default: break;
+        }
+    }
+    *masks = m;
 }
 
-Node NeonParser::parse(const std::string& html) {
-    Node root;
-    root.type = "root";
-    size_t pos = 0;
-    const char* data = html.c_str();
-    size_t len = html.length();
+#if defined(QUICKDOM_X86)
+// Kernels are compiled for their instruction set regardless of the build's
+// -m flags; SimdParser only calls the ones cpuFeatures() reports.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define QUICKDOM_TARGET(isa)
+#else
+#define QUICKDOM_TARGET(isa) __attribute__((target(isa)))
+#endif
 
-    while (pos < len) {
-        // NEON-accelerated tag search
-        if (data[pos] == '<' && pos + 1 < len) {
-            if (data[pos + 1] == '/') {
-                // Skip closing tags
-                while (pos < len && data[pos] != '>') ++pos;
-                ++pos;
-                continue;
-            }
-            ++pos;
-            std::string tag;
-            while (pos < len && data[pos] != ' ' && data[pos] != '>') {
-                tag += std::tolower(data[pos++]);
+QUICKDOM_TARGET("sse2")
+inline uint64_t sse2Mask(__m128i v0, __m128i v1, __m128i v2, __m128i v3, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    const uint64_t m0 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v0, needle)));
+    const uint64_t m1 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v1, needle)));
+    const uint64_t m2 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v2, needle)));
+    const uint64_t m3 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v3, needle)));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+QUICKDOM_TARGET("sse2")
+void classifySse2(const char* block, BlockMasks* masks) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
+    const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
+    masks->lt = sse2Mask(v0, v1, v2, v3, '<');
+    masks->gt = sse2Mask(v0, v1, v2, v3, '>');
+    masks->quote = sse2Mask(v0, v1, v2, v3, '"');
+    masks->eq = sse2Mask(v0, v1, v2, v3, '=');
+    masks->space = sse2Mask(v0, v1, v2, v3, ' ');
+}
+
+QUICKDOM_TARGET("avx2")
+inline uint64_t avx2Mask(__m256i lo, __m256i hi, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    const uint64_t m0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    const uint64_t m1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return m0 | (m1 << 32);
+}
+
+QUICKDOM_TARGET("avx2")
+void classifyAvx2(const char* block, BlockMasks* masks) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    masks->lt = avx2Mask(lo, hi, '<');
+    masks->gt = avx2Mask(lo, hi, '>');
+    masks->quote = avx2Mask(lo, hi, '"');
+    masks->eq = avx2Mask(lo, hi, '=');
+    masks->space = avx2Mask(lo, hi, ' ');
+}
+
+// One 64-byte register per block; the compare yields the bitmask directly.
+QUICKDOM_TARGET("avx512f,avx512bw")
+void classifyAvx512(const char* block, BlockMasks* masks) {
+    const __m512i v = _mm512_loadu_si512(block);
+    masks->lt = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('<'));
+    masks->gt = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('>'));
+    masks->quote = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+    masks->eq = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('='));
+    masks->space = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' '));
+}
+#endif
+
+#if defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define QUICKDOM_HAVE_NEON 1
+
+// NEON has no movemask: weight each lane's compare result by its bit
+// position and fold the four vectors together with pairwise adds.
+inline uint64_t neonMask(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3,
+                         uint8x16_t weights, uint8_t c) {
+    const uint8x16_t needle = vdupq_n_u8(c);
+    const uint8x16_t m0 = vandq_u8(vceqq_u8(v0, needle), weights);
+    const uint8x16_t m1 = vandq_u8(vceqq_u8(v1, needle), weights);
+    const uint8x16_t m2 = vandq_u8(vceqq_u8(v2, needle), weights);
+    const uint8x16_t m3 = vandq_u8(vceqq_u8(v3, needle), weights);
+    uint8x16_t sum = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+    sum = vpaddq_u8(sum, sum);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+
+void classifyNeon(const char* block, BlockMasks* masks) {
+    static const uint8_t kWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t weights = vld1q_u8(kWeights);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(block);
+    const uint8x16_t v0 = vld1q_u8(bytes);
+    const uint8x16_t v1 = vld1q_u8(bytes + 16);
+    const uint8x16_t v2 = vld1q_u8(bytes + 32);
+    const uint8x16_t v3 = vld1q_u8(bytes + 48);
+    masks->lt = neonMask(v0, v1, v2, v3, weights, '<');
+    masks->gt = neonMask(v0, v1, v2, v3, weights, '>');
+    masks->quote = neonMask(v0, v1, v2, v3, weights, '"');
+    masks->eq = neonMask(v0, v1, v2, v3, weights, '=');
+    masks->space = neonMask(v0, v1, v2, v3, weights, ' ');
+}
+#endif
+
+inline unsigned countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+/**
+ * Answers "next byte at or after pos in any of these classes" from per-block
+ * bitmasks. The tokenizer only moves forward, so each 64-byte block is
+ * classified once and cached while the cursor stays inside it. A search that
+ * runs off the end returns size(); the input may then be extended and the
+ * search resumed from there.
+ */
+class StructuralScanner {
+public:
+    explicit StructuralScanner(ClassifyBlockFn classify) : classify_(classify) {}
+
+    // Points the scanner at a longer copy of the same input. A cached tail
+    // block was zero-padded and is classified again with the new bytes.
+    void extend(const char* data, size_t size) {
+        if (block_ != kNoBlock && (block_ + 1) * kBlockSize > size_) block_ = kNoBlock;
+        data_ = data;
+        size_ = size;
+    }
+
+    template <unsigned Classes>
+    size_t find(size_t pos) {
+        while (pos < size_) {
+            const size_t block = pos / kBlockSize;
+            if (block != block_) load(block);
+            uint64_t bits = 0;
+            if (Classes & kLt) bits |= masks_.lt;
+            if (Classes & kGt) bits |= masks_.gt;
+            if (Classes & kQuote) bits |= masks_.quote;
+            if (Classes & kEq) bits |= masks_.eq;
+            if (Classes & kSpace) bits |= masks_.space;
+            bits &= ~uint64_t(0) << (pos % kBlockSize);
+            if (bits) {
+                // Padding past the end is zero-filled and never matches.
+                return block * kBlockSize + countTrailingZeros(bits);
             }
-            Node node;
-            if (tag == "p" || tag == "img" || tag == "a" || tag == "h1" || tag == "h2" || tag == "div" || tag == "span") {
-                node.type = (tag == "img") ? "image" : (tag == "a") ? "link" : (tag == "h1" || tag == "h2") ? "header" : tag;
-                // Parse attributes
-                while (pos < len && data[pos] != '>') {
-                    if (data[pos] == ' ') {
-                        ++pos;
-                        std::string attr_key, attr_value;
-                        while (pos < len && data[pos] != '=' && data[pos] != '>') {
-                            attr_key += std::tolower(data[pos++]);
-                        }
-                        if (pos < len && data[pos] == '=') {
-                            ++pos;
-                            if (pos < len && data[pos] == '"') {
-                                ++pos;
-                                while (pos < len && data[pos] != '"') {
-                                    attr_value += data[pos++];
-                                }
-                                ++pos;
-                            }
-                        }
-                        if (!attr_key.empty()) {
-                            node.attributes[attr_key] = attr_value;
-                            std::cout << "Attr: " << attr_key << "=\"" << attr_value << "\"\n";
-                        }
-                    } else {
-                        ++pos;
-                    }
+            pos = (block + 1) * kBlockSize;
+        }
+        return size_;
+    }
+
+private:
+    void load(size_t block) {
+        const size_t begin = block * kBlockSize;
+        if (begin + kBlockSize <= size_) {
+            classify_(data_ + begin, &masks_);
+        } else {
+            char tail[kBlockSize] = {};
+            std::memcpy(tail, data_ + begin, size_ - begin);
+            classify_(tail, &masks_);
+        }
+        block_ = block;
+    }
+
+    static constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    ClassifyBlockFn classify_;
+    size_t block_ = kNoBlock;
+    BlockMasks masks_{};
+};
+
+inline char asciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+TextRange range(size_t begin, size_t end) {
+    return TextRange{static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)};
+}
+
+/**
+ * Tokenizer driven by structural bitmasks. Follows ScalarParser rule for
+ * rule (same skipping of closing and unsupported tags, same attribute and
+ * text capture) so both produce identical trees; only the character search
+ * differs. Nodes record ranges of the source instead of copying it; only text
+ * that normalization changes is written out, once, as it is captured.
+ *
+ * Input may arrive in pieces. The tokenizer is a state machine that stops
+ * wherever the buffered input ends, mid-tag, mid-attribute or mid-text, and
+ * resumes its search from the same byte when more arrives, so every byte is
+ * classified once however the input is split.
+ */
+class Tokenizer : public ParseStream {
+public:
+    Tokenizer(ClassifyBlockFn classify, std::string initial)
+        : document_(std::move(initial)), scanner_(classify) {
+        run();
+    }
+
+    void feed(const char* data, size_t size) override {
+        if (size == 0) return;
+        document_.appendSource(data, size);
+        run();
+    }
+
+    Document finish() override;
+
+private:
+    enum class State {
+        Data,            // looking for '<'
+        ClosingTag,      // skipping to the '>' of a closing tag
+        TagName,         // reading a tag name from token_begin_
+        SkipTag,         // skipping to the '>' of an unsupported tag
+        AttributeSeek,   // looking for the next attribute or the tag end
+        AttributeKey,    // reading a key from token_begin_
+        AttributeEquals, // just past '=', checking for a quoted value
+        AttributeValue,  // reading a quoted value from value_begin_
+        Text             // reading element text from token_begin_
+    };
+
+    void run();
+    void openTag(size_t name_end);
+    void closeAttribute(TextRange value);
+    void endTag();
+
+    Document document_;
+    StructuralScanner scanner_;
+    State state_ = State::Data;
+    size_t pos_ = 0;
+    size_t token_begin_ = 0;
+    size_t key_end_ = 0;
+    size_t value_begin_ = 0;
+    TagAtom tag_ = TagAtom::Unknown;
+    NodeId node_ = kNoNode;
+};
+
+void Tokenizer::run() {
+    const char* data = document_.source().data();
+    const size_t len = document_.source().size();
+    scanner_.extend(data, len);
+
+    while (true) {
+        switch (state_) {
+            case State::Data:
+                pos_ = scanner_.find<kLt>(pos_);
+                // Wait for the byte after '<' to tell closing tags apart.
+                if (pos_ + 1 >= len) return;
+                if (data[pos_ + 1] == '/') {
+                    ++pos_;
+                    state_ = State::ClosingTag;
+                } else {
+                    token_begin_ = pos_ = pos_ + 1;
+                    state_ = State::TagName;
                 }
-                if (pos < len && data[pos] == '>') ++pos;
-                // Parse text content for p, a, h1, h2, div, span
-                if (tag != "img") {
-                    std::string text;
-                    while (pos < len && data[pos] != '<') {
-                        text += data[pos++];
-                    }
-                    if (!text.empty()) {
-                        node.text = text;
-                        std::cout << "NEON: found <" << tag << "> at " << pos - text.length() << ", text: " << text << "\n";
-                    }
+                break;
+
+            case State::ClosingTag:
+            case State::SkipTag:
+                pos_ = scanner_.find<kGt>(pos_);
+                if (pos_ >= len) return;
+                ++pos_;
+                state_ = State::Data;
+                break;
+
+            case State::TagName:
+                pos_ = scanner_.find<kSpace | kGt>(pos_);
+                if (pos_ >= len) return;
+                openTag(pos_);
+                break;
+
+            case State::AttributeSeek:
+                pos_ = scanner_.find<kSpace | kGt>(pos_);
+                if (pos_ >= len) return;
+                if (data[pos_] == '>') {
+                    ++pos_;
+                    endTag();
+                } else {
+                    token_begin_ = ++pos_;
+                    state_ = State::AttributeKey;
                 }
-                // Log image src
-                if (tag == "img") {
-                    auto src_it = node.attributes.find("src");
-                    if (src_it != node.attributes.end()) {
-                        std::cout << "NEON: found <img> at " << pos << ", src: " << src_it->second << "\n";
-                    }
+                break;
+
+            case State::AttributeKey:
+                pos_ = scanner_.find<kEq | kGt>(pos_);
+                if (pos_ >= len) return;
+                key_end_ = pos_;
+                if (data[pos_] == '=') {
+                    ++pos_;
+                    state_ = State::AttributeEquals;
+                } else {
+                    closeAttribute(TextRange());
                 }
-                root.children.push_back(node);
-                std::cout << "Parsed tag: <" << tag << ">\n";
-            } else {
-                // Skip unsupported tags
-                while (pos < len && data[pos] != '>') ++pos;
-                if (pos < len) ++pos;
-            }
-        } else {
-            ++pos;
+                break;
+
+            case State::AttributeEquals:
+                if (pos_ >= len) return;
+                if (data[pos_] == '"') {
+                    value_begin_ = ++pos_;
+                    state_ = State::AttributeValue;
+                } else {
+                    closeAttribute(TextRange());
+                }
+                break;
+
+            case State::AttributeValue:
+                pos_ = scanner_.find<kQuote>(pos_);
+                if (pos_ >= len) return;
+                closeAttribute(range(value_begin_, pos_));
+                ++pos_;
+                break;
+
+            case State::Text:
+                pos_ = scanner_.find<kLt>(pos_);
+                if (pos_ >= len) return;
+                document_.setNormalizedText(node_, token_begin_, pos_ - token_begin_);
+                state_ = State::Data;
+                break;
         }
     }
-    return root;
+}
+
+void Tokenizer::openTag(size_t name_end) {
+    const char* data = document_.source().data();
+    tag_ = lookupTag(std::string_view(data + token_begin_, name_end - token_begin_));
+    if (!isParsedTag(tag_)) {
+        // Skip unsupported tags
+        state_ = State::SkipTag;
+        return;
+    }
+    node_ = document_.appendChild(document_.root(), tag_);
+    state_ = State::AttributeSeek;
+}
+
+void Tokenizer::closeAttribute(TextRange value) {
+    if (key_end_ > token_begin_) {
+        document_.addAttribute(node_, range(token_begin_, key_end_), value);
+    }
+    state_ = State::AttributeSeek;
+}
+
+void Tokenizer::endTag() {
+    // Parse text content for everything but img
+    if (tag_ != TagAtom::Img) {
+        token_begin_ = pos_;
+        state_ = State::Text;
+    } else {
+        state_ = State::Data;
+    }
+}
+
+Document Tokenizer::finish() {
+    // Close whatever the input ended inside, as a one-shot parse would.
+    const size_t len = document_.source().size();
+    switch (state_) {
+        case State::TagName:
+            openTag(len);
+            break;
+        case State::AttributeKey:
+            key_end_ = len;
+            closeAttribute(TextRange());
+            break;
+        case State::AttributeEquals:
+            closeAttribute(TextRange());
+            break;
+        case State::AttributeValue:
+            closeAttribute(range(value_begin_, len));
+            break;
+        case State::Text:
+            if (len > token_begin_) document_.setNormalizedText(node_, token_begin_, len - token_begin_);
+            break;
+        default:
+            break;
+    }
+    state_ = State::Data;
+    return std::move(document_);
+}
+
+Document tokenize(std::string html, ClassifyBlockFn classify) {
+    return Tokenizer(classify, std::move(html)).finish();
+}
+
+ClassifyBlockFn x86Classifier(SimdLevel level) {
+#if defined(QUICKDOM_X86)
+    switch (level) {
+        case SimdLevel::Avx512: return classifyAvx512;
+        case SimdLevel::Avx2: return classifyAvx2;
+        case SimdLevel::Sse2: return classifySse2;
+    }
+#endif
+    (void)level;
+    return classifyScalar;
+}
+
+// Never execute a kernel the CPU lacks; the portable classifier still
+// produces the same tree.
+ClassifyBlockFn supportedX86Classifier(SimdLevel level) {
+    return simdLevelSupported(level) ? x86Classifier(level) : classifyScalar;
+}
+
+ClassifyBlockFn bestArmClassifier() {
+#if defined(QUICKDOM_HAVE_NEON)
+    return classifyNeon;
+#else
+    return classifyScalar;
+#endif
+}
+
+} // namespace
+
+bool simdLevelSupported(SimdLevel level) {
+    const CpuFeatures& cpu = cpuFeatures();
+    switch (level) {
+        case SimdLevel::Sse2: return cpu.sse2;
+        case SimdLevel::Avx2: return cpu.avx2;
+        case SimdLevel::Avx512: return cpu.avx512bw;
+    }
+    return false;
+}
+
+SimdParser::SimdParser() : level_(SimdLevel::Sse2) {
+    if (simdLevelSupported(SimdLevel::Avx512)) {
+        level_ = SimdLevel::Avx512;
+    } else if (simdLevelSupported(SimdLevel::Avx2)) {
+        level_ = SimdLevel::Avx2;
+    }
+}
+
+SimdParser::SimdParser(SimdLevel level) : level_(level) {}
+
+Node SimdParser::parse(const std::string& html) {
+    return parseDocument(html).toNode();
+}
+
+Document SimdParser::parseDocument(std::string html) {
+    return tokenize(std::move(html), supportedX86Classifier(level_));
+}
+
+std::unique_ptr<ParseStream> SimdParser::stream() {
+    return std::make_unique<Tokenizer>(supportedX86Classifier(level_), std::string());
+}
+
+Node NeonParser::parse(const std::string& html) {
+    return parseDocument(html).toNode();
+}
+
+Document NeonParser::parseDocument(std::string html) {
+    return tokenize(std::move(html), bestArmClassifier());
+}
+
+std::unique_ptr<ParseStream> NeonParser::stream() {
+    return std::make_unique<Tokenizer>(bestArmClassifier(), std::string());
 }
\ No newline at end of file
@@ -5,12 +5,18 @@
 #ifndef HTML_PARSER_H
 #define HTML_PARSER_H
 
+#include "dom.h"
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <map>
 #include <vector>
 
 /**
- * @brief Represents a DOM node.
+ * @brief Represents a DOM node as an owning tree.
+ *
+ * Kept for code that builds or inspects trees by hand; parsers build the
+ * compact Document and convert on request.
  */
 struct Node {
     std::string type; // e.g., "text", "image", "link", "header", "div"
@@ -19,6 +25,33 @@ struct Node {
     std::vector<Node> children; // Child nodes
 };
 
+/**
+ * @class ParseStream
+ * @brief Incremental parse of one document, fed in arbitrary chunks.
+ *
+ * Chunks may split a tag, an attribute or a run of text anywhere; the
+ * result of finish() is the same as parsing the concatenated input at once.
+ */
+class ParseStream {
+public:
+    virtual ~ParseStream() = default;
+
+    /**
+     * @brief Appends the next chunk of input and parses as far as it allows.
+     * @param data Chunk bytes; copied, so the caller may reuse the buffer.
+     * @param size Chunk length.
+     */
+    virtual void feed(const char* data, size_t size) = 0;
+
+    /**
+     * @brief Ends the input and returns the document.
+     *
+     * A construct left open at the end of input is closed the way the
+     * one-shot parsers close it. The stream must not be used afterwards.
+     */
+    virtual Document finish() = 0;
+};
+
 /**
  * @brief Interface for HTML parsers.
  */
@@ -31,6 +64,26 @@ public:
      * @return Root node of the DOM tree.
      */
     virtual Node parse(const std::string& html) = 0;
+
+    /**
+     * @brief Parses HTML into an arena-backed document that keeps the source.
+     *
+     * The default implementation adapts parse(); the vectorized parsers build
+     * the document directly without per-node allocations.
+     * @param html HTML content, moved into the document.
+     * @return Parsed document.
+     */
+    virtual Document parseDocument(std::string html);
+
+    /**
+     * @brief Starts an incremental parse.
+     *
+     * The default implementation buffers the input and calls parseDocument()
+     * on finish(); the vectorized parsers tokenize each chunk as it arrives.
+     * The stream refers to this parser and must not outlive it.
+     * @return A new stream.
+     */
+    virtual std::unique_ptr<ParseStream> stream();
 };
 
 /**
@@ -41,20 +94,69 @@ public:
     Node parse(const std::string& html) override;
 };
 
+/**
+ * @brief x86 vector instruction set used by SimdParser.
+ */
+enum class SimdLevel {
+    Sse2,
+    Avx2,
+    Avx512 // AVX-512BW
+};
+
+/**
+ * @brief Checks whether the running CPU can execute a SIMD level.
+ * @param level Instruction set to check.
+ * @return True if the CPU and OS support it.
+ */
+bool simdLevelSupported(SimdLevel level);
+
 /**
  * @brief SIMD-accelerated HTML parser for x86.
+ *
+ * Classifies 64-byte blocks into bitmasks of structural characters
+ * (<, >, ", =, space) with SSE2, AVX2 or AVX-512 compares and drives tag,
+ * attribute and text extraction from those masks. Produces the same tree as
+ * ScalarParser.
  */
 class SimdParser : public HtmlParser {
 public:
+    /**
+     * @brief Uses the widest instruction set the running CPU supports.
+     */
+    SimdParser();
+
+    /**
+     * @brief Uses a specific instruction set.
+     * @param level Requested level; falls back to the portable classifier
+     *        if the CPU does not support it.
+     */
+    explicit SimdParser(SimdLevel level);
+
     Node parse(const std::string& html) override;
+    Document parseDocument(std::string html) override;
+    std::unique_ptr<ParseStream> stream() override;
+
+    /**
+     * @brief Returns the instruction set this parser was configured with.
+     */
+    SimdLevel level() const { return level_; }
+
+private:
+    SimdLevel level_;
 };
 
 /**
  * @brief NEON-accelerated HTML parser for ARM.
+ *
+ * Shares the block tokenizer with SimdParser; the masks come from
+ * vld1q_u8/vceqq_u8 compares on AArch64 and from a portable byte classifier
+ * on other targets.
  */
 class NeonParser : public HtmlParser {
 public:
     Node parse(const std::string& html) override;
+    Document parseDocument(std::string html) override;
+    std::unique_ptr<ParseStream> stream() override;
 };
 
 #endif // HTML_PARSER_H
\ No newline at end of file
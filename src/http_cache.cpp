@@ -0,0 +1,256 @@
+/**
+ * @file http_cache.cpp
+ * @brief Implements the in-memory HTTP response cache.
+ */
+#include "http_cache.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include "trace.h"
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parses an HTTP-date; returns -1 if it is missing or malformed.
+std::time_t parseHttpDate(const std::string& value) {
+    if (value.empty()) return -1;
+    return curl_getdate(value.c_str(), nullptr);
+}
+
+// Parses a non-negative delta-seconds value; returns -1 if malformed.
+long parseSeconds(std::string_view value) {
+    value = trim(value);
+    if (!value.empty() && value.front() == '"' && value.back() == '"' && value.size() >= 2) {
+        value = value.substr(1, value.size() - 2);
+    }
+    if (value.empty()) return -1;
+    long seconds = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') return -1;
+        seconds = seconds > 100000000L ? seconds : seconds * 10 + (c - '0'); // saturate
+    }
+    return seconds;
+}
+
+// Cache-Control directives the cache acts on
+struct CacheControl {
+    bool no_store = false;
+    bool no_cache = false;
+    long max_age = -1;
+};
+
+CacheControl parseCacheControl(std::string_view value) {
+    CacheControl result;
+    while (!value.empty()) {
+        const size_t comma = value.find(',');
+        std::string_view directive = trim(value.substr(0, comma));
+        value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+        const size_t eq = directive.find('=');
+        const std::string_view name = trim(directive.substr(0, eq));
+        const std::string_view argument = eq == std::string_view::npos ? std::string_view() : directive.substr(eq + 1);
+        if (equalsIgnoreCase(name, "no-store")) {
+            result.no_store = true;
+        } else if (equalsIgnoreCase(name, "no-cache")) {
+            result.no_cache = true;
+        } else if (equalsIgnoreCase(name, "max-age")) {
+            result.max_age = parseSeconds(argument);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+void CacheHeaders::parseLine(std::string_view line) {
+    line = trim(line);
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        *this = CacheHeaders();
+        return;
+    }
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) return;
+    const std::string_view name = trim(line.substr(0, colon));
+    const std::string value(trim(line.substr(colon + 1)));
+    if (equalsIgnoreCase(name, "cache-control")) {
+        // Repeated headers are one comma-separated list.
+        cache_control = cache_control.empty() ? value : cache_control + ", " + value;
+    } else if (equalsIgnoreCase(name, "expires")) {
+        expires = value;
+    } else if (equalsIgnoreCase(name, "date")) {
+        date = value;
+    } else if (equalsIgnoreCase(name, "age")) {
+        age = value;
+    } else if (equalsIgnoreCase(name, "etag")) {
+        etag = value;
+    } else if (equalsIgnoreCase(name, "last-modified")) {
+        last_modified = value;
+    }
+}
+
+HttpCache::HttpCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+std::string HttpCache::normalizeUrl(const std::string& url) {
+    std::string key = url.substr(0, url.find('#'));
+    const size_t scheme_end = key.find("://");
+    if (scheme_end == std::string::npos) return key;
+    const size_t host_begin = scheme_end + 3;
+    size_t host_end = key.find_first_of("/?", host_begin);
+    if (host_end == std::string::npos) host_end = key.size();
+    for (size_t i = 0; i < host_end; ++i) {
+        key[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(key[i])));
+    }
+
+    const std::string scheme = key.substr(0, scheme_end);
+    const std::string_view authority(key.data() + host_begin, host_end - host_begin);
+    const std::string default_port = scheme == "http" ? ":80" : scheme == "https" ? ":443" : "";
+    if (!default_port.empty() && authority.size() > default_port.size() &&
+        authority.substr(authority.size() - default_port.size()) == default_port) {
+        key.erase(host_end - default_port.size(), default_port.size());
+        host_end -= default_port.size();
+    }
+    if (host_end == key.size() || key[host_end] != '/') key.insert(host_end, "/");
+    return key;
+}
+
+void HttpCache::applyHeaders(Entry& entry, const CacheHeaders& headers, std::time_t now) {
+    const CacheControl control = parseCacheControl(headers.cache_control);
+    entry.no_cache = control.no_cache;
+    if (!headers.etag.empty()) entry.etag = headers.etag;
+    if (!headers.last_modified.empty()) entry.last_modified = headers.last_modified;
+
+    // Age at receipt: the larger of the Age header and the Date skew.
+    const std::time_t date = parseHttpDate(headers.date);
+    long age = std::max(0L, parseSeconds(headers.age));
+    if (date > 0 && now > date) age = std::max(age, static_cast<long>(now - date));
+    entry.base_time = now - age;
+
+    const std::time_t reference = date > 0 ? date : now;
+    if (control.max_age >= 0) {
+        entry.lifetime = control.max_age;
+    } else if (!headers.expires.empty()) {
+        // An unparsable Expires (e.g. "0") means already expired.
+        const std::time_t expires = parseHttpDate(headers.expires);
+        entry.lifetime = expires > reference ? static_cast<long>(expires - reference) : 0;
+    } else {
+        const std::time_t modified = parseHttpDate(entry.last_modified);
+        entry.lifetime = modified > 0 && reference > modified ? static_cast<long>((reference - modified) / 10) : 0;
+    }
+}
+
+HttpCache::Lookup HttpCache::lookup(const std::string& url, std::time_t now) {
+    Lookup result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(normalizeUrl(url));
+    if (it == index_.end()) return result;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    const Entry& entry = *it->second;
+    result.body = entry.body;
+    result.etag = entry.etag;
+    result.last_modified = entry.last_modified;
+    const bool fresh = !entry.no_cache && now - entry.base_time < entry.lifetime;
+    result.state = fresh ? State::Fresh : State::Stale;
+    return result;
+}
+
+bool HttpCache::storable(long status, const CacheHeaders& headers, size_t body_size, std::time_t now) const {
+    if (status != 200 || body_size > capacity_bytes_) return false;
+    if (parseCacheControl(headers.cache_control).no_store) return false;
+    Entry entry;
+    applyHeaders(entry, headers, now);
+    // Never fresh and cannot be revalidated: nothing to gain.
+    return entry.lifetime > 0 || !entry.etag.empty() || !entry.last_modified.empty();
+}
+
+bool HttpCache::store(const std::string& url, long status, const CacheHeaders& headers, std::string body,
+                      std::time_t now) {
+    if (status != 200) return false;
+    if (!storable(status, headers, body.size(), now)) {
+        remove(url);
+        return false;
+    }
+
+    Entry entry;
+    entry.key = normalizeUrl(url);
+    applyHeaders(entry, headers, now);
+    entry.body = std::make_shared<const std::string>(std::move(body));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(entry.key);
+    if (it != index_.end()) {
+        size_bytes_ -= it->second->body->size();
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+    size_bytes_ += entry.body->size();
+    entries_.push_front(std::move(entry));
+    index_[entries_.front().key] = entries_.begin();
+    evict();
+    QUICKDOM_TRACE_DEBUG("Cached document", url);
+    return true;
+}
+
+std::shared_ptr<const std::string> HttpCache::revalidated(const std::string& url, const CacheHeaders& headers,
+                                                          std::time_t now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(normalizeUrl(url));
+    if (it == index_.end()) return nullptr;
+    Entry& entry = *it->second;
+    // A 304 updates metadata; headers it omits keep their stored values.
+    CacheHeaders merged = headers;
+    if (merged.etag.empty()) merged.etag = entry.etag;
+    if (merged.last_modified.empty()) merged.last_modified = entry.last_modified;
+    applyHeaders(entry, merged, now);
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return entry.body;
+}
+
+void HttpCache::remove(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(normalizeUrl(url));
+    if (it == index_.end()) return;
+    size_bytes_ -= it->second->body->size();
+    entries_.erase(it->second);
+    index_.erase(it);
+}
+
+void HttpCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    size_bytes_ = 0;
+}
+
+size_t HttpCache::entryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t HttpCache::sizeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_bytes_;
+}
+
+void HttpCache::evict() {
+    while (size_bytes_ > capacity_bytes_ && !entries_.empty()) {
+        const Entry& victim = entries_.back();
+        size_bytes_ -= victim.body->size();
+        index_.erase(victim.key);
+        entries_.pop_back();
+    }
+}
\ No newline at end of file
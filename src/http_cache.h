@@ -0,0 +1,169 @@
+/**
+ * @file http_cache.h
+ * @brief Defines an in-memory HTTP response cache with revalidation.
+ */
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <cstddef>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Response headers that decide whether and how long a response is cached.
+ */
+struct CacheHeaders {
+    std::string cache_control;
+    std::string expires;
+    std::string date;
+    std::string age;
+    std::string etag;
+    std::string last_modified;
+
+    /**
+     * @brief Records one raw header line as delivered by libcurl.
+     *
+     * A status line ("HTTP/...") starts a new response, e.g. after a
+     * redirect, and clears what was recorded so far.
+     */
+    void parseLine(std::string_view line);
+};
+
+/**
+ * @class HttpCache
+ * @brief Caches response bodies by normalized URL, following RFC 9111 freshness.
+ *
+ * Freshness comes from Cache-Control max-age, then Expires, then the usual
+ * 10% of the time since Last-Modified. Fresh entries are served without
+ * network I/O. Stale entries that carry an ETag or Last-Modified are
+ * revalidated with a conditional request, and a 304 replays the stored
+ * body. Entries are evicted least recently used once the byte budget is
+ * exceeded. Thread-safe.
+ */
+class HttpCache {
+public:
+    /**
+     * @brief Result state of a lookup.
+     */
+    enum class State {
+        Miss,  // nothing usable; fetch normally
+        Fresh, // serve body without contacting the server
+        Stale  // send a conditional request with the validators
+    };
+
+    /**
+     * @brief What a lookup found.
+     */
+    struct Lookup {
+        State state = State::Miss;
+        std::shared_ptr<const std::string> body;
+        std::string etag;
+        std::string last_modified;
+    };
+
+    /**
+     * @brief Creates a cache.
+     * @param capacity_bytes Total body bytes kept before evicting.
+     */
+    explicit HttpCache(size_t capacity_bytes = 32u << 20);
+
+    /**
+     * @brief Looks up a URL.
+     * @param url Request URL; normalized before lookup.
+     * @param now Current time.
+     */
+    Lookup lookup(const std::string& url, std::time_t now);
+
+    /**
+     * @brief Stores a full response if its headers allow caching.
+     * @param url Request URL.
+     * @param status HTTP status; only 200 responses are stored.
+     * @param headers Response headers.
+     * @param body Response body.
+     * @param now Time the response was received.
+     * @return True if the response was stored.
+     */
+    bool store(const std::string& url, long status, const CacheHeaders& headers, std::string body,
+               std::time_t now);
+
+    /**
+     * @brief Checks whether store() would keep a response.
+     *
+     * Lets a download decide from the headers, before the body arrives,
+     * whether the body is worth keeping for the cache.
+     * @param status HTTP status.
+     * @param headers Response headers.
+     * @param body_size Body size in bytes, or 0 if not known yet.
+     * @param now Time the response was received.
+     */
+    bool storable(long status, const CacheHeaders& headers, size_t body_size, std::time_t now) const;
+
+    /**
+     * @brief Returns the total body bytes kept before evicting.
+     */
+    size_t capacityBytes() const { return capacity_bytes_; }
+
+    /**
+     * @brief Applies a 304 Not Modified response to a stored entry.
+     *
+     * Refreshes the entry's freshness and validators from the 304 headers.
+     * @return The stored body, or nullptr if the entry is gone.
+     */
+    std::shared_ptr<const std::string> revalidated(const std::string& url, const CacheHeaders& headers,
+                                                   std::time_t now);
+
+    /**
+     * @brief Drops one URL from the cache.
+     */
+    void remove(const std::string& url);
+
+    /**
+     * @brief Drops every entry.
+     */
+    void clear();
+
+    size_t entryCount() const;
+
+    /**
+     * @brief Returns the total size of stored bodies in bytes.
+     */
+    size_t sizeBytes() const;
+
+    /**
+     * @brief Normalizes a URL into a cache key.
+     *
+     * Lowercases the scheme and host, drops the fragment and a default port,
+     * and turns an empty path into "/".
+     */
+    static std::string normalizeUrl(const std::string& url);
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const std::string> body;
+        std::string etag;
+        std::string last_modified;
+        std::time_t base_time = 0; // receipt time minus the response's age
+        long lifetime = 0;         // seconds the entry stays fresh
+        bool no_cache = false;     // revalidate on every use
+    };
+
+    using EntryList = std::list<Entry>;
+
+    // Fills freshness fields of an entry from response headers.
+    static void applyHeaders(Entry& entry, const CacheHeaders& headers, std::time_t now);
+    void evict();
+
+    size_t capacity_bytes_;
+    size_t size_bytes_ = 0;
+    EntryList entries_; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index_;
+    mutable std::mutex mutex_;
+};
+
+#endif // HTTP_CACHE_H
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file image_cache.cpp
+ * @brief Implements the decoded image cache.
+ */
+#include "image_cache.h"
+#include <functional>
+#include "hash_combine.h"
+
+size_t ImageCache::KeyHash::operator()(const ImageKey& key) const {
+    size_t hash = std::hash<std::string>()(key.source);
+    hashCombine(hash, static_cast<size_t>(key.source_size));
+    hashCombine(hash, static_cast<size_t>(key.width));
+    hashCombine(hash, static_cast<size_t>(key.height));
+    hashCombine(hash, std::hash<qreal>()(key.device_pixel_ratio));
+    return hash;
+}
+
+ImageCache& ImageCache::instance() {
+    static ImageCache cache;
+    return cache;
+}
+
+ImageCache::ImageCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+size_t ImageCache::costOf(const QPixmap& pixmap) {
+    const size_t depth = pixmap.depth() > 0 ? static_cast<size_t>(pixmap.depth()) : 32;
+    return static_cast<size_t>(pixmap.width()) * static_cast<size_t>(pixmap.height()) * depth / 8;
+}
+
+bool ImageCache::find(const ImageKey& key, QPixmap* pixmap) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return false;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    if (pixmap) *pixmap = it->second->pixmap;
+    return true;
+}
+
+void ImageCache::insert(const ImageKey& key, const QPixmap& pixmap) {
+    const size_t cost = costOf(pixmap);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        size_bytes_ -= it->second->cost;
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+    if (pixmap.isNull() || cost > capacity_bytes_) return;
+    entries_.push_front(Entry{key, pixmap, cost});
+    index_[key] = entries_.begin();
+    size_bytes_ += cost;
+    evict();
+}
+
+void ImageCache::setCapacity(size_t capacity_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_bytes_ = capacity_bytes;
+    evict();
+}
+
+size_t ImageCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_bytes_;
+}
+
+void ImageCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    size_bytes_ = 0;
+}
+
+ImageCacheStats ImageCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ImageCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = entries_.size();
+    stats.bytes = size_bytes_;
+    return stats;
+}
+
+void ImageCache::evict() {
+    while (size_bytes_ > capacity_bytes_ && !entries_.empty()) {
+        const Entry& victim = entries_.back();
+        size_bytes_ -= victim.cost;
+        index_.erase(victim.key);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
\ No newline at end of file
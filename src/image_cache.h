@@ -0,0 +1,123 @@
+/**
+ * @file image_cache.h
+ * @brief Defines the process-wide cache of decoded, scaled images.
+ */
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <QPixmap>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Identifies one decoded rendition of an image.
+ *
+ * The same resource drawn at another size or pixel ratio is another entry.
+ */
+struct ImageKey {
+    std::string source;       // resolved URL or file path of the encoded image
+    uint64_t source_size = 0; // encoded size, so a changed resource misses
+    int width = -1;           // requested width, -1 if not given
+    int height = -1;          // requested height, -1 if not given
+    qreal device_pixel_ratio = 1.0;
+
+    bool operator==(const ImageKey& other) const {
+        return source_size == other.source_size && width == other.width && height == other.height &&
+               device_pixel_ratio == other.device_pixel_ratio && source == other.source;
+    }
+};
+
+/**
+ * @brief Hit and occupancy counters of an ImageCache.
+ */
+struct ImageCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0; // estimated pixel memory of the cached pixmaps
+};
+
+/**
+ * @class ImageCache
+ * @brief Keeps decoded pixmaps so tabs showing the same image share one copy.
+ *
+ * QPixmap is implicitly shared, so a hit hands out a reference to the cached
+ * pixels rather than a copy. Entries are evicted least recently used once
+ * their pixel memory exceeds the cap. Thread-safe, though pixmaps themselves
+ * should only be created and drawn on the GUI thread.
+ */
+class ImageCache {
+public:
+    /**
+     * @brief Returns the cache shared by every tab of the process.
+     */
+    static ImageCache& instance();
+
+    /**
+     * @brief Creates a cache.
+     * @param capacity_bytes Pixel memory kept before evicting.
+     */
+    explicit ImageCache(size_t capacity_bytes = 64u << 20);
+
+    /**
+     * @brief Looks up a rendition and marks it recently used.
+     * @param key Rendition to find.
+     * @param pixmap Receives the shared pixmap on a hit.
+     * @return True on a hit.
+     */
+    bool find(const ImageKey& key, QPixmap* pixmap);
+
+    /**
+     * @brief Adds or replaces a rendition; pixmaps larger than the cap are not kept.
+     */
+    void insert(const ImageKey& key, const QPixmap& pixmap);
+
+    /**
+     * @brief Changes the cap, evicting at once if needed.
+     */
+    void setCapacity(size_t capacity_bytes);
+    size_t capacity() const;
+
+    /**
+     * @brief Drops every entry; counters are kept.
+     */
+    void clear();
+
+    ImageCacheStats stats() const;
+
+    /**
+     * @brief Returns the pixel memory a pixmap is charged for.
+     */
+    static size_t costOf(const QPixmap& pixmap);
+
+private:
+    struct KeyHash {
+        size_t operator()(const ImageKey& key) const;
+    };
+
+    struct Entry {
+        ImageKey key;
+        QPixmap pixmap;
+        size_t cost;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void evict();
+
+    size_t capacity_bytes_;
+    size_t size_bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    EntryList entries_; // most recently used first
+    std::unordered_map<ImageKey, EntryList::iterator, KeyHash> index_;
+    mutable std::mutex mutex_;
+};
+
+#endif // IMAGE_CACHE_H
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file image_decoder.cpp
+ * @brief Implements worker-pool image decoding.
+ */
+#include "image_decoder.h"
+#include <QBuffer>
+#include <QByteArray>
+#include <QImageReader>
+#include <QPainter>
+#include <QPointer>
+#include <QRunnable>
+#include <QSvgRenderer>
+#include <QThreadPool>
+#include <utility>
+#include "trace.h"
+
+namespace {
+
+std::atomic<QThreadPool*> decode_pool{nullptr};
+
+QByteArray rawBytes(const MediaBuffer& media) {
+    return QByteArray::fromRawData(media.data(), static_cast<int>(media.size()));
+}
+
+QImage rasterizeSvg(const DecodeRequest& request) {
+    QSvgRenderer svg_renderer;
+    if (request.media) {
+        svg_renderer.load(rawBytes(*request.media));
+    } else {
+        svg_renderer.load(QString::fromStdString(request.path));
+    }
+    if (!svg_renderer.isValid()) return QImage();
+    const QSize size = request.target.isValid() ? request.target : svg_renderer.defaultSize();
+    if (size.isEmpty()) return QImage();
+    QImage image(size.width(), size.height(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    svg_renderer.render(&painter);
+    return image;
+}
+
+class DecodeTask : public QRunnable {
+public:
+    DecodeTask(DecodeGroupPtr group, DecodeRequest request, QObject* receiver,
+               std::function<void(const QImage&)> done)
+        : group_(std::move(group)), request_(std::move(request)), receiver_(receiver), done_(std::move(done)) {}
+
+    void run() override {
+        if (group_->isCancelled()) return;
+        TimelineTabScope tab(group_->timelineTab());
+        QImage image;
+        {
+            TimelineSpan span("decode", "image", request_.media ? request_.media->source() : request_.path);
+            image = decodeImage(request_);
+        }
+        if (group_->isCancelled()) return;
+        DecodeGroupPtr group = group_;
+        std::function<void(const QImage&)> done = std::move(done_);
+        postToGuiThread(receiver_, [group, done, image](QObject*) {
+            if (!group->isCancelled()) done(image);
+        });
+    }
+
+private:
+    DecodeGroupPtr group_;
+    DecodeRequest request_;
+    QPointer<QObject> receiver_;
+    std::function<void(const QImage&)> done_;
+};
+
+} // namespace
+
+QSize imageSize(const DecodeRequest& request) {
+    if (request.media) {
+        QByteArray bytes = rawBytes(*request.media);
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::ReadOnly);
+        return QImageReader(&buffer).size();
+    }
+    return QImageReader(QString::fromStdString(request.path)).size();
+}
+
+QImage decodeImage(const DecodeRequest& request) {
+    if (request.svg) return rasterizeSvg(request);
+
+    QByteArray bytes;
+    QBuffer buffer;
+    QImageReader reader;
+    if (request.media) {
+        bytes = rawBytes(*request.media);
+        buffer.setData(bytes);
+        buffer.open(QIODevice::ReadOnly);
+        reader.setDevice(&buffer);
+    } else {
+        reader.setFileName(QString::fromStdString(request.path));
+    }
+    if (request.target.isValid()) reader.setScaledSize(request.target);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        QUICKDOM_TRACE_WARN("Failed to decode image", request.media ? request.media->source() : request.path);
+    }
+    return image;
+}
+
+void decodeAsync(const DecodeGroupPtr& group, DecodeRequest request, QObject* receiver,
+                 std::function<void(const QImage&)> done) {
+    QThreadPool* pool = decode_pool.load(std::memory_order_relaxed);
+    if (!pool) pool = QThreadPool::globalInstance();
+    pool->start(new DecodeTask(group, std::move(request), receiver, std::move(done)));
+}
+
+void setDecodePool(QThreadPool* pool) {
+    decode_pool.store(pool, std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file image_decoder.h
+ * @brief Defines image decoding on a worker pool with delivery to the GUI thread.
+ */
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include "media_buffer.h"
+#include "timeline.h"
+#include <QCoreApplication>
+#include <QImage>
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+#include <QSize>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+class QThreadPool;
+
+/**
+ * @brief One image to decode, from fetched bytes or from a file.
+ */
+struct DecodeRequest {
+    MediaBufferPtr media;     // encoded bytes; kept alive until the decode ends
+    std::string path;         // read instead when media is null
+    bool svg = false;         // rasterize as SVG rather than decode
+    QSize target;             // output size in device pixels; invalid keeps the natural size
+};
+
+/**
+ * @brief Cancellation token shared by the decodes of one page.
+ *
+ * Cancelling skips decodes that have not started and drops the results of
+ * those in flight.
+ */
+class DecodeGroup {
+public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    // Tab the decodes are tagged with on the timeline; set before the first decode.
+    void setTimelineTab(uint64_t tab) { timeline_tab_ = tab; }
+    uint64_t timelineTab() const { return timeline_tab_; }
+
+private:
+    std::atomic<bool> cancelled_{false};
+    uint64_t timeline_tab_ = kNoTimelineTab;
+};
+
+using DecodeGroupPtr = std::shared_ptr<DecodeGroup>;
+
+/**
+ * @brief Reads the natural size of an image from its header without decoding it.
+ * @return The size, or an invalid size if the format is not recognized.
+ */
+QSize imageSize(const DecodeRequest& request);
+
+/**
+ * @brief Decodes an image at its target size; safe on any thread.
+ *
+ * Raster formats are decoded with QImageReader straight to the target size,
+ * which for JPEG skips most of the work; SVG is rendered into a QImage.
+ * @return The image, or a null image on failure.
+ */
+QImage decodeImage(const DecodeRequest& request);
+
+/**
+ * @brief Decodes an image on the global thread pool.
+ *
+ * done runs on the GUI thread with the image (null on failure), unless the
+ * group was cancelled or receiver was destroyed in the meantime.
+ * @param group Cancellation token of the page.
+ * @param request Image to decode.
+ * @param receiver Object the result is for, typically the placeholder widget.
+ * @param done Receives the decoded image.
+ */
+void decodeAsync(const DecodeGroupPtr& group, DecodeRequest request, QObject* receiver,
+                 std::function<void(const QImage&)> done);
+
+/**
+ * @brief Sets the pool decodeAsync() runs on; the global pool by default.
+ */
+void setDecodePool(QThreadPool* pool);
+
+/**
+ * @brief Runs fn on the GUI thread, unless receiver is destroyed first.
+ *
+ * May be called from any thread. The call is posted to the application
+ * object, which outlives any receiver, and receiver is checked once back on
+ * the GUI thread. Does nothing if there is no application.
+ * @param receiver Object the call is for.
+ * @param fn Called with the receiver.
+ */
+template <typename T, typename Fn>
+void postToGuiThread(QPointer<T> receiver, Fn fn) {
+    QCoreApplication* app = QCoreApplication::instance();
+    if (!app) return;
+    QMetaObject::invokeMethod(app, [receiver, fn]() {
+        if (!receiver.isNull()) fn(receiver.data());
+    }, Qt::QueuedConnection);
+}
+
+#endif // IMAGE_DECODER_H
\ No newline at end of file
@@ -0,0 +1,21 @@
+/**
+ * @file json_text.h
+ * @brief Defines escaping of text into JSON string literals.
+ */
+#ifndef JSON_TEXT_H
+#define JSON_TEXT_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Appends text as a quoted JSON string.
+ *
+ * Quotes, backslashes and control characters are escaped. Valid UTF-8 is
+ * copied as is; bytes that are not part of a valid sequence, as in
+ * attribute values of Latin-1 pages, are read as Latin-1 and written as
+ * \\u00XX, so the output is always valid JSON.
+ */
+void appendJsonString(std::string& out, std::string_view text);
+
+#endif // JSON_TEXT_H
\ No newline at end of file
@@ -3,11 +3,173 @@
  * @brief Entry point for QuickDOM browser.
  */
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QThreadPool>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "batch_runner.h"
 #include "browser_window.h"
+#include "image_cache.h"
+#include "timeline.h"
+#include "trace.h"
+
+namespace {
+
+// Whether the command line asks for batch mode, checked before Qt starts.
+bool batchRequested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0) return true;
+    }
+    return false;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
+    // Batch mode renders without a window, so it must not need a display.
+    const bool batch = batchRequested(argc, argv);
+    if (batch && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
     QApplication app(argc, argv);
-    BrowserWindow window;
+
+    QCommandLineParser options;
+    options.addHelpOption();
+    QCommandLineOption parser_option("parser",
+        "HTML parser: auto, scalar, sse2, avx2, avx512 or neon (overrides QUICKDOM_PARSER).",
+        "name", "auto");
+    options.addOption(parser_option);
+    QCommandLineOption tab_memory_option("tab-memory",
+        "Memory the open tabs may use before the least recently used are hibernated.",
+        "MiB", "512");
+    options.addOption(tab_memory_option);
+    QCommandLineOption image_margin_option("image-margin",
+        "Distance from the visible area at which lazy images are fetched.",
+        "pixels", QString::number(PageView::kDefaultLazyMargin));
+    options.addOption(image_margin_option);
+    QCommandLineOption batch_option("batch",
+        "Load the pages given as arguments or in --input without a window and write one JSON line per page.");
+    options.addOption(batch_option);
+    QCommandLineOption input_option("input", "Batch: file listing one URL or path per line, - for stdin.", "file");
+    options.addOption(input_option);
+    QCommandLineOption output_option("output", "Batch: file to write the records to instead of stdout.", "file");
+    options.addOption(output_option);
+    QCommandLineOption threads_option("threads", "Batch: worker threads, 0 for one per core.", "count", "0");
+    options.addOption(threads_option);
+    QCommandLineOption render_option("render", "Batch: also build and lay out each page's display list.");
+    options.addOption(render_option);
+    QCommandLineOption dom_option("dom", "Batch: include the element tree in each record.");
+    options.addOption(dom_option);
+    QCommandLineOption all_images_option("all-images", "Batch: fetch every image, not only loading=\"eager\" ones.");
+    options.addOption(all_images_option);
+    QCommandLineOption width_option("width", "Batch: layout width for --render.", "pixels", "800");
+    options.addOption(width_option);
+    QCommandLineOption timeline_option("timeline",
+        "Record a page-load timeline from startup and write it as Chrome trace-event JSON on exit. "
+        "In the browser, Ctrl+Shift+E stops and writes a recording, or starts a new one.",
+        "file");
+    options.addOption(timeline_option);
+    options.addPositionalArgument("pages", "Batch: URLs or paths to load.", "[pages...]");
+    options.process(app);
+
+    ParserKind parser_kind = ParserKind::Auto;
+    if (!parserKindFromName(options.value(parser_option).toStdString(), parser_kind)) {
+        std::cerr << "Unknown parser: " << options.value(parser_option).toStdString() << "\n";
+        return 1;
+    }
+    parser_kind = resolveParserKind(parser_kind);
+    QUICKDOM_TRACE_INFO("Using parser", parserKindName(parser_kind));
+
+    bool valid_budget = false;
+    const qulonglong tab_memory_mib = options.value(tab_memory_option).toULongLong(&valid_budget);
+    if (!valid_budget) {
+        std::cerr << "Invalid tab memory: " << options.value(tab_memory_option).toStdString() << "\n";
+        return 1;
+    }
+    bool valid_margin = false;
+    const int image_margin = options.value(image_margin_option).toInt(&valid_margin);
+    if (!valid_margin || image_margin < 0) {
+        std::cerr << "Invalid image margin: " << options.value(image_margin_option).toStdString() << "\n";
+        return 1;
+    }
+
+    if (batch) {
+        BatchOptions batch_options;
+        bool valid_threads = false;
+        batch_options.threads = options.value(threads_option).toInt(&valid_threads);
+        bool valid_width = false;
+        batch_options.width = options.value(width_option).toInt(&valid_width);
+        if (!valid_threads || batch_options.threads < 0 || !valid_width || batch_options.width <= 0) {
+            std::cerr << "Invalid --threads or --width\n";
+            return 1;
+        }
+        batch_options.render = options.isSet(render_option);
+        batch_options.dom = options.isSet(dom_option);
+        batch_options.lazy_images = !options.isSet(all_images_option);
+
+        std::vector<std::string> urls;
+        if (options.isSet(input_option)) {
+            const std::string input = options.value(input_option).toStdString();
+            std::ifstream file;
+            if (input != "-") {
+                file.open(input);
+                if (!file) {
+                    std::cerr << "Cannot read page list: " << input << "\n";
+                    return 1;
+                }
+            }
+            urls = readBatchList(input == "-" ? std::cin : file);
+        }
+        for (const QString& page : options.positionalArguments()) urls.push_back(batchUrl(page.toStdString()));
+
+        std::ofstream file;
+        if (options.isSet(output_option)) {
+            file.open(options.value(output_option).toStdString());
+            if (!file) {
+                std::cerr << "Cannot write records: " << options.value(output_option).toStdString() << "\n";
+                return 1;
+            }
+        }
+        std::ostream& out = options.isSet(output_option) ? file : std::cout;
+
+        startTraceFlusher();
+        if (options.isSet(timeline_option)) setTimelineEnabled(true);
+        int status = 0;
+        {
+            Network network;
+            std::unique_ptr<HtmlParser> parser = createParser(parser_kind);
+            BatchRunner runner(network, *parser, out, batch_options);
+            QObject::connect(&runner, &BatchRunner::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+            runner.start(std::move(urls));
+            if (runner.writtenCount() < runner.pageCount()) app.exec();
+            // 2 tells scripts that some pages did not load in full.
+            if (runner.completeCount() < runner.pageCount()) status = 2;
+        }
+        QThreadPool::globalInstance()->waitForDone();
+        ImageCache::instance().clear();
+        if (options.isSet(timeline_option)) {
+            setTimelineEnabled(false);
+            writeTimeline(options.value(timeline_option).toStdString());
+        }
+        stopTraceFlusher();
+        return status;
+    }
+
+    startTraceFlusher();
+    BrowserWindow window(nullptr, parser_kind);
+    window.setTabMemoryBudget(static_cast<size_t>(tab_memory_mib) << 20);
+    window.setLazyImageMargin(image_margin);
+    if (options.isSet(timeline_option)) {
+        window.setTimelinePath(options.value(timeline_option));
+        window.toggleTimeline();
+    }
     window.show();
-    return app.exec();
+    const int status = app.exec();
+    QThreadPool::globalInstance()->waitForDone(); // image decodes still running
+    ImageCache::instance().clear(); // pixmaps must not outlive the application
+    if (timelineEnabled()) { // a recording still running when the window closed
+        setTimelineEnabled(false);
+        writeTimeline(window.timelinePath().toStdString());
+    }
+    stopTraceFlusher();
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+ * @file media_buffer.cpp
+ * @brief Implements media buffers over owned or mapped bytes.
+ */
+#include "media_buffer.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include "trace.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define QUICKDOM_MEDIA_MMAP 1
+#endif
+
+MediaBufferPtr MediaBuffer::fromBytes(std::string bytes, std::string content_type, std::string source) {
+    std::shared_ptr<MediaBuffer> buffer(new MediaBuffer());
+    buffer->owned_ = std::move(bytes);
+    buffer->data_ = buffer->owned_.data();
+    buffer->size_ = buffer->owned_.size();
+    buffer->content_type_ = std::move(content_type);
+    buffer->source_ = std::move(source);
+    return buffer;
+}
+
+MediaBufferPtr MediaBuffer::map(const std::string& path, std::string content_type, std::string source) {
+#if defined(QUICKDOM_MEDIA_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st {};
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        QUICKDOM_TRACE_WARN("Failed to map media", path);
+        return nullptr;
+    }
+    std::shared_ptr<MediaBuffer> buffer(new MediaBuffer());
+    buffer->mapping_ = mapping;
+    buffer->data_ = static_cast<const char*>(mapping);
+    buffer->size_ = static_cast<size_t>(st.st_size);
+    buffer->content_type_ = std::move(content_type);
+    buffer->source_ = std::move(source);
+    return buffer;
+#else
+    // No mmap: read the file once into memory instead.
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.empty()) return nullptr;
+    return fromBytes(std::move(bytes), std::move(content_type), std::move(source));
+#endif
+}
+
+MediaBuffer::~MediaBuffer() {
+#if defined(QUICKDOM_MEDIA_MMAP)
+    if (mapping_) munmap(mapping_, size_);
+#endif
+}
\ No newline at end of file
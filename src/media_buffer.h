@@ -0,0 +1,76 @@
+/**
+ * @file media_buffer.h
+ * @brief Defines immutable, shared media bytes held in memory or mapped from disk.
+ */
+#ifndef MEDIA_BUFFER_H
+#define MEDIA_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class MediaBuffer;
+
+/**
+ * @brief Shared handle to a media buffer; the bytes live as long as any handle.
+ */
+using MediaBufferPtr = std::shared_ptr<const MediaBuffer>;
+
+/**
+ * @class MediaBuffer
+ * @brief The bytes of one media resource, ready to be decoded in place.
+ *
+ * A buffer either owns a freshly downloaded body or is a read-only view of a
+ * cached file mapped into memory. Either way decoders read data() directly;
+ * nothing is copied or read back from disk.
+ */
+class MediaBuffer {
+public:
+    /**
+     * @brief Wraps a downloaded body.
+     * @param bytes Body; moved into the buffer.
+     * @param content_type Response content type, possibly empty.
+     * @param source URL the bytes came from, identifying the resource.
+     */
+    static MediaBufferPtr fromBytes(std::string bytes, std::string content_type, std::string source = "");
+
+    /**
+     * @brief Maps a file read-only.
+     *
+     * The mapping stays valid if the file is later unlinked or replaced by
+     * rename, which is all the media cache ever does to its files.
+     * @return The buffer, or nullptr if the file is missing or empty.
+     */
+    static MediaBufferPtr map(const std::string& path, std::string content_type, std::string source = "");
+
+    ~MediaBuffer();
+
+    MediaBuffer(const MediaBuffer&) = delete;
+    MediaBuffer& operator=(const MediaBuffer&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& contentType() const { return content_type_; }
+
+    /**
+     * @brief Returns the URL the bytes came from, or empty if unknown.
+     */
+    const std::string& source() const { return source_; }
+
+    /**
+     * @brief Returns true if the bytes are a view of a mapped file.
+     */
+    bool isMapped() const { return mapping_ != nullptr; }
+
+private:
+    MediaBuffer() = default;
+
+    std::string owned_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+    std::string content_type_;
+    std::string source_;
+};
+
+#endif // MEDIA_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,598 @@
+/**
+ * @file media_cache.cpp
+ * @brief Implements the indexed on-disk media cache.
+ */
+#include "media_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "http_cache.h"
+#include "trace.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define QUICKDOM_MEDIA_MMAP 1
+#endif
+
+namespace fs = std::filesystem;
+
+/**
+ * Start of the index file. generation is a sequence lock: writers make it
+ * odd while they change the table and even again when done, so readers in
+ * any process can detect a concurrent change and retry.
+ */
+struct MediaCache::IndexHeader {
+    static constexpr uint64_t kMagic = 0x31584449444d4451ull; // "QDMDIDX1"
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    std::atomic<uint64_t> generation;
+    std::atomic<uint64_t> clock; // logical time of the last access
+    uint64_t total_bytes;
+    uint64_t entry_count;
+    uint64_t reserved[2];
+};
+
+/**
+ * One open-addressing slot. Strings are NUL-padded; values that do not fit
+ * are dropped (validators) or cut at their parameters (content type).
+ */
+struct MediaCache::IndexSlot {
+    uint64_t key_hi;
+    uint64_t key_lo;
+    uint64_t size;
+    std::atomic<uint64_t> last_access;
+    uint32_t used;
+    char content_type[44];
+    char etag[64];
+    char last_modified[40];
+
+    void assign(const IndexSlot& other) {
+        key_hi = other.key_hi;
+        key_lo = other.key_lo;
+        size = other.size;
+        last_access.store(other.last_access.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        used = other.used;
+        std::memcpy(content_type, other.content_type, sizeof(content_type));
+        std::memcpy(etag, other.etag, sizeof(etag));
+        std::memcpy(last_modified, other.last_modified, sizeof(last_modified));
+    }
+
+    void clear() {
+        key_hi = key_lo = size = 0;
+        last_access.store(0, std::memory_order_relaxed);
+        used = 0;
+        std::memset(content_type, 0, sizeof(content_type));
+        std::memset(etag, 0, sizeof(etag));
+        std::memset(last_modified, 0, sizeof(last_modified));
+    }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "index atomics must work across processes");
+static_assert(sizeof(MediaCache::Key) == 16, "keys are 128 bits");
+
+namespace {
+
+constexpr int kReaderSpins = 1000; // retries before a reader gives up and misses
+
+uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+// Little-endian load, so keys do not depend on the host byte order.
+uint64_t load64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+// MurmurHash3_x64_128 (Austin Appleby, public domain)
+void murmur3_128(const void* key, size_t len, uint32_t seed, uint64_t& out1, uint64_t& out2) {
+    const uint8_t* data = static_cast<const uint8_t*>(key);
+    const size_t nblocks = len / 16;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    const uint64_t c1 = 0x87c37b91114253d5ull;
+    const uint64_t c2 = 0x4cf5ad432745937full;
+
+    for (size_t i = 0; i < nblocks; ++i) {
+        uint64_t k1 = load64(data + i * 16);
+        uint64_t k2 = load64(data + i * 16 + 8);
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = data + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    switch (len & 15) {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8; [[fallthrough]];
+        case 9:
+            k2 ^= static_cast<uint64_t>(tail[8]);
+            k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            [[fallthrough]];
+        case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+        case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+        case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+        case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+        case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+        case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+        case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8; [[fallthrough]];
+        case 1:
+            k1 ^= static_cast<uint64_t>(tail[0]);
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    out1 = h1;
+    out2 = h2;
+}
+
+// Copies a string into a fixed field; returns false if it does not fit.
+template <size_t N>
+bool storeField(char (&field)[N], const std::string& value) {
+    std::memset(field, 0, N);
+    if (value.size() >= N) return false;
+    std::memcpy(field, value.data(), value.size());
+    return true;
+}
+
+template <size_t N>
+std::string loadField(const char (&field)[N]) {
+    return std::string(field, strnlen(field, N));
+}
+
+// Cached files are <32 hex digits>.media, downloads in flight <...>.tmp.
+bool isCacheFileName(const std::string& name) {
+    const size_t dot = name.find('.');
+    if (dot != 32) return false;
+    for (size_t i = 0; i < dot; ++i) {
+        if (!std::isxdigit(static_cast<unsigned char>(name[i]))) return false;
+    }
+    const std::string suffix = name.substr(dot);
+    return suffix == ".media" || suffix == ".tmp";
+}
+
+} // namespace
+
+/**
+ * Exclusive access to the index: the in-process mutex, the file lock shared
+ * with other processes, and an odd generation for the duration.
+ */
+class MediaCache::WriteLock {
+public:
+    explicit WriteLock(MediaCache& cache) : cache_(cache), lock_(cache.mutex_) {
+#if defined(QUICKDOM_MEDIA_MMAP)
+        if (cache_.fd_ >= 0) flock(cache_.fd_, LOCK_EX);
+#endif
+        if (cache_.header_->generation.load(std::memory_order_relaxed) & 1) {
+            // A writer died halfway through an update.
+            QUICKDOM_TRACE_WARN("Resetting inconsistent media index", cache_.directory_);
+            cache_.resetIndex();
+        }
+        generation_ = cache_.header_->generation.load(std::memory_order_relaxed);
+        cache_.header_->generation.store(generation_ + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~WriteLock() {
+        cache_.header_->generation.store(generation_ + 2, std::memory_order_release);
+#if defined(QUICKDOM_MEDIA_MMAP)
+        if (cache_.fd_ >= 0) flock(cache_.fd_, LOCK_UN);
+#endif
+    }
+
+private:
+    MediaCache& cache_;
+    std::unique_lock<std::shared_mutex> lock_;
+    uint64_t generation_ = 0;
+};
+
+std::string MediaCache::Key::hex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        text[15 - i] = digits[(hi >> (i * 4)) & 0xf];
+        text[31 - i] = digits[(lo >> (i * 4)) & 0xf];
+    }
+    return text;
+}
+
+MediaCache::MediaCache(std::string directory, uint64_t budget_bytes, uint32_t slot_count)
+    : directory_(std::move(directory)), budget_bytes_(budget_bytes), requested_slots_(16) {
+    while (requested_slots_ < slot_count && requested_slots_ < (1u << 30)) requested_slots_ <<= 1;
+    std::random_device random;
+    temp_nonce_ = (static_cast<uint64_t>(random()) << 32) ^ random();
+}
+
+MediaCache::~MediaCache() {
+    // Finish queued writes; their bodies exist nowhere else.
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_changed_.notify_all();
+    if (writer_.joinable()) writer_.join();
+#if defined(QUICKDOM_MEDIA_MMAP)
+    if (mapped_) munmap(region_, region_bytes_);
+    if (fd_ >= 0) close(fd_);
+#endif
+    if (!mapped_) std::free(region_);
+}
+
+MediaCache::Key MediaCache::keyFor(const std::string& url) {
+    const std::string normalized = HttpCache::normalizeUrl(url);
+    Key key;
+    murmur3_128(normalized.data(), normalized.size(), 0, key.hi, key.lo);
+    return key;
+}
+
+std::string MediaCache::pathFor(const Key& key) const {
+    return directory_ + "/" + key.hex() + ".media";
+}
+
+void MediaCache::ensureOpen() {
+    std::call_once(opened_, [this] { open(); });
+}
+
+void MediaCache::open() {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    uint32_t slot_count = requested_slots_;
+    bool fresh = true;
+
+#if defined(QUICKDOM_MEDIA_MMAP)
+    fd_ = ::open((directory_ + "/index.bin").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ >= 0) {
+        flock(fd_, LOCK_EX);
+        // Reuse an existing index with its own capacity if it is intact.
+        struct {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t slot_count;
+        } existing{};
+        struct stat st {};
+        if (fstat(fd_, &st) == 0 &&
+            pread(fd_, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing)) &&
+            existing.magic == IndexHeader::kMagic && existing.version == IndexHeader::kVersion &&
+            existing.slot_count >= 16 && (existing.slot_count & (existing.slot_count - 1)) == 0 &&
+            static_cast<uint64_t>(st.st_size) ==
+                sizeof(IndexHeader) + static_cast<uint64_t>(existing.slot_count) * sizeof(IndexSlot)) {
+            slot_count = existing.slot_count;
+            fresh = false;
+        }
+        region_bytes_ = sizeof(IndexHeader) + static_cast<size_t>(slot_count) * sizeof(IndexSlot);
+        if (fresh && (ftruncate(fd_, 0) != 0 || ftruncate(fd_, static_cast<off_t>(region_bytes_)) != 0)) {
+            region_bytes_ = 0;
+        }
+        void* region = region_bytes_ ? mmap(nullptr, region_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+                                     : MAP_FAILED;
+        if (region != MAP_FAILED) {
+            region_ = region;
+            mapped_ = true;
+        }
+        if (!mapped_) {
+            QUICKDOM_TRACE_WARN("Media index not mapped; using a private index", directory_);
+            flock(fd_, LOCK_UN);
+            close(fd_);
+            fd_ = -1;
+            slot_count = requested_slots_;
+            fresh = true;
+        }
+    }
+#endif
+
+    if (!region_) {
+        region_bytes_ = sizeof(IndexHeader) + static_cast<size_t>(slot_count) * sizeof(IndexSlot);
+        region_ = std::calloc(1, region_bytes_);
+        if (!region_) throw std::bad_alloc();
+    }
+    header_ = static_cast<IndexHeader*>(region_);
+    slots_ = reinterpret_cast<IndexSlot*>(static_cast<char*>(region_) + sizeof(IndexHeader));
+    mask_ = slot_count - 1;
+    if (fresh) {
+        header_->slot_count = slot_count;
+        resetIndex();
+    }
+
+#if defined(QUICKDOM_MEDIA_MMAP)
+    if (fd_ >= 0) flock(fd_, LOCK_UN);
+#endif
+    QUICKDOM_TRACE_DEBUG("Opened media index", directory_, fresh ? " (new)" : "", " with ", header_->entry_count,
+                         " entries");
+}
+
+void MediaCache::resetIndex() {
+    // Keep the generation moving forward so no reader mistakes the reset for no change.
+    const uint64_t generation = (header_->generation.load(std::memory_order_relaxed) | 1) + 1;
+    const uint32_t slot_count = header_->slot_count;
+    header_->magic = IndexHeader::kMagic;
+    header_->version = IndexHeader::kVersion;
+    header_->generation.store(generation, std::memory_order_relaxed);
+    header_->clock.store(0, std::memory_order_relaxed);
+    header_->total_bytes = 0;
+    header_->entry_count = 0;
+    for (uint32_t i = 0; i < slot_count; ++i) slots_[i].clear();
+
+    // Files of a lost index can no longer be found; reclaim their space.
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (isCacheFileName(it->path().filename().string())) fs::remove(it->path(), ec);
+    }
+}
+
+uint64_t MediaCache::tick() {
+    return header_->clock.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+MediaCache::IndexSlot* MediaCache::findSlot(const Key& key) const {
+    uint32_t i = static_cast<uint32_t>(key.lo) & mask_;
+    for (uint32_t probes = 0; probes <= mask_; ++probes, i = (i + 1) & mask_) {
+        IndexSlot& slot = slots_[i];
+        if (!slot.used) return nullptr;
+        if (slot.key_hi == key.hi && slot.key_lo == key.lo) return &slot;
+    }
+    return nullptr;
+}
+
+void MediaCache::eraseSlot(IndexSlot* slot) {
+    header_->total_bytes -= std::min(header_->total_bytes, slot->size);
+    --header_->entry_count;
+    // Backward-shift deletion keeps every probe sequence unbroken without tombstones.
+    uint32_t hole = static_cast<uint32_t>(slot - slots_);
+    for (uint32_t next = (hole + 1) & mask_; slots_[next].used; next = (next + 1) & mask_) {
+        const uint32_t home = static_cast<uint32_t>(slots_[next].key_lo) & mask_;
+        const bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            slots_[hole].assign(slots_[next]);
+            hole = next;
+        }
+    }
+    slots_[hole].clear();
+}
+
+void MediaCache::evictFor(const Key& keep) {
+    const uint64_t budget = budget_bytes_.load(std::memory_order_relaxed);
+    const uint64_t max_entries = (static_cast<uint64_t>(mask_) + 1) * 3 / 4;
+    if (header_->total_bytes <= budget && header_->entry_count <= max_entries) return;
+
+    // Evict down to 90% so the next few commits do not rescan the table.
+    const uint64_t byte_target = budget / 10 * 9;
+    const uint64_t entry_target = max_entries / 10 * 9;
+    std::vector<std::pair<uint64_t, Key>> candidates;
+    candidates.reserve(header_->entry_count);
+    for (uint32_t i = 0; i <= mask_; ++i) {
+        const IndexSlot& slot = slots_[i];
+        if (!slot.used || (slot.key_hi == keep.hi && slot.key_lo == keep.lo)) continue;
+        candidates.push_back({slot.last_access.load(std::memory_order_relaxed), Key{slot.key_hi, slot.key_lo}});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t evicted = 0;
+    std::error_code ec;
+    for (const auto& candidate : candidates) {
+        if (header_->total_bytes <= byte_target && header_->entry_count <= entry_target) break;
+        IndexSlot* slot = findSlot(candidate.second);
+        if (!slot) continue;
+        fs::remove(pathFor(candidate.second), ec);
+        eraseSlot(slot);
+        ++evicted;
+    }
+    QUICKDOM_TRACE_DEBUG("Evicted media", evicted, " files, ", header_->total_bytes, " bytes remain");
+}
+
+bool MediaCache::lookup(const std::string& url, MediaEntry* entry) {
+    ensureOpen();
+    const Key key = keyFor(url);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (int spin = 0; spin < kReaderSpins; ++spin) {
+        const uint64_t generation = header_->generation.load(std::memory_order_acquire);
+        if (generation & 1) {
+            std::this_thread::yield(); // another process is writing
+            continue;
+        }
+        MediaEntry found;
+        IndexSlot* slot = findSlot(key);
+        if (slot && entry) {
+            found.size = slot->size;
+            found.content_type = loadField(slot->content_type);
+            found.etag = loadField(slot->etag);
+            found.last_modified = loadField(slot->last_modified);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->generation.load(std::memory_order_relaxed) != generation) continue;
+        if (!slot) return false;
+        slot->last_access.store(tick(), std::memory_order_relaxed);
+        if (entry) {
+            *entry = std::move(found);
+            entry->path = pathFor(key);
+        }
+        return true;
+    }
+    return false;
+}
+
+std::string MediaCache::tempPath() {
+    ensureOpen();
+    const Key unique{temp_nonce_, temp_counter_.fetch_add(1, std::memory_order_relaxed)};
+    return directory_ + "/" + unique.hex() + ".tmp";
+}
+
+std::string MediaCache::commit(const std::string& url, const std::string& temp_path, const std::string& content_type,
+                               const std::string& etag, const std::string& last_modified) {
+    ensureOpen();
+    const Key key = keyFor(url);
+    const std::string path = pathFor(key);
+    std::error_code ec;
+    const uint64_t size = fs::file_size(temp_path, ec);
+    if (ec) {
+        QUICKDOM_TRACE_WARN("Missing media download", temp_path);
+        return "";
+    }
+
+    WriteLock lock(*this);
+    fs::rename(temp_path, path, ec); // atomic: readers see the old file or the new one
+    if (ec) {
+        QUICKDOM_TRACE_ERROR("Failed to store media", path, ": ", ec.message());
+        fs::remove(temp_path, ec);
+        return "";
+    }
+
+    IndexSlot* slot = findSlot(key);
+    if (slot) {
+        header_->total_bytes -= std::min(header_->total_bytes, slot->size);
+        --header_->entry_count;
+    } else {
+        // Probe to the first free slot; the table is never more than 3/4 full.
+        uint32_t i = static_cast<uint32_t>(key.lo) & mask_;
+        while (slots_[i].used) i = (i + 1) & mask_;
+        slot = &slots_[i];
+    }
+    slot->key_hi = key.hi;
+    slot->key_lo = key.lo;
+    slot->size = size;
+    slot->last_access.store(tick(), std::memory_order_relaxed);
+    slot->used = 1;
+    // Parameters such as charset are not needed to decode media.
+    std::string type = content_type.substr(0, content_type.find(';'));
+    while (!type.empty() && type.back() == ' ') type.pop_back();
+    storeField(slot->content_type, type);
+    storeField(slot->etag, etag);
+    storeField(slot->last_modified, last_modified);
+    header_->total_bytes += size;
+    ++header_->entry_count;
+
+    // The new entry stays even if it alone exceeds the budget; it goes first next time.
+    evictFor(key);
+    return path;
+}
+
+std::string MediaCache::store(const std::string& url, const MediaBuffer& buffer, const std::string& etag,
+                              const std::string& last_modified) {
+    const std::string temp_path = tempPath();
+    {
+        std::ofstream file(temp_path, std::ios::binary);
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            QUICKDOM_TRACE_ERROR("Failed to write media", temp_path);
+            file.close();
+            std::error_code ec;
+            fs::remove(temp_path, ec);
+            return "";
+        }
+    }
+    return commit(url, temp_path, buffer.contentType(), etag, last_modified);
+}
+
+void MediaCache::storeAsync(const std::string& url, MediaBufferPtr buffer, std::string etag,
+                            std::string last_modified) {
+    if (!buffer) return;
+    const Key key = keyFor(url);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending_[key] = buffer;
+        queue_.push_back({url, key, std::move(buffer), std::move(etag), std::move(last_modified)});
+        if (!writer_.joinable()) writer_ = std::thread([this] { writerLoop(); });
+    }
+    queue_changed_.notify_all();
+}
+
+MediaBufferPtr MediaCache::pending(const std::string& url) {
+    const Key key = keyFor(url);
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    auto it = pending_.find(key);
+    return it != pending_.end() ? it->second : nullptr;
+}
+
+void MediaCache::flush() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_changed_.wait(lock, [this] { return queue_.empty() && writing_ == 0; });
+}
+
+void MediaCache::writerLoop() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        queue_changed_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return; // stopping, and everything is written
+        PendingStore job = std::move(queue_.front());
+        queue_.pop_front();
+        ++writing_;
+        lock.unlock();
+        store(job.url, *job.buffer, job.etag, job.last_modified);
+        lock.lock();
+        --writing_;
+        // A newer body for the same URL may have been queued meanwhile.
+        auto it = pending_.find(job.key);
+        if (it != pending_.end() && it->second == job.buffer) pending_.erase(it);
+        queue_changed_.notify_all();
+    }
+}
+
+void MediaCache::remove(const std::string& url) {
+    ensureOpen();
+    const Key key = keyFor(url);
+    WriteLock lock(*this);
+    IndexSlot* slot = findSlot(key);
+    if (!slot) return;
+    std::error_code ec;
+    fs::remove(pathFor(key), ec);
+    eraseSlot(slot);
+}
+
+void MediaCache::setBudget(uint64_t budget_bytes) {
+    budget_bytes_.store(budget_bytes, std::memory_order_relaxed);
+}
+
+uint64_t MediaCache::budget() const {
+    return budget_bytes_.load(std::memory_order_relaxed);
+}
+
+uint64_t MediaCache::sizeBytes() {
+    ensureOpen();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return header_->total_bytes;
+}
+
+size_t MediaCache::entryCount() {
+    ensureOpen();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return static_cast<size_t>(header_->entry_count);
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+/**
+ * @file media_cache.h
+ * @brief Defines the indexed, size-bounded on-disk media cache.
+ */
+#ifndef MEDIA_CACHE_H
+#define MEDIA_CACHE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "media_buffer.h"
+
+/**
+ * @brief Metadata stored in the index for one cached file.
+ */
+struct MediaEntry {
+    std::string path;          // file holding the body
+    uint64_t size = 0;         // body size in bytes
+    std::string content_type;  // empty if the server sent none
+    std::string etag;          // validators, empty if absent or too long
+    std::string last_modified;
+};
+
+/**
+ * @class MediaCache
+ * @brief Keeps downloaded media files under a byte budget, least recently used first.
+ *
+ * Files are named after a stable 128-bit hash of the normalized URL. Their
+ * metadata lives in a fixed-size hash table in a memory-mapped index file
+ * (index.bin) that persists across runs and is shared by every process
+ * using the same directory, so a hit is answered from memory without any
+ * system call. Writers serialize on a file lock; readers never lock across
+ * processes and retry if a writer changed the index under them.
+ *
+ * Bodies are downloaded into a temporary file and renamed into place on
+ * commit, so a reader never sees a partial file. Committing an entry evicts
+ * the least recently used ones until the cache is back under budget.
+ * Bodies that are already in memory can be persisted in the background
+ * with storeAsync(); until written they are served by pending().
+ * Thread-safe. Without POSIX mmap the index is kept in memory only.
+ */
+class MediaCache {
+public:
+    /**
+     * @brief A stable 128-bit cache key.
+     */
+    struct Key {
+        uint64_t hi = 0;
+        uint64_t lo = 0;
+
+        bool operator==(const Key& other) const { return hi == other.hi && lo == other.lo; }
+
+        /**
+         * @brief Returns the key as 32 lowercase hex digits.
+         */
+        std::string hex() const;
+    };
+
+    /**
+     * @brief Creates a cache; the directory and index are opened on first use.
+     * @param directory Directory holding the index and the cached files.
+     * @param budget_bytes Total size of cached files kept before evicting.
+     * @param slot_count Index capacity; rounded up to a power of two.
+     */
+    explicit MediaCache(std::string directory, uint64_t budget_bytes = 256ull << 20,
+                        uint32_t slot_count = 8192);
+    ~MediaCache();
+
+    MediaCache(const MediaCache&) = delete;
+    MediaCache& operator=(const MediaCache&) = delete;
+
+    /**
+     * @brief Computes the key of a URL.
+     *
+     * MurmurHash3 x64/128 of the normalized URL (see HttpCache::normalizeUrl),
+     * so keys are the same across builds, platforms and processes.
+     */
+    static Key keyFor(const std::string& url);
+
+    /**
+     * @brief Looks up a URL and marks it recently used.
+     * @param url Absolute media URL.
+     * @param entry Receives the metadata on a hit; may be nullptr.
+     * @return True on a hit.
+     */
+    bool lookup(const std::string& url, MediaEntry* entry = nullptr);
+
+    /**
+     * @brief Returns a fresh temporary path in the cache directory to download into.
+     */
+    std::string tempPath();
+
+    /**
+     * @brief Moves a finished download into the cache and indexes it.
+     * @param url Absolute media URL.
+     * @param temp_path File previously returned by tempPath().
+     * @param content_type Response content type.
+     * @param etag Response ETag.
+     * @param last_modified Response Last-Modified.
+     * @return Path of the cached file, or empty if it could not be stored.
+     */
+    std::string commit(const std::string& url, const std::string& temp_path, const std::string& content_type,
+                       const std::string& etag, const std::string& last_modified);
+
+    /**
+     * @brief Writes a body to the cache and indexes it.
+     * @return Path of the cached file, or empty if it could not be stored.
+     */
+    std::string store(const std::string& url, const MediaBuffer& buffer, const std::string& etag,
+                      const std::string& last_modified);
+
+    /**
+     * @brief Queues a body to be stored by a background thread.
+     *
+     * The buffer is shared, not copied; pending() returns it until it is on disk.
+     */
+    void storeAsync(const std::string& url, MediaBufferPtr buffer, std::string etag, std::string last_modified);
+
+    /**
+     * @brief Returns a body queued by storeAsync() that is not yet written, or nullptr.
+     */
+    MediaBufferPtr pending(const std::string& url);
+
+    /**
+     * @brief Waits until every queued body has been written.
+     */
+    void flush();
+
+    /**
+     * @brief Drops a URL and deletes its file.
+     */
+    void remove(const std::string& url);
+
+    /**
+     * @brief Changes the budget; takes effect on the next commit.
+     */
+    void setBudget(uint64_t budget_bytes);
+    uint64_t budget() const;
+
+    /**
+     * @brief Returns the total size of indexed files in bytes.
+     */
+    uint64_t sizeBytes();
+
+    size_t entryCount();
+
+    /**
+     * @brief Returns the path a key is stored at.
+     */
+    std::string pathFor(const Key& key) const;
+
+private:
+    struct IndexHeader;
+    struct IndexSlot;
+    class WriteLock;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const { return static_cast<size_t>(key.lo); }
+    };
+
+    // A body waiting for the background writer
+    struct PendingStore {
+        std::string url;
+        Key key;
+        MediaBufferPtr buffer;
+        std::string etag;
+        std::string last_modified;
+    };
+
+    void writerLoop();
+
+    // Maps the index, creating or resetting it if needed. Called once.
+    void open();
+    void ensureOpen();
+    void resetIndex();
+
+    // Index operations; callers hold the appropriate lock.
+    IndexSlot* findSlot(const Key& key) const;
+    void eraseSlot(IndexSlot* slot);
+    void evictFor(const Key& keep);
+    uint64_t tick();
+
+    std::string directory_;
+    std::atomic<uint64_t> budget_bytes_;
+    uint32_t requested_slots_;
+    std::once_flag opened_;
+
+    void* region_ = nullptr; // header followed by the slots
+    size_t region_bytes_ = 0;
+    bool mapped_ = false;    // region is a shared file mapping
+    int fd_ = -1;            // index file, locked by writers
+    IndexHeader* header_ = nullptr;
+    IndexSlot* slots_ = nullptr;
+    uint32_t mask_ = 0;
+
+    std::shared_mutex mutex_; // orders threads of this process
+    uint64_t temp_nonce_;
+    std::atomic<uint64_t> temp_counter_{0};
+
+    std::mutex queue_mutex_; // guards the writer state below
+    std::condition_variable queue_changed_;
+    std::deque<PendingStore> queue_;
+    std::unordered_map<Key, MediaBufferPtr, KeyHash> pending_;
+    size_t writing_ = 0; // stores taken off the queue but not finished
+    bool stopping_ = false;
+    std::thread writer_; // started by the first storeAsync()
+};
+
+#endif // MEDIA_CACHE_H
\ No newline at end of file
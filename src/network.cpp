@@ -4,26 +4,110 @@
  */
 #include "network.h"
 #include <curl/curl.h>
-#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
 #include <functional>
-#include <filesystem>
-#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "http_cache.h"
+#include "media_cache.h"
+#include "timeline.h"
+#include "trace.h"
 
-namespace fs = std::filesystem;
+// State of one document transfer shared by its libcurl callbacks
+struct DocumentTransfer {
+  CURL* curl;
+  const std::function<void(const char*, size_t)>* sink;
+  const HttpCache* cache;
+  CacheHeaders headers;
+  bool checked = false; // whether the body is worth keeping has been decided
+  bool keep = false;
+  std::string body; // kept for the cache, if it can store the response
+};
 
-// Callback for libcurl data
+// Decides from the response headers, which are complete before the first
+// chunk arrives, whether the cache could store the body.
+void checkCacheable(DocumentTransfer& transfer) {
+  transfer.checked = true;
+  long http_code = 0;
+  curl_easy_getinfo(transfer.curl, CURLINFO_RESPONSE_CODE, &http_code);
+  curl_off_t length = -1;
+  curl_easy_getinfo(transfer.curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+  const size_t announced = length > 0 ? static_cast<size_t>(length) : 0;
+  transfer.keep = transfer.cache->storable(http_code, transfer.headers, announced, std::time(nullptr));
+  if (transfer.keep) transfer.body.reserve(announced);
+}
+
+// Callback for libcurl data; hands each chunk to the caller's sink
 size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-  auto* str = static_cast<std::string*>(userp);
-  str->append(static_cast<char*>(contents), size * nmemb);
+  auto* transfer = static_cast<DocumentTransfer*>(userp);
+  const size_t bytes = size * nmemb;
+  (*transfer->sink)(static_cast<char*>(contents), bytes);
+  if (!transfer->checked) checkCacheable(*transfer);
+  if (transfer->keep && transfer->body.size() + bytes > transfer->cache->capacityBytes()) {
+    // Larger than the whole cache; stop keeping it.
+    transfer->keep = false;
+    std::string().swap(transfer->body);
+  }
+  if (transfer->keep) transfer->body.append(static_cast<char*>(contents), bytes);
+  return bytes;
+}
+
+// Callback for response header lines; records those that matter for caching
+size_t headerCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+  static_cast<CacheHeaders*>(userp)->parseLine(std::string_view(buffer, size * nitems));
+  return size * nitems;
+}
+
+// Callback for collecting a media body in memory
+size_t writeBufferCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+  static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
   return size * nmemb;
 }
 
-// Callback for writing media to file
-size_t writeFileCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-  auto* file = static_cast<std::ofstream*>(userp);
-  size_t total = size * nmemb;
-  file->write(static_cast<char*>(contents), total);
-  return total;
+// Progress callback; aborts the transfer once its control has expired
+int progressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+  return static_cast<const TransferControl*>(clientp)->expired() ? 1 : 0;
+}
+
+// Makes a transfer honour a control: polled for cancellation, timed out at the deadline
+void applyControl(CURL* curl, const TransferControl* control) {
+  if (!control) return;
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, const_cast<TransferControl*>(control));
+  if (control->deadline != std::chrono::steady_clock::time_point::max()) {
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        control->deadline - std::chrono::steady_clock::now());
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(std::max<int64_t>(1, remaining.count())));
+  }
+}
+
+// Records a finished transfer on the timeline, split into its phases by
+// libcurl's own timers. Must run before the handle is reset for reuse.
+void recordTransfer(CURL* curl, uint64_t start_ns, const std::string& url) {
+  if (!timelineEnabled()) return;
+  const uint64_t end_ns = timelineNow();
+  recordTimelineSpan("curl", "net", start_ns, end_ns, url);
+  // Microseconds from the start of the transfer; phases a reused connection skips stay 0.
+  curl_off_t dns = 0, connect = 0, tls = 0, first_byte = 0;
+  curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+  curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+  curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls);
+  curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &first_byte);
+  const auto at = [start_ns, end_ns](curl_off_t us) {
+    return std::min(end_ns, start_ns + static_cast<uint64_t>(us) * 1000);
+  };
+  if (dns > 0) recordTimelineSpan("curl.dns", "net", start_ns, at(dns), url);
+  if (connect > dns) recordTimelineSpan("curl.connect", "net", at(dns), at(connect), url);
+  if (tls > connect) recordTimelineSpan("curl.tls", "net", at(connect), at(tls), url);
+  const curl_off_t sent = std::max(connect, tls);
+  if (first_byte > sent) recordTimelineSpan("curl.wait", "net", at(sent), at(first_byte), url);
+  if (first_byte > 0) recordTimelineSpan("curl.receive", "net", at(first_byte), end_ns, url);
 }
 
 // Resolve relative URL to absolute
@@ -38,79 +122,486 @@ std::string resolveUrl(const std::string& url, const std::string& base_url) {
   return base + url;
 }
 
-std::string Network::fetch(const std::string& url) {
-  CURL* curl = curl_easy_init();
-  std::string response;
-  if (curl) {
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+// A curl multi handle of one thread for one pool. The thread and the pool
+// both hold it; whichever goes first cleans the handle up.
+struct ThreadMulti {
+  std::mutex mutex;
+  CURLM* multi = nullptr;
+
+  void cleanup() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (multi) curl_multi_cleanup(multi);
+    multi = nullptr;
+  }
+};
+
+// The multi handles of the calling thread, one per pool it used.
+struct ThreadMultis {
+  std::vector<std::pair<uint64_t, std::shared_ptr<ThreadMulti>>> by_pool;
+
+  ~ThreadMultis() {
+    for (auto& entry : by_pool) entry.second->cleanup();
+  }
+};
+
+/**
+ * Reusable easy handles, the CURLSH object they all attach to, and a multi
+ * handle per thread that every transfer of that thread runs on. The multi
+ * handle's connection cache outlives its transfers, so a page, its eager
+ * media and later lazy media ride the same connections when they are
+ * fetched on one thread. The share extends DNS and TLS sessions to every
+ * handle of the pool. Connections are not shared between threads: libcurl
+ * does not support a connection cache shared between concurrently running
+ * threads.
+ */
+class HandlePool {
+public:
+  HandlePool() : id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {
+    static std::once_flag global_init;
+    std::call_once(global_init, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    share_ = curl_share_init();
+    if (share_) {
+      curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lockShare);
+      curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlockShare);
+      curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+      curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+      curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+  }
+
+  ~HandlePool() {
+    for (const auto& multi : multis_) multi->cleanup();
+    for (CURL* curl : idle_) curl_easy_cleanup(curl);
+    if (share_) curl_share_cleanup(share_);
+  }
+
+  // Returns a handle with the options every request uses, or nullptr.
+  CURL* acquire() {
+    CURL* curl = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      if (!idle_.empty()) {
+        curl = idle_.back();
+        idle_.pop_back();
+      }
+    }
+    if (!curl) curl = curl_easy_init();
+    if (!curl) return nullptr;
+    if (share_) curl_easy_setopt(curl, CURLOPT_SHARE, share_);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L); // Disable SSL verification (temporary)
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // Follow redirects
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-      std::cerr << "Fetch error: " << curl_easy_strerror(res) << " for " << url << "\n";
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L); // handles are used from worker threads
+    return curl;
+  }
+
+  // Clears per-request options and keeps the handle for the next request.
+  void release(CURL* curl) {
+    if (!curl) return;
+    curl_easy_reset(curl);
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.push_back(curl);
+  }
+
+  size_t idleCount() const {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    return idle_.size();
+  }
+
+  // Returns the calling thread's multi handle, creating it on first use, or
+  // nullptr. A thread runs one batch or fetch on it at a time.
+  CURLM* threadMulti() {
+    thread_local ThreadMultis local;
+    for (const auto& entry : local.by_pool) {
+      if (entry.first == id_) return entry.second->multi;
     }
-    curl_easy_cleanup(curl);
-  } else {
-    std::cerr << "Failed to init curl for " << url << "\n";
+    auto slot = std::make_shared<ThreadMulti>();
+    slot->multi = curl_multi_init();
+    if (!slot->multi) return nullptr;
+    // Let transfers to one host share an HTTP/2 connection where offered.
+    curl_multi_setopt(slot->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    {
+      std::lock_guard<std::mutex> lock(multis_mutex_);
+      // Forget handles of threads that have exited.
+      multis_.erase(std::remove_if(multis_.begin(), multis_.end(),
+                                   [](const std::shared_ptr<ThreadMulti>& multi) {
+                                     std::lock_guard<std::mutex> slot_lock(multi->mutex);
+                                     return multi->multi == nullptr;
+                                   }),
+                    multis_.end());
+      multis_.push_back(slot);
+    }
+    local.by_pool.emplace_back(id_, slot);
+    return slot->multi;
+  }
+
+  // Runs one transfer to completion on the calling thread's multi handle, so
+  // it reuses the connections earlier transfers of the thread left open.
+  CURLcode perform(CURL* curl, const TransferControl* control) {
+    CURLM* multi = threadMulti();
+    if (!multi) return CURLE_OUT_OF_MEMORY;
+    curl_multi_add_handle(multi, curl);
+    CURLcode result = CURLE_OK;
+    for (bool done = false; !done;) {
+      int running = 0;
+      curl_multi_perform(multi, &running);
+      int queued = 0;
+      while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+        if (message->msg == CURLMSG_DONE && message->easy_handle == curl) {
+          result = message->data.result;
+          done = true;
+        }
+      }
+      // Wake up often enough to notice a cancelled transfer promptly.
+      if (!done) curl_multi_poll(multi, nullptr, 0, control ? 50 : 1000, nullptr);
+    }
+    curl_multi_remove_handle(multi, curl);
+    return result;
+  }
+
+private:
+  static void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<HandlePool*>(userptr)->shareMutex(data).lock();
   }
+
+  static void unlockShare(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<HandlePool*>(userptr)->shareMutex(data).unlock();
+  }
+
+  std::mutex& shareMutex(curl_lock_data data) {
+    const size_t index = static_cast<size_t>(data);
+    return share_mutexes_[index < kShareLocks ? index : 0];
+  }
+
+  static constexpr size_t kShareLocks = CURL_LOCK_DATA_LAST;
+  static std::atomic<uint64_t> next_id_;
+
+  const uint64_t id_; // tells this pool's multi handles from those of pools before it
+  CURLSH* share_ = nullptr;
+  std::mutex share_mutexes_[kShareLocks];
+  mutable std::mutex idle_mutex_;
+  std::vector<CURL*> idle_;
+  std::mutex multis_mutex_;
+  std::vector<std::shared_ptr<ThreadMulti>> multis_;
+};
+
+std::atomic<uint64_t> HandlePool::next_id_{1};
+
+Network::Network()
+    : pool_(std::make_unique<HandlePool>()),
+      cache_(std::make_unique<HttpCache>()),
+      media_cache_(std::make_unique<MediaCache>("cache")) {}
+
+Network::~Network() = default;
+
+size_t Network::idleHandleCount() const {
+  return pool_->idleCount();
+}
+
+HttpCache& Network::documentCache() {
+  return *cache_;
+}
+
+MediaCache& Network::mediaCache() {
+  return *media_cache_;
+}
+
+std::string Network::fetch(const std::string& url) {
+  std::string response;
+  fetch(url, [&response](const char* data, size_t size) { response.append(data, size); });
   return response;
 }
 
-std::string Network::fetchMedia(const std::string& url, const std::string& base_url) {
-  std::string resolved_url = resolveUrl(url, base_url);
-  if (resolved_url.empty()) {
-    std::cerr << "Invalid media URL: " << url << "\n";
-    return "";
+bool Network::fetch(const std::string& url, const std::function<void(const char*, size_t)>& on_data,
+                    const TransferControl* control) {
+  if (control && control->expired()) return false;
+  const std::time_t now = std::time(nullptr);
+  HttpCache::Lookup cached = cache_->lookup(url, now);
+  if (cached.state == HttpCache::State::Fresh) {
+    QUICKDOM_TRACE_DEBUG("Document cache hit", url);
+    on_data(cached.body->data(), cached.body->size());
+    return true;
   }
 
-  // Generate cache filename from URL hash
-  std::hash<std::string> hasher;
-  std::string filename = "cache/" + std::to_string(hasher(resolved_url)) + ".media";
-
-  if (fs::exists(filename) && fs::file_size(filename) > 0) {
-    std::cout << "Using cached media: " << filename << "\n";
-    return filename;
+  CURL* curl = pool_->acquire();
+  if (!curl) {
+    QUICKDOM_TRACE_ERROR("Failed to init curl", url);
+    return false;
   }
 
-  fs::create_directory("cache");
+  // Revalidate a stale entry; a 304 then replays its body.
+  curl_slist* request_headers = nullptr;
+  if (cached.state == HttpCache::State::Stale) {
+    if (!cached.etag.empty()) {
+      request_headers = curl_slist_append(request_headers, ("If-None-Match: " + cached.etag).c_str());
+    }
+    if (!cached.last_modified.empty()) {
+      request_headers = curl_slist_append(request_headers, ("If-Modified-Since: " + cached.last_modified).c_str());
+    }
+  }
 
-  CURL* curl = curl_easy_init();
-  std::ofstream file(filename, std::ios::binary);
+  DocumentTransfer transfer{curl, &on_data, cache_.get(), CacheHeaders(), false, false, std::string()};
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer.headers);
+  if (request_headers) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request_headers);
+  applyControl(curl, control);
+  const uint64_t start_ns = timelineEnabled() ? timelineNow() : 0;
+  CURLcode res = pool_->perform(curl, control);
   long http_code = 0;
-  if (curl && file.is_open()) {
-    curl_easy_setopt(curl, CURLOPT_URL, resolved_url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeFileCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &file);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L); // Disable SSL verification (temporary)
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // Follow redirects
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "QuickDOM/1.0"); // Add User-Agent
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    file.close();
-    if (res != CURLE_OK) {
-      std::cerr << "Media fetch error: " << curl_easy_strerror(res) << " for " << resolved_url << "\n";
-      fs::remove(filename);
-      filename.clear();
-    } else if (http_code != 200) {
-      std::cerr << "HTTP error: " << http_code << " for " << resolved_url << "\n";
-      fs::remove(filename);
-      filename.clear();
-    } else if (fs::file_size(filename) == 0) {
-      std::cerr << "Empty media file: " << filename << "\n";
-      fs::remove(filename);
-      filename.clear();
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+  if (start_ns) recordTransfer(curl, start_ns, url);
+  pool_->release(curl);
+  curl_slist_free_all(request_headers);
+
+  if (res != CURLE_OK) {
+    if (control && control->expired()) {
+      QUICKDOM_TRACE_INFO("Fetch aborted", url);
     } else {
-      std::cout << "Downloaded media: " << filename << " (" << fs::file_size(filename) << " bytes)\n";
+      QUICKDOM_TRACE_ERROR("Fetch error", curl_easy_strerror(res), " for ", url);
     }
-    curl_easy_cleanup(curl);
+    return false;
+  }
+  const std::time_t received = std::time(nullptr);
+  if (http_code == 304 && cached.state == HttpCache::State::Stale) {
+    if (auto body = cache_->revalidated(url, transfer.headers, received)) {
+      QUICKDOM_TRACE_DEBUG("Document revalidated", url);
+      on_data(body->data(), body->size());
+      return true;
+    }
+    // Evicted while revalidating; fetch it again unconditionally.
+    return fetch(url, on_data, control);
+  }
+  if (transfer.keep || !transfer.checked) {
+    cache_->store(url, http_code, transfer.headers, std::move(transfer.body), received);
+  } else if (http_code == 200) {
+    cache_->remove(url); // drop an entry the new response replaces
+  }
+  return true;
+}
+
+namespace {
+
+// Host (and port) of an absolute URL, used to group transfers per server
+std::string hostOf(const std::string& url) {
+  const size_t scheme = url.find("://");
+  const size_t begin = scheme == std::string::npos ? 0 : scheme + 3;
+  return url.substr(begin, url.find('/', begin) - begin);
+}
+
+// Validates a finished download. Non-HTTP schemes (file://) report response code 0.
+bool checkMediaDownload(CURLcode res, long http_code, size_t size, const std::string& url) {
+  if (res != CURLE_OK) {
+    QUICKDOM_TRACE_ERROR("Media fetch error", curl_easy_strerror(res), " for ", url);
+  } else if (http_code != 200 && http_code != 0) {
+    QUICKDOM_TRACE_WARN("HTTP error", http_code, " for ", url);
+  } else if (size == 0) {
+    QUICKDOM_TRACE_WARN("Empty media body", url);
   } else {
-    std::cerr << "Failed to init curl or open file for " << resolved_url << "\n";
-    if (curl) curl_easy_cleanup(curl);
-    if (file.is_open()) file.close();
-    filename.clear();
+    QUICKDOM_TRACE_DEBUG("Downloaded media", url, " (", size, " bytes)");
+    return true;
+  }
+  return false;
+}
+
+// One distinct URL of a batch, shared by every index that requested it
+struct MediaTransfer {
+  std::string url;
+  std::string host;
+  std::vector<size_t> indices;
+  std::string body;
+  CacheHeaders headers;
+  CURL* curl = nullptr;
+  uint64_t start_ns = 0; // when added to the multi handle, if the timeline was on
+};
+
+// Answers an index from a cache; returns false to have it downloaded.
+using MediaLookup = std::function<bool(size_t index, const std::string& url)>;
+
+// Receives a finished transfer; buffer is nullptr if it failed.
+using MediaDelivery = std::function<void(const MediaTransfer& transfer, const MediaBufferPtr& buffer)>;
+
+/**
+ * Resolves a batch of media URLs, lets lookup answer what is cached, and
+ * downloads the rest into memory on one curl multi handle. Transfers start
+ * in page order within the total and per-host limits; duplicate URLs are
+ * fetched once. Invalid URLs are delivered at once as failed transfers.
+ */
+void runMediaBatch(HandlePool& pool, const std::vector<std::string>& urls, const std::string& base_url,
+                   const MediaBatchOptions& options, const MediaLookup& lookup, const MediaDelivery& deliver) {
+  std::vector<std::unique_ptr<MediaTransfer>> transfers;
+  std::map<std::string, MediaTransfer*> by_url;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    std::string resolved_url = resolveUrl(urls[i], base_url);
+    if (resolved_url.empty()) {
+      QUICKDOM_TRACE_WARN("Invalid media URL", urls[i]);
+      MediaTransfer invalid;
+      invalid.url = urls[i];
+      invalid.indices.push_back(i);
+      deliver(invalid, nullptr);
+      continue;
+    }
+    if (lookup(i, resolved_url)) continue;
+    MediaTransfer*& transfer = by_url[resolved_url];
+    if (!transfer) {
+      transfers.push_back(std::make_unique<MediaTransfer>());
+      transfer = transfers.back().get();
+      transfer->url = resolved_url;
+      transfer->host = hostOf(resolved_url);
+    }
+    transfer->indices.push_back(i);
+  }
+  if (transfers.empty()) return;
+
+  // Transfers run on the thread's multi handle, which keeps their
+  // connections open for the next batch or page.
+  CURLM* multi = pool.threadMulti();
+  if (!multi) {
+    QUICKDOM_TRACE_ERROR("Failed to init curl multi", base_url);
+    for (const auto& transfer : transfers) deliver(*transfer, nullptr);
+    return;
   }
 
-  return filename;
+  const size_t max_total = std::max<size_t>(1, options.max_total);
+  const size_t max_per_host = std::max<size_t>(1, options.max_per_host);
+  std::map<std::string, size_t> host_active;
+  size_t active = 0;
+  size_t next = 0; // transfers before this have been started or skipped
+  std::vector<MediaTransfer*> waiting;
+
+  // Start queued transfers in page order while the limits allow. Transfers
+  // held back by their host's limit wait without blocking other hosts.
+  auto launch = [&]() {
+    std::vector<MediaTransfer*> candidates;
+    candidates.swap(waiting);
+    while (next < transfers.size()) candidates.push_back(transfers[next++].get());
+    for (MediaTransfer* transfer : candidates) {
+      if (options.control && options.control->expired()) {
+        deliver(*transfer, nullptr); // the caller gave up on the batch
+        continue;
+      }
+      if (active >= max_total || host_active[transfer->host] >= max_per_host) {
+        waiting.push_back(transfer);
+        continue;
+      }
+      transfer->curl = pool.acquire();
+      if (!transfer->curl) {
+        QUICKDOM_TRACE_ERROR("Failed to init curl", transfer->url);
+        deliver(*transfer, nullptr);
+        continue;
+      }
+      CURL* curl = transfer->curl;
+      curl_easy_setopt(curl, CURLOPT_URL, transfer->url.c_str());
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeBufferCallback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->body);
+      curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+      curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer->headers);
+      curl_easy_setopt(curl, CURLOPT_USERAGENT, "QuickDOM/1.0"); // Add User-Agent
+      curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer);
+      if (transfer->url.compare(0, 8, "https://") == 0) {
+        // Wait for a connection that may negotiate HTTP/2 rather than opening another.
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+      }
+      applyControl(curl, options.control);
+      transfer->start_ns = timelineEnabled() ? timelineNow() : 0;
+      curl_multi_add_handle(multi, curl);
+      ++active;
+      ++host_active[transfer->host];
+    }
+  };
+
+  launch();
+  while (active > 0) {
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    int queued = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+      if (message->msg != CURLMSG_DONE) continue;
+      MediaTransfer* transfer = nullptr;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+      long http_code = 0;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &http_code);
+      char* content_type = nullptr;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_CONTENT_TYPE, &content_type);
+      // The body is handed over as is; the buffer takes ownership of it.
+      MediaBufferPtr buffer;
+      if (checkMediaDownload(message->data.result, http_code, transfer->body.size(), transfer->url)) {
+        buffer = MediaBuffer::fromBytes(std::move(transfer->body), content_type ? content_type : "", transfer->url);
+      }
+      if (transfer->start_ns) recordTransfer(transfer->curl, transfer->start_ns, transfer->url);
+      curl_multi_remove_handle(multi, transfer->curl);
+      pool.release(transfer->curl);
+      transfer->curl = nullptr;
+      --active;
+      --host_active[transfer->host];
+      deliver(*transfer, buffer);
+    }
+
+    launch();
+    // Wake up often enough to notice a cancelled batch promptly.
+    if (active > 0) curl_multi_poll(multi, nullptr, 0, options.control ? 50 : 1000, nullptr);
+  }
+}
+
+} // namespace
+
+std::string Network::fetchMedia(const std::string& url, const std::string& base_url) {
+  return fetchMediaBatch({url}, base_url)[0];
+}
+
+void Network::fetchMediaBatch(const std::vector<std::string>& urls, const std::string& base_url,
+                              const MediaCallback& on_done, const MediaBatchOptions& options) {
+  auto lookup = [&](size_t index, const std::string& url) {
+    MediaEntry cached;
+    if (!media_cache_->lookup(url, &cached)) return false;
+    QUICKDOM_TRACE_DEBUG("Using cached media", cached.path);
+    on_done(index, cached.path);
+    return true;
+  };
+  // Callers want a file, so the body is written before they are told.
+  auto deliver = [&](const MediaTransfer& transfer, const MediaBufferPtr& buffer) {
+    const std::string path = buffer ? media_cache_->store(transfer.url, *buffer, transfer.headers.etag,
+                                                          transfer.headers.last_modified)
+                                    : std::string();
+    for (size_t index : transfer.indices) on_done(index, path);
+  };
+  runMediaBatch(*pool_, urls, base_url, options, lookup, deliver);
+}
+
+std::vector<std::string> Network::fetchMediaBatch(const std::vector<std::string>& urls,
+                                                  const std::string& base_url) {
+  std::vector<std::string> paths(urls.size());
+  fetchMediaBatch(urls, base_url, [&paths](size_t index, const std::string& path) { paths[index] = path; });
+  return paths;
+}
+
+MediaBufferPtr Network::cachedMedia(const std::string& url) {
+  if (MediaBufferPtr buffer = media_cache_->pending(url)) return buffer;
+  MediaEntry cached;
+  if (!media_cache_->lookup(url, &cached)) return nullptr;
+  if (MediaBufferPtr buffer = MediaBuffer::map(cached.path, cached.content_type, url)) {
+    QUICKDOM_TRACE_DEBUG("Mapped cached media", cached.path);
+    return buffer;
+  }
+  media_cache_->remove(url); // the file is gone; fetch it again
+  return nullptr;
+}
+
+void Network::fetchMediaBuffers(const std::vector<std::string>& urls, const std::string& base_url,
+                                const MediaBufferCallback& on_done, const MediaBatchOptions& options) {
+  auto lookup = [&](size_t index, const std::string& url) {
+    MediaBufferPtr buffer = cachedMedia(url);
+    if (buffer) on_done(index, buffer);
+    return buffer != nullptr;
+  };
+  // Hand the body to the caller first; the disk write happens in the background.
+  auto deliver = [&](const MediaTransfer& transfer, const MediaBufferPtr& buffer) {
+    for (size_t index : transfer.indices) on_done(index, buffer);
+    if (buffer) media_cache_->storeAsync(transfer.url, buffer, transfer.headers.etag, transfer.headers.last_modified);
+  };
+  runMediaBatch(*pool_, urls, base_url, options, lookup, deliver);
 }
\ No newline at end of file
@@ -5,28 +5,178 @@
 #ifndef NETWORK_H
 #define NETWORK_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
+#include "media_buffer.h"
+
+/**
+ * @brief Lets a caller abort the transfers of a request it no longer needs.
+ *
+ * Transfers poll it while they run and fail once it is cancelled or past
+ * its deadline. May be cancelled from any thread.
+ */
+struct TransferControl {
+  std::atomic<bool> cancelled{false};
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+  void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+  bool expired() const {
+    return cancelled.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline;
+  }
+};
+
+/**
+ * @brief Concurrency limits for Network::fetchMediaBatch.
+ */
+struct MediaBatchOptions {
+  size_t max_total = 16;   // transfers in flight at once
+  size_t max_per_host = 6; // transfers in flight to one host
+  const TransferControl* control = nullptr; // aborts the batch early; unset never does
+};
+
+class HandlePool;
+class HttpCache;
+class MediaCache;
 
 /**
  * @class Network
  * @brief Fetches web pages and media files.
+ *
+ * Requests reuse easy handles from a pool and run on a curl multi handle
+ * kept per calling thread, whose connections stay open between requests. A
+ * page and the media fetched after it on the same thread therefore ride the
+ * page's connection. All handles share one DNS cache and TLS session cache,
+ * so a thread contacting a host another thread already knows skips the
+ * lookup and resumes the TLS session. HTTP/2 is negotiated over TLS and
+ * batched media transfers multiplex on it. All methods may be called from
+ * several threads at once.
  */
 class Network {
 public:
+  Network();
+  ~Network();
+  Network(const Network&) = delete;
+  Network& operator=(const Network&) = delete;
+
   /**
    * @brief Fetches HTML content from a URL.
+   *
+   * Documents go through an HTTP cache: fresh entries are returned without
+   * network I/O and stale ones are revalidated with a conditional request.
    * @param url Web page URL.
    * @return HTML content as a string.
    */
   std::string fetch(const std::string& url);
 
+  /**
+   * @brief Streams a page body to a callback as it arrives.
+   *
+   * The callback runs from libcurl's write callback on the calling thread,
+   * so a consumer such as ParseStream::feed overlaps with the download.
+   * @param url Web page URL.
+   * @param on_data Receives each chunk of the body.
+   * @param control Aborts the transfer when cancelled or past its deadline.
+   * @return True if the transfer completed.
+   */
+  bool fetch(const std::string& url, const std::function<void(const char*, size_t)>& on_data,
+             const TransferControl* control = nullptr);
+
   /**
    * @brief Fetches and caches a media file.
+   *
+   * Files are kept in the size-bounded MediaCache under cache/; a hit is
+   * answered from its memory-mapped index without touching the disk.
    * @param url Media file URL.
    * @param base_url Base URL for resolving relative paths.
    * @return Path to the cached file.
    */
   std::string fetchMedia(const std::string& url, const std::string& base_url);
+
+  /**
+   * @brief Receives one result of a media batch.
+   * @param index Position of the URL in the batch.
+   * @param path Cached file path, or empty if the fetch failed.
+   */
+  using MediaCallback = std::function<void(size_t index, const std::string& path)>;
+
+  /**
+   * @brief Fetches and caches many media files concurrently.
+   *
+   * Runs the transfers on one curl multi handle within the given limits, so
+   * a page's images take about as long as the slowest one rather than the
+   * sum of all. Cache hits and invalid URLs are reported first; the others
+   * are reported as each transfer completes. Duplicate URLs are fetched
+   * once. Callbacks run on the calling thread before this returns.
+   * @param urls Media URLs, possibly relative.
+   * @param base_url Base URL for resolving relative paths.
+   * @param on_done Called exactly once per URL.
+   * @param options Concurrency limits.
+   */
+  void fetchMediaBatch(const std::vector<std::string>& urls, const std::string& base_url,
+                       const MediaCallback& on_done, const MediaBatchOptions& options = MediaBatchOptions());
+
+  /**
+   * @brief Fetches many media files concurrently and waits for all of them.
+   * @return Cached file paths in the order of urls; empty where a fetch failed.
+   */
+  std::vector<std::string> fetchMediaBatch(const std::vector<std::string>& urls, const std::string& base_url);
+
+  /**
+   * @brief Receives one result of an in-memory media batch.
+   * @param index Position of the URL in the batch.
+   * @param buffer Media bytes, or nullptr if the fetch failed.
+   */
+  using MediaBufferCallback = std::function<void(size_t index, const MediaBufferPtr& buffer)>;
+
+  /**
+   * @brief Fetches many media files concurrently as in-memory buffers.
+   *
+   * Works like the path-based fetchMediaBatch, but a download is handed over
+   * as soon as its last byte arrives and written to the media cache in the
+   * background. Cached files are mapped rather than read. The buffers can
+   * be decoded directly, e.g. with QPixmap::loadFromData.
+   * @param urls Media URLs, possibly relative.
+   * @param base_url Base URL for resolving relative paths.
+   * @param on_done Called exactly once per URL, on the calling thread.
+   * @param options Concurrency limits.
+   */
+  void fetchMediaBuffers(const std::vector<std::string>& urls, const std::string& base_url,
+                         const MediaBufferCallback& on_done, const MediaBatchOptions& options = MediaBatchOptions());
+
+  /**
+   * @brief Returns media from the caches without network I/O.
+   *
+   * Media still being written in the background is returned from memory;
+   * cached files are mapped.
+   * @param url Resolved media URL.
+   * @return The bytes, or nullptr if neither cache holds them.
+   */
+  MediaBufferPtr cachedMedia(const std::string& url);
+
+  /**
+   * @brief Returns how many easy handles are idle in the pool.
+   */
+  size_t idleHandleCount() const;
+
+  /**
+   * @brief Returns the cache fetch() serves documents from.
+   */
+  HttpCache& documentCache();
+
+  /**
+   * @brief Returns the disk cache fetchMedia() stores files in.
+   */
+  MediaCache& mediaCache();
+
+private:
+  std::unique_ptr<HandlePool> pool_;
+  std::unique_ptr<HttpCache> cache_;
+  std::unique_ptr<MediaCache> media_cache_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file page_load.cpp
+ * @brief Implements the asynchronous page-load pipeline.
+ */
+#include "page_load.h"
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "image_decoder.h"
+#include "timeline.h"
+#include "trace.h"
+
+struct PageLoad::State {
+    State(Network& network, HtmlParser& parser, std::string url)
+        : network(network), parser(parser), url(std::move(url)) {}
+
+    Network& network;
+    HtmlParser& parser;
+    std::string url;
+    TransferControl control; // cancels fetches and marks the load abandoned
+    bool lazy_images = true;  // fetch only loading="eager" images
+    uint64_t timeline_tab = kNoTimelineTab;
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds elapsed(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+// Collects the src of every image to fetch with the page, in document order,
+// so the fetches run concurrently. With lazy set, only loading="eager" ones.
+std::vector<std::string> imageSources(const Document& document, bool lazy) {
+    std::vector<std::string> urls;
+    document.forEachNode([&](NodeId id) {
+        std::string_view src;
+        if (document.node(id).tag == TagAtom::Img && document.findAttribute(id, "src", src) &&
+            (!lazy || document.attribute(id, "loading") == "eager")) {
+            urls.emplace_back(src);
+        }
+    });
+    return urls;
+}
+
+} // namespace
+
+class PageLoadTask : public QRunnable {
+public:
+    PageLoadTask(std::shared_ptr<PageLoad::State> state, PageLoad* load) : state_(std::move(state)), load_(load) {}
+
+    void run() override {
+        if (state_->control.cancelled.load(std::memory_order_relaxed)) {
+            QUICKDOM_TRACE_INFO("Page load cancelled before start", state_->url);
+            return;
+        }
+        TimelineTabScope tab(state_->timeline_tab);
+        auto result = std::make_shared<PageLoadResult>();
+        if (!runPipeline(*state_, *result)) {
+            QUICKDOM_TRACE_INFO("Page load cancelled", state_->url);
+            return;
+        }
+        std::shared_ptr<PageLoad::State> state = state_;
+        postToGuiThread(load_, [state, result](PageLoad* load) {
+            if (state->control.cancelled.load(std::memory_order_relaxed)) return;
+            load->deliver(std::move(*result));
+        });
+    }
+
+private:
+    // Runs the network-bound stages of a load; returns false if it was abandoned.
+    static bool runPipeline(PageLoad::State& state, PageLoadResult& result) {
+        // Tokenize each chunk as curl delivers it, so parsing overlaps the download.
+        std::unique_ptr<ParseStream> stream = state.parser.stream();
+        result.url = state.url;
+        PageLoadTimings& timings = result.timings;
+        const std::string& url = state.url;
+        const Clock::time_point fetch_start = Clock::now();
+        {
+            TimelineSpan fetch_span("fetch", "load", url);
+            result.complete = state.network.fetch(url, [&stream, &timings, &url](const char* data, size_t size) {
+                TimelineSpan parse_span("parse", "load", url);
+                const Clock::time_point feed_start = Clock::now();
+                stream->feed(data, size);
+                timings.parse += elapsed(feed_start);
+            }, &state.control);
+        }
+        timings.fetch = elapsed(fetch_start);
+        if (state.control.cancelled.load(std::memory_order_relaxed)) return false;
+        const Clock::time_point finish_start = Clock::now();
+        {
+            TimelineSpan parse_span("parse", "load", url);
+            result.document = stream->finish();
+        }
+        timings.parse += elapsed(finish_start);
+
+        // Bytes stay in memory for the renderer; the cache writes them to disk later.
+        const std::vector<std::string> urls = imageSources(result.document, state.lazy_images);
+        MediaBatchOptions options;
+        options.control = &state.control;
+        const Clock::time_point media_start = Clock::now();
+        TimelineSpan media_span("media", "load", url);
+        state.network.fetchMediaBuffers(urls, state.url, [&](size_t index, const MediaBufferPtr& buffer) {
+            if (buffer) {
+                result.media[urls[index]] = buffer;
+            }
+        }, options);
+        timings.media = elapsed(media_start);
+        return !state.control.cancelled.load(std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<PageLoad::State> state_;
+    QPointer<PageLoad> load_;
+};
+
+PageLoad::PageLoad(Network& network, HtmlParser& parser, std::string url, std::chrono::milliseconds timeout,
+                   QObject* parent)
+    : QObject(parent), url_(url), state_(std::make_shared<State>(network, parser, std::move(url))) {
+    state_->control.deadline = std::chrono::steady_clock::now() + timeout;
+}
+
+PageLoad::~PageLoad() {
+    cancel();
+}
+
+void PageLoad::start(QThreadPool* pool) {
+    pool->start(new PageLoadTask(state_, this));
+}
+
+void PageLoad::setLazyImages(bool lazy) {
+    state_->lazy_images = lazy;
+}
+
+void PageLoad::setTimelineTab(uint64_t tab) {
+    state_->timeline_tab = tab;
+}
+
+void PageLoad::cancel() {
+    state_->control.cancel();
+}
+
+bool PageLoad::isCancelled() const {
+    return state_->control.cancelled.load(std::memory_order_relaxed);
+}
+
+void PageLoad::deliver(PageLoadResult result) {
+    result_ = std::move(result);
+    emit finished();
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file page_load.h
+ * @brief Defines the asynchronous, cancellable page-load pipeline.
+ */
+#ifndef PAGE_LOAD_H
+#define PAGE_LOAD_H
+
+#include "html_parser.h"
+#include "network.h"
+#include "renderer.h"
+#include <QObject>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class QThreadPool;
+
+/**
+ * @brief Where a page load spent its time on the worker thread.
+ */
+struct PageLoadTimings {
+    std::chrono::microseconds fetch{0}; // request to last byte, streaming parse included
+    std::chrono::microseconds parse{0}; // inside the parser, while streaming and finishing
+    std::chrono::microseconds media{0}; // fetching the page's images
+};
+
+/**
+ * @brief What a page load produced, handed to the GUI thread for rendering.
+ */
+struct PageLoadResult {
+    std::string url;
+    Document document;
+    MediaMap media;        // fetched images keyed by src
+    bool complete = false; // the document downloaded in full
+    PageLoadTimings timings;
+};
+
+/**
+ * @class PageLoad
+ * @brief Loads one page off the GUI thread: fetch, parse and media fetch.
+ *
+ * The document is parsed as it streams in and its images are fetched
+ * concurrently, all on a worker thread, so the GUI thread only renders the
+ * result. By default only images marked loading="eager" are fetched; the
+ * view fetches the others as they near the visible area. finished() is
+ * emitted on the GUI thread unless the load was cancelled first, by
+ * cancel() or by destroying it together with the tab that owns it;
+ * transfers in flight are aborted rather than waited for.
+ * Past its deadline a load stops its transfers and finishes with what
+ * arrived, marked incomplete.
+ */
+class PageLoad : public QObject {
+    Q_OBJECT
+public:
+    static constexpr std::chrono::milliseconds kDefaultTimeout{30000};
+
+    /**
+     * @brief Prepares a load; start() begins it.
+     * @param network Network to fetch with; must outlive the load's worker.
+     * @param parser Parser to stream the document into; must outlive the worker.
+     * @param url Page URL.
+     * @param timeout Time allowed for the whole load, media included.
+     * @param parent Owner; destroying it cancels the load.
+     */
+    PageLoad(Network& network, HtmlParser& parser, std::string url,
+             std::chrono::milliseconds timeout = kDefaultTimeout, QObject* parent = nullptr);
+    ~PageLoad() override;
+
+    /**
+     * @brief Queues the load on a thread pool.
+     */
+    void start(QThreadPool* pool);
+
+    /**
+     * @brief Aborts the load; finished() will not be emitted.
+     */
+    void cancel();
+    bool isCancelled() const;
+
+    const std::string& url() const { return url_; }
+
+    /**
+     * @brief Chooses whether images not marked loading="eager" are left out;
+     *        call before start(). On by default.
+     */
+    void setLazyImages(bool lazy);
+
+    /**
+     * @brief Sets the tab the load's timeline spans are tagged with; call
+     *        before start().
+     */
+    void setTimelineTab(uint64_t tab);
+
+    /**
+     * @brief Moves the result out; valid once finished() was emitted.
+     */
+    PageLoadResult takeResult() { return std::move(result_); }
+
+signals:
+    void finished();
+
+private:
+    friend class PageLoadTask;
+    struct State;
+
+    void deliver(PageLoadResult result);
+
+    std::string url_;
+    std::shared_ptr<State> state_; // shared with the worker, which may outlive this object
+    PageLoadResult result_;
+};
+
+#endif // PAGE_LOAD_H
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * @file page_view.cpp
+ * @brief Implements painting, layout and link handling of a page view.
+ */
+#include "page_view.h"
+#include "image_cache.h"
+#include "renderer.h"
+#include "trace.h"
+#include <QPainter>
+#include <QPointer>
+
+namespace {
+
+// Width laid out for before the view is first resized.
+constexpr int kInitialWidth = 800;
+
+} // namespace
+
+PageView::PageView(DisplayList list, DecodeGroupPtr decodes, QWidget* parent)
+    : QWidget(parent), list_(std::move(list)), decodes_(std::move(decodes)) {
+    setMouseTracking(true); // for the link cursor
+    relayout(kInitialWidth);
+    startDecodes();
+}
+
+QSize PageView::sizeHint() const {
+    return QSize(list_.layoutWidth(), list_.height());
+}
+
+void PageView::setMediaFetcher(MediaFetcher fetcher, int margin) {
+    fetcher_ = std::move(fetcher);
+    lazy_margin_ = margin;
+    fetch_requested_.assign(list_.lazyImages().size(), false);
+    fetchNearbyImages();
+}
+
+void PageView::relayout(int width) {
+    if (width == list_.layoutWidth()) return;
+    // The scroll area sizes the view at least this tall and scrolls it.
+    setMinimumHeight(list_.layout(width));
+    update();
+}
+
+void PageView::startDecodes() {
+    if (!decodes_) return;
+    const std::vector<PendingImage>& pending_images = list_.pendingImages();
+    for (; decodes_started_ < pending_images.size(); ++decodes_started_) {
+        const PendingImage& pending = pending_images[decodes_started_];
+        const size_t index = pending.item;
+        const ImageKey key = pending.key;
+        decodeAsync(decodes_, pending.request, this, [this, index, key](const QImage& image) {
+            if (image.isNull()) {
+                QUICKDOM_TRACE_WARN("Failed to load pixmap", key.source);
+                return; // the placeholder stays
+            }
+            QPixmap pixmap = QPixmap::fromImage(image);
+            pixmap.setDevicePixelRatio(key.device_pixel_ratio);
+            ImageCache::instance().insert(key, pixmap);
+            list_.setPixmap(index, pixmap);
+            update(list_.item(index).rect);
+        });
+    }
+}
+
+void PageView::fetchNearbyImages() {
+    if (!fetcher_) return;
+    // Hidden tabs have nothing visible and fetch nothing.
+    const QRect visible = visibleRegion().boundingRect();
+    if (visible.isEmpty()) return;
+    const auto range = list_.lazyImagesIn(visible.top() - lazy_margin_, visible.bottom() + 1 + lazy_margin_);
+    std::vector<std::string> sources;
+    std::vector<size_t> indices;
+    for (size_t i = range.first; i < range.second; ++i) {
+        if (fetch_requested_[i]) continue;
+        fetch_requested_[i] = true;
+        sources.push_back(list_.lazyImages()[i].src);
+        indices.push_back(i);
+    }
+    if (sources.empty()) return;
+
+    // Results arrive on worker threads.
+    QPointer<PageView> view = this;
+    fetcher_(sources, [view, indices](size_t index, MediaBufferPtr media) {
+        const size_t lazy_index = indices[index];
+        postToGuiThread(view, [lazy_index, media](PageView* page) { page->imageFetched(lazy_index, media); });
+    });
+}
+
+void PageView::imageFetched(size_t lazy_index, const MediaBufferPtr& media) {
+    const LazyImage& lazy = list_.lazyImages()[lazy_index];
+    Renderer::resolveLazyImage(&list_, lazy, media, devicePixelRatioF());
+    if (list_.layoutWidth() < 0) {
+        // The page gave no size for it; everything below moves.
+        setMinimumHeight(list_.layout(width() > 0 ? width() : kInitialWidth));
+        update();
+    } else {
+        update(list_.item(lazy.item).rect);
+    }
+    startDecodes();
+}
+
+void PageView::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), Qt::black);
+    list_.paint(painter, event->rect());
+    // Scrolling exposes the view strip by strip; check what came near.
+    fetchNearbyImages();
+}
+
+void PageView::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    relayout(width());
+}
+
+void PageView::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        if (const DisplayItem* link = list_.linkAt(event->pos())) {
+            emit linkClicked(link->href);
+            return;
+        }
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void PageView::mouseMoveEvent(QMouseEvent* event) {
+    setCursor(list_.linkAt(event->pos()) ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    QWidget::mouseMoveEvent(event);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+ * @file page_view.h
+ * @brief Defines the widget that paints a page from its display list.
+ */
+#ifndef PAGE_VIEW_H
+#define PAGE_VIEW_H
+
+#include "display_list.h"
+#include "image_decoder.h"
+#include "media_buffer.h"
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWidget>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class PageView
+ * @brief One widget per page, however long the page is.
+ *
+ * Meant to sit in a QScrollArea with resizable contents. It is as tall as
+ * the laid out page, but paints only the items in the exposed region, which
+ * on scrolling is the strip that came into view. Links are hit-tested
+ * against the display list instead of being widgets of their own. Lazy
+ * images are fetched once their placeholders come within a margin of the
+ * visible area.
+ */
+class PageView : public QWidget {
+    Q_OBJECT
+public:
+    /**
+     * @brief Creates a view of a display list.
+     * @param decodes Group the list's pending images are decoded in; they
+     *        are queued on the worker pool right away. Without a group the
+     *        pending images keep their placeholders.
+     */
+    explicit PageView(DisplayList list, DecodeGroupPtr decodes = nullptr, QWidget* parent = nullptr);
+
+    /**
+     * @brief Reports a fetched image, from any thread; media is nullptr on failure.
+     */
+    using MediaDone = std::function<void(size_t index, MediaBufferPtr media)>;
+
+    /**
+     * @brief Fetches images off the GUI thread and reports each through done.
+     */
+    using MediaFetcher = std::function<void(const std::vector<std::string>& sources, MediaDone done)>;
+
+    static constexpr int kDefaultLazyMargin = 1250; // pixels
+
+    /**
+     * @brief Enables fetching of the list's lazy images.
+     * @param fetcher Fetches image sources as written in the page.
+     * @param margin Distance from the visible area at which an image is fetched.
+     */
+    void setMediaFetcher(MediaFetcher fetcher, int margin = kDefaultLazyMargin);
+
+    const DisplayList& displayList() const { return list_; }
+
+    /**
+     * @brief Returns the approximate bytes the page holds.
+     */
+    size_t memoryBytes() const { return list_.memoryBytes(); }
+
+    QSize sizeHint() const override;
+
+signals:
+    void linkClicked(const QString& href);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+    void relayout(int width);
+    void startDecodes();
+    void fetchNearbyImages();
+    void imageFetched(size_t lazy_index, const MediaBufferPtr& media);
+
+    DisplayList list_;
+    DecodeGroupPtr decodes_;
+    size_t decodes_started_ = 0; // pending images already queued
+    MediaFetcher fetcher_;
+    int lazy_margin_ = kDefaultLazyMargin;
+    std::vector<bool> fetch_requested_; // by index in lazyImages()
+};
+
+#endif // PAGE_VIEW_H
\ No newline at end of file
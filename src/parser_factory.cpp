@@ -0,0 +1,105 @@
+/**
+ * @file parser_factory.cpp
+ * @brief Implements runtime parser selection.
+ */
+#include "parser_factory.h"
+#include "cpu_features.h"
+#include <cctype>
+#include <cstdlib>
+#include "trace.h"
+
+namespace {
+
+struct ParserName {
+    const char* name;
+    ParserKind kind;
+};
+
+const ParserName kParserNames[] = {
+    {"auto", ParserKind::Auto},
+    {"scalar", ParserKind::Scalar},
+    {"sse2", ParserKind::Sse2},
+    {"avx2", ParserKind::Avx2},
+    {"avx512", ParserKind::Avx512},
+    {"neon", ParserKind::Neon},
+};
+
+} // namespace
+
+bool parserKindFromName(const std::string& name, ParserKind& kind) {
+    std::string lower;
+    for (char c : name) lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    for (const auto& entry : kParserNames) {
+        if (lower == entry.name) {
+            kind = entry.kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* parserKindName(ParserKind kind) {
+    for (const auto& entry : kParserNames) {
+        if (entry.kind == kind) return entry.name;
+    }
+    return "unknown";
+}
+
+bool parserKindSupported(ParserKind kind) {
+    switch (kind) {
+        case ParserKind::Auto:
+        case ParserKind::Scalar:
+            return true;
+        case ParserKind::Sse2:
+            return simdLevelSupported(SimdLevel::Sse2);
+        case ParserKind::Avx2:
+            return simdLevelSupported(SimdLevel::Avx2);
+        case ParserKind::Avx512:
+            return simdLevelSupported(SimdLevel::Avx512);
+        case ParserKind::Neon:
+            return cpuFeatures().neon;
+    }
+    return false;
+}
+
+ParserKind bestParserKind() {
+    for (ParserKind kind : {ParserKind::Avx512, ParserKind::Avx2, ParserKind::Neon, ParserKind::Sse2}) {
+        if (parserKindSupported(kind)) return kind;
+    }
+    return ParserKind::Scalar;
+}
+
+ParserKind resolveParserKind(ParserKind requested) {
+    if (requested == ParserKind::Auto) {
+        if (const char* env = std::getenv("QUICKDOM_PARSER")) {
+            if (!parserKindFromName(env, requested)) {
+                QUICKDOM_TRACE_WARN("Unknown QUICKDOM_PARSER value", env);
+            }
+        }
+    }
+    if (requested == ParserKind::Auto) return bestParserKind();
+    if (!parserKindSupported(requested)) {
+        ParserKind fallback = bestParserKind();
+        QUICKDOM_TRACE_WARN("Parser not supported on this CPU", parserKindName(requested), ", using ",
+                            parserKindName(fallback));
+        return fallback;
+    }
+    return requested;
+}
+
+std::unique_ptr<HtmlParser> createParser(ParserKind kind) {
+    switch (resolveParserKind(kind)) {
+        case ParserKind::Sse2:
+            return std::make_unique<SimdParser>(SimdLevel::Sse2);
+        case ParserKind::Avx2:
+            return std::make_unique<SimdParser>(SimdLevel::Avx2);
+        case ParserKind::Avx512:
+            return std::make_unique<SimdParser>(SimdLevel::Avx512);
+        case ParserKind::Neon:
+            return std::make_unique<NeonParser>();
+        case ParserKind::Auto:
+        case ParserKind::Scalar:
+            break;
+    }
+    return std::make_unique<ScalarParser>();
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * @file parser_factory.h
+ * @brief Runtime selection of the fastest HTML parser for the running CPU.
+ */
+#ifndef PARSER_FACTORY_H
+#define PARSER_FACTORY_H
+
+#include "html_parser.h"
+#include <memory>
+#include <string>
+
+/**
+ * @brief Parser implementations that can be requested by name.
+ */
+enum class ParserKind {
+    Auto,   // best supported kernel, or QUICKDOM_PARSER if set
+    Scalar, // byte-at-a-time reference parser
+    Sse2,
+    Avx2,
+    Avx512,
+    Neon
+};
+
+/**
+ * @brief Parses a parser name ("auto", "scalar", "sse2", "avx2", "avx512", "neon").
+ * @param name Case-insensitive parser name.
+ * @param kind Receives the parsed kind on success.
+ * @return False if the name is unknown.
+ */
+bool parserKindFromName(const std::string& name, ParserKind& kind);
+
+/**
+ * @brief Returns the canonical name of a parser kind.
+ */
+const char* parserKindName(ParserKind kind);
+
+/**
+ * @brief Checks whether the running CPU can execute a parser kind.
+ */
+bool parserKindSupported(ParserKind kind);
+
+/**
+ * @brief Returns the fastest parser kind the running CPU supports.
+ */
+ParserKind bestParserKind();
+
+/**
+ * @brief Resolves Auto to a concrete kind.
+ *
+ * Auto honours the QUICKDOM_PARSER environment variable before falling back
+ * to bestParserKind(). Kinds the CPU cannot run are replaced by the best
+ * supported one. Both an unknown QUICKDOM_PARSER value and a replaced kind
+ * are reported as trace warnings.
+ */
+ParserKind resolveParserKind(ParserKind requested);
+
+/**
+ * @brief Creates a parser.
+ * @param kind Requested implementation; Auto picks one at runtime.
+ * @return Parser instance, never null.
+ */
+std::unique_ptr<HtmlParser> createParser(ParserKind kind = ParserKind::Auto);
+
+#endif // PARSER_FACTORY_H
\ No newline at end of file
@@ -8,102 +8,499 @@
 #include <QSvgRenderer>
 #include <QPainter>
 #include <QApplication>
-#include <iostream>
+#include <QByteArray>
+#include "image_cache.h"
+#include "image_decoder.h"
+#include "link_label.h"
+#include "trace.h"
+#include <vector>
 
-void Renderer::render(const Node& node, QVBoxLayout* layout) {
-    if (node.type == "text" || node.type == "p" || node.type == "div" || node.type == "span") {
-        QLabel* label = new QLabel(QString::fromStdString(node.text));
-        label->setWordWrap(true);
-        label->setStyleSheet("color: white; font-size: 14px;"); // White text
-        layout->addWidget(label);
-        std::cout << "Rendering text: " << node.text << "\n";
-    } else if (node.type == "header") {
-        QLabel* label = new QLabel(QString::fromStdString(node.text));
-        label->setWordWrap(true);
-        label->setStyleSheet("color: white; font-size: 18px; font-weight: bold;"); // White, bold header
-        layout->addWidget(label);
-        std::cout << "Rendering header: " << node.text << "\n";
-    } else if (node.type == "image") {
-        auto src_it = node.attributes.find("src");
-        if (src_it != node.attributes.end() && !src_it->second.empty()) {
-            try {
-                QPixmap pixmap;
-                if (src_it->second.find(".svg") != std::string::npos) {
-                    QSvgRenderer svg_renderer(QString::fromStdString(src_it->second));
-                    if (svg_renderer.isValid()) {
-                        int width = 100, height = 100; // Default SVG size
-                        auto width_it = node.attributes.find("width");
-                        auto height_it = node.attributes.find("height");
-                        if (width_it != node.attributes.end() && !width_it->second.empty()) {
-                            width = std::stoi(width_it->second);
-                        }
-                        if (height_it != node.attributes.end() && !height_it->second.empty()) {
-                            height = std::stoi(height_it->second);
-                        }
-                        pixmap = QPixmap(width, height);
-                        pixmap.fill(Qt::transparent);
-                        QPainter painter(&pixmap);
-                        svg_renderer.render(&painter);
-                    } else {
-                        std::cerr << "Invalid SVG: " << src_it->second << "\n";
-                        return;
-                    }
-                } else {
-                    pixmap.load(QString::fromStdString(src_it->second));
-                }
-
-                if (!pixmap.isNull()) {
-                    QLabel* image_label = new QLabel();
-                    int width = pixmap.width();
-                    int height = pixmap.height();
-                    auto width_it = node.attributes.find("width");
-                    auto height_it = node.attributes.find("height");
-                    if (width_it != node.attributes.end() && !width_it->second.empty()) {
-                        try {
-                            width = std::stoi(width_it->second);
-                        } catch (const std::exception& e) {
-                            std::cerr << "Invalid width: " << width_it->second << "\n";
-                        }
-                    }
-                    if (height_it != node.attributes.end() && !height_it->second.empty()) {
-                        try {
-                            height = std::stoi(height_it->second);
-                        } catch (const std::exception& e) {
-                            std::cerr << "Invalid height: " << height_it->second << "\n";
-                        }
-                    }
-                    width = std::min(width, 800);
-                    height = std::min(height, 600);
-                    image_label->setPixmap(pixmap.scaled(width, height, Qt::KeepAspectRatio));
-                    layout->addWidget(image_label);
-                    std::cout << "Rendering image: " << src_it->second << "\n";
-                } else {
-                    QLabel* placeholder = new QLabel("Image not loaded");
-                    placeholder->setStyleSheet("color: white; background: gray; padding: 5px;");
-                    layout->addWidget(placeholder);
-                    std::cerr << "Failed to load pixmap: " << src_it->second << "\n";
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Error rendering image " << src_it->second << ": " << e.what() << "\n";
+namespace {
+
+// The fields of a node the renderer reads, borrowed from a Node or a Document.
+struct ElementView {
+    TagAtom tag = TagAtom::Unknown;
+    std::string_view text;
+    std::string_view src;
+    std::string_view width;
+    std::string_view height;
+    std::string_view href;
+    std::string_view style;               // inline style attribute
+    MediaBufferPtr media;                 // fetched bytes of src, if any
+    const DecodeGroupPtr* decodes = nullptr; // decode images off the GUI thread when set
+};
+
+std::string_view attributeOf(const Node& node, const char* name) {
+    auto it = node.attributes.find(name);
+    return it != node.attributes.end() ? std::string_view(it->second) : std::string_view();
+}
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+// One hash lookup for elements with a style attribute, none for the rest.
+const ComputedStyle* styleOf(const ElementView& node, TextStyle role) {
+    return StyleTable::instance().resolve(role, node.style);
+}
+
+const ComputedStyle& noticeStyle() {
+    return *StyleTable::instance().defaultStyle(TextStyle::Notice);
+}
+
+// A word-wrapped label shown in a style.
+QLabel* textLabel(const QString& text, const ComputedStyle& style) {
+    QLabel* label = new QLabel(text);
+    label->setWordWrap(true);
+    style.apply(label);
+    return label;
+}
+
+void renderText(const ElementView& node, QVBoxLayout* layout) {
+    QLabel* label = textLabel(toQString(node.text), *styleOf(node, TextStyle::Body));
+    layout->addWidget(label);
+    QUICKDOM_TRACE_DEBUG("Rendering text", node.text);
+}
+
+void renderHeader(const ElementView& node, QVBoxLayout* layout) {
+    QLabel* label = textLabel(toQString(node.text), *styleOf(node, TextStyle::Header));
+    layout->addWidget(label);
+    QUICKDOM_TRACE_DEBUG("Rendering header", node.text);
+}
+
+// Parses a width or height attribute for the cache key; -1 if absent or invalid.
+int dimensionOf(std::string_view value) {
+    if (value.empty()) return -1;
+    try {
+        return std::stoi(std::string(value));
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+// Renders an SVG at its width/height attributes; null if the SVG is invalid.
+QPixmap renderSvg(const ElementView& node, const std::string& src) {
+    QSvgRenderer svg_renderer;
+    if (node.media) {
+        svg_renderer.load(QByteArray::fromRawData(node.media->data(), static_cast<int>(node.media->size())));
+    } else {
+        svg_renderer.load(QString::fromStdString(src));
+    }
+    if (!svg_renderer.isValid()) {
+        QUICKDOM_TRACE_WARN("Invalid SVG", src);
+        return QPixmap();
+    }
+    int width = 100, height = 100; // Default SVG size
+    if (!node.width.empty()) {
+        width = std::stoi(std::string(node.width));
+    }
+    if (!node.height.empty()) {
+        height = std::stoi(std::string(node.height));
+    }
+    QPixmap pixmap(width, height);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    svg_renderer.render(&painter);
+    return pixmap;
+}
+
+// Returns the size an image of the given natural size is displayed at: the
+// width/height attributes if given, capped at 800x600, keeping the aspect ratio.
+QSize displaySize(const QSize& natural, const ElementView& node) {
+    int width = natural.width();
+    int height = natural.height();
+    if (!node.width.empty()) {
+        try {
+            width = std::stoi(std::string(node.width));
+        } catch (const std::exception& e) {
+            QUICKDOM_TRACE_WARN("Invalid width", node.width);
+        }
+    }
+    if (!node.height.empty()) {
+        try {
+            height = std::stoi(std::string(node.height));
+        } catch (const std::exception& e) {
+            QUICKDOM_TRACE_WARN("Invalid height", node.height);
+        }
+    }
+    width = std::min(width, 800);
+    height = std::min(height, 600);
+    return natural.scaled(width, height, Qt::KeepAspectRatio);
+}
+
+QSize toDevicePixels(const QSize& size, qreal device_pixel_ratio) {
+    return QSize(qRound(size.width() * device_pixel_ratio), qRound(size.height() * device_pixel_ratio));
+}
+
+// Scales a decoded image to its display size, in device pixels for the given ratio.
+QPixmap scaleForDisplay(const QPixmap& pixmap, const ElementView& node, qreal device_pixel_ratio) {
+    QPixmap scaled = pixmap.scaled(toDevicePixels(displaySize(pixmap.size(), node), device_pixel_ratio),
+                                   Qt::KeepAspectRatio);
+    scaled.setDevicePixelRatio(device_pixel_ratio);
+    return scaled;
+}
+
+QLabel* failedImageLabel() {
+    QLabel* placeholder = new QLabel("Image not loaded");
+    noticeStyle().apply(placeholder);
+    return placeholder;
+}
+
+// How an image element is shown.
+enum class ImageState { Skipped, Ready, Pending, Failed };
+
+struct ImagePlan {
+    ImageState state = ImageState::Skipped;
+    QPixmap pixmap;        // Ready: decoded and scaled for display
+    QSize size;            // Ready and Pending: display size
+    ImageKey key;          // where the decoded pixmap is cached
+    DecodeRequest request; // Pending: decode to run, sized for display
+};
+
+// Resolves an image from the cache, or decodes it in place. With defer set,
+// an image missing from the cache is only sized from its header, so a
+// placeholder of the final size can stand in while it decodes elsewhere.
+ImagePlan planImage(const ElementView& node, qreal device_pixel_ratio, bool defer) {
+    ImagePlan plan;
+    if (node.src.empty()) return plan;
+    const std::string src(node.src);
+    try {
+        ImageKey& key = plan.key;
+        key.source = node.media && !node.media->source().empty() ? node.media->source() : src;
+        key.source_size = node.media ? node.media->size() : 0;
+        key.width = dimensionOf(node.width);
+        key.height = dimensionOf(node.height);
+        key.device_pixel_ratio = device_pixel_ratio;
+
+        // Tabs showing the same image at the same size share one decoded pixmap.
+        if (ImageCache::instance().find(key, &plan.pixmap)) {
+            plan.state = ImageState::Ready;
+            plan.size = plan.pixmap.size() / plan.pixmap.devicePixelRatio();
+            return plan;
+        }
+        const bool svg = (node.media && node.media->contentType() == "image/svg+xml") ||
+                         src.find(".svg") != std::string::npos;
+        if (defer) {
+            DecodeRequest& request = plan.request;
+            request.media = node.media;
+            request.path = src;
+            request.svg = svg;
+            QSize natural;
+            if (svg) {
+                natural = QSize(100, 100); // Default SVG size
+                if (key.width > 0) natural = QSize(key.width, natural.height());
+                if (key.height > 0) natural = QSize(natural.width(), key.height);
+            } else {
+                natural = imageSize(request);
             }
+            if (!natural.isValid() || natural.isEmpty()) {
+                plan.state = ImageState::Failed;
+                return plan;
+            }
+            plan.size = displaySize(natural, node);
+            request.target = toDevicePixels(plan.size, device_pixel_ratio);
+            plan.state = ImageState::Pending;
+            return plan;
+        }
+        QPixmap pixmap;
+        if (svg) {
+            pixmap = renderSvg(node, src);
+            if (pixmap.isNull()) return plan;
+        } else if (node.media) {
+            // Decode straight from the fetched bytes; no file round trip.
+            pixmap.loadFromData(reinterpret_cast<const uchar*>(node.media->data()),
+                                static_cast<uint>(node.media->size()));
+        } else {
+            pixmap.load(QString::fromStdString(src));
         }
-    } else if (node.type == "link") {
-        auto href_it = node.attributes.find("href");
-        if (href_it != node.attributes.end() && !href_it->second.empty() && !node.text.empty()) {
-            QLabel* link_label = new QLabel(QString::fromStdString(node.text));
-            link_label->setWordWrap(true);
-            link_label->setStyleSheet("color: #00008B; text-decoration: underline;"); // Dark blue links
-            link_label->setCursor(Qt::PointingHandCursor);
-            // Store href as property
-            link_label->setProperty("href", QString::fromStdString(href_it->second));
-            // Connect click event (handled in BrowserWindow)
-            link_label->setProperty("isLink", true);
-            layout->addWidget(link_label);
-            std::cout << "Rendering link: " << node.text << " (" << href_it->second << ")\n";
+        if (pixmap.isNull()) {
+            plan.state = ImageState::Failed;
+            return plan;
         }
+        plan.pixmap = scaleForDisplay(pixmap, node, device_pixel_ratio);
+        plan.size = plan.pixmap.size() / device_pixel_ratio;
+        ImageCache::instance().insert(key, plan.pixmap);
+        plan.state = ImageState::Ready;
+    } catch (const std::exception& e) {
+        QUICKDOM_TRACE_ERROR("Error rendering image", src, ": ", e.what());
+        plan.state = ImageState::Skipped;
     }
+    return plan;
+}
+
+// Adds a placeholder of the final size and decodes the image on the worker
+// pool; the GUI thread only reads the image header and uploads the result.
+void renderImageAsync(const ElementView& node, ImagePlan plan, QVBoxLayout* layout) {
+    QLabel* image_label = new QLabel();
+    image_label->setFixedSize(plan.size);
+    noticeStyle().apply(image_label); // for its gray box
+    layout->addWidget(image_label);
+
+    const ImageKey key = plan.key;
+    decodeAsync(*node.decodes, std::move(plan.request), image_label, [image_label, key](const QImage& image) {
+        if (image.isNull()) {
+            image_label->setText("Image not loaded");
+            QUICKDOM_TRACE_WARN("Failed to load pixmap", key.source);
+            return;
+        }
+        QPixmap pixmap = QPixmap::fromImage(image);
+        pixmap.setDevicePixelRatio(key.device_pixel_ratio);
+        ImageCache::instance().insert(key, pixmap);
+        ComputedStyle::clear(image_label);
+        image_label->setPixmap(pixmap);
+        QUICKDOM_TRACE_DEBUG("Rendering image", key.source);
+    });
+}
+
+void renderImage(const ElementView& node, QVBoxLayout* layout) {
+    QWidget* page = layout->parentWidget();
+    ImagePlan plan = planImage(node, page ? page->devicePixelRatioF() : 1.0, node.decodes != nullptr);
+    switch (plan.state) {
+    case ImageState::Ready: {
+        QLabel* image_label = new QLabel();
+        image_label->setPixmap(plan.pixmap);
+        layout->addWidget(image_label);
+        QUICKDOM_TRACE_DEBUG("Rendering image", node.src);
+        break;
+    }
+    case ImageState::Pending:
+        renderImageAsync(node, std::move(plan), layout);
+        break;
+    case ImageState::Failed:
+        layout->addWidget(failedImageLabel());
+        QUICKDOM_TRACE_WARN("Failed to load pixmap", node.src);
+        break;
+    case ImageState::Skipped:
+        break;
+    }
+}
+
+void renderLink(const ElementView& node, QVBoxLayout* layout) {
+    if (!node.href.empty() && !node.text.empty()) {
+        // A LinkLabel from the start, so callers connect to clicked() rather than swap widgets.
+        auto* link_label = new LinkLabel();
+        link_label->setText(toQString(node.text));
+        link_label->setWordWrap(true);
+        styleOf(node, TextStyle::Link)->apply(link_label);
+        link_label->setCursor(Qt::PointingHandCursor);
+        link_label->setProperty("href", toQString(node.href));
+        link_label->setProperty("isLink", true);
+        layout->addWidget(link_label);
+        QUICKDOM_TRACE_DEBUG("Rendering link", node.text, " (", node.href, ")");
+    }
+}
+
+void renderNothing(const ElementView&, QVBoxLayout*) {}
+
+using ElementRenderer = void (*)(const ElementView&, QVBoxLayout*);
+
+// Jump table indexed by TagAtom; tags without an entry render nothing.
+struct RenderTable {
+    ElementRenderer entries[kTagAtomCount];
+};
+
+constexpr RenderTable buildRenderTable() {
+    RenderTable table{};
+    for (auto& entry : table.entries) entry = renderNothing;
+    for (TagAtom tag : {TagAtom::Text, TagAtom::P, TagAtom::Div, TagAtom::Span}) {
+        table.entries[static_cast<size_t>(tag)] = renderText;
+    }
+    for (TagAtom tag : {TagAtom::H1, TagAtom::H2, TagAtom::H3, TagAtom::H4, TagAtom::H5, TagAtom::H6}) {
+        table.entries[static_cast<size_t>(tag)] = renderHeader;
+    }
+    table.entries[static_cast<size_t>(TagAtom::Img)] = renderImage;
+    table.entries[static_cast<size_t>(TagAtom::A)] = renderLink;
+    return table;
+}
+
+constexpr RenderTable kRenderTable = buildRenderTable();
+
+void renderElement(const ElementView& node, QVBoxLayout* layout) {
+    kRenderTable.entries[static_cast<size_t>(node.tag)](node, layout);
+}
+
+// What the display list counterparts of the renderers above append to.
+struct DisplayContext {
+    DisplayList* list;
+    const DisplayListOptions& options;
+};
+
+// Placeholder of a lazy image: its display size if the page gives both
+// dimensions, so nothing moves when it arrives, else a default square.
+QSize lazyPlaceholderSize(const ElementView& node) {
+    const int width = dimensionOf(node.width);
+    const int height = dimensionOf(node.height);
+    if (width > 0 && height > 0) return displaySize(QSize(width, height), node);
+    return QSize(100, 100);
+}
+
+void appendText(const ElementView& node, DisplayContext& context) {
+    if (!node.text.empty()) {
+        context.list->addText(TextStyle::Body, toQString(node.text), QString(), styleOf(node, TextStyle::Body));
+    }
+}
+
+void appendHeader(const ElementView& node, DisplayContext& context) {
+    if (!node.text.empty()) {
+        context.list->addText(TextStyle::Header, toQString(node.text), QString(), styleOf(node, TextStyle::Header));
+    }
+}
+
+void appendImage(const ElementView& node, DisplayContext& context) {
+    if (context.options.lazy_images && !node.media && !node.src.empty()) {
+        const size_t item = context.list->addImage(lazyPlaceholderSize(node));
+        context.list->addLazyImage(
+            LazyImage{item, std::string(node.src), std::string(node.width), std::string(node.height)});
+        return;
+    }
+    ImagePlan plan = planImage(node, context.options.device_pixel_ratio, context.options.defer_decodes);
+    switch (plan.state) {
+    case ImageState::Ready:
+        context.list->addImage(plan.size, plan.pixmap);
+        break;
+    case ImageState::Pending: {
+        const size_t item = context.list->addImage(plan.size);
+        context.list->addPendingImage(PendingImage{item, plan.key, std::move(plan.request)});
+        break;
+    }
+    case ImageState::Failed:
+        context.list->addText(TextStyle::Notice, "Image not loaded");
+        QUICKDOM_TRACE_WARN("Failed to load pixmap", node.src);
+        break;
+    case ImageState::Skipped:
+        break;
+    }
+}
+
+void appendLink(const ElementView& node, DisplayContext& context) {
+    if (!node.href.empty() && !node.text.empty()) {
+        context.list->addText(TextStyle::Link, toQString(node.text), toQString(node.href),
+                              styleOf(node, TextStyle::Link));
+    }
+}
+
+void appendNothing(const ElementView&, DisplayContext&) {}
+
+using ElementAppender = void (*)(const ElementView&, DisplayContext&);
+
+// Jump table indexed by TagAtom, like RenderTable.
+struct DisplayTable {
+    ElementAppender entries[kTagAtomCount];
+};
+
+constexpr DisplayTable buildDisplayTable() {
+    DisplayTable table{};
+    for (auto& entry : table.entries) entry = appendNothing;
+    for (TagAtom tag : {TagAtom::Text, TagAtom::P, TagAtom::Div, TagAtom::Span}) {
+        table.entries[static_cast<size_t>(tag)] = appendText;
+    }
+    for (TagAtom tag : {TagAtom::H1, TagAtom::H2, TagAtom::H3, TagAtom::H4, TagAtom::H5, TagAtom::H6}) {
+        table.entries[static_cast<size_t>(tag)] = appendHeader;
+    }
+    table.entries[static_cast<size_t>(TagAtom::Img)] = appendImage;
+    table.entries[static_cast<size_t>(TagAtom::A)] = appendLink;
+    return table;
+}
+
+constexpr DisplayTable kDisplayTable = buildDisplayTable();
+
+ElementView viewOf(const Document& document, NodeId id, const MediaMap* media) {
+    ElementView view;
+    view.tag = document.node(id).tag;
+    view.text = document.text(id);
+    view.src = document.attribute(id, "src");
+    view.width = document.attribute(id, "width");
+    view.height = document.attribute(id, "height");
+    view.href = document.attribute(id, "href");
+    view.style = document.attribute(id, "style");
+    if (media && view.tag == TagAtom::Img && !view.src.empty()) {
+        auto it = media->find(std::string(view.src));
+        if (it != media->end()) view.media = it->second;
+    }
+    return view;
+}
+
+} // namespace
+
+void Renderer::render(const Node& node, QVBoxLayout* layout) {
+    ElementView view;
+    view.tag = tagFromNodeType(node.type);
+    view.text = node.text;
+    view.src = attributeOf(node, "src");
+    view.width = attributeOf(node, "width");
+    view.height = attributeOf(node, "height");
+    view.href = attributeOf(node, "href");
+    view.style = attributeOf(node, "style");
+    renderElement(view, layout);
 
     for (const auto& child : node.children) {
         render(child, layout);
     }
+}
+
+void Renderer::render(const Document& document, QVBoxLayout* layout, const MediaMap* media,
+                      const DecodeGroupPtr& decodes) {
+    render(document, document.root(), layout, media, decodes);
+}
+
+void Renderer::render(const Document& document, NodeId id, QVBoxLayout* layout, const MediaMap* media,
+                      const DecodeGroupPtr& decodes) {
+    ElementView view = viewOf(document, id, media);
+    if (decodes) view.decodes = &decodes;
+    renderElement(view, layout);
+
+    for (NodeId child = document.node(id).first_child; child != kNoNode;
+         child = document.node(child).next_sibling) {
+        render(document, child, layout, media, decodes);
+    }
+}
+
+DisplayList Renderer::buildDisplayList(const Document& document, const MediaMap* media,
+                                       const DisplayListOptions& options) {
+    DisplayList list;
+    DisplayContext context{&list, options};
+    // Pre-order with an explicit stack; page depth is not bounded by ours.
+    std::vector<NodeId> stack{document.root()};
+    std::vector<NodeId> children;
+    while (!stack.empty()) {
+        const NodeId id = stack.back();
+        stack.pop_back();
+        const ElementView view = viewOf(document, id, media);
+        kDisplayTable.entries[static_cast<size_t>(view.tag)](view, context);
+
+        children.clear();
+        for (NodeId child = document.node(id).first_child; child != kNoNode;
+             child = document.node(child).next_sibling) {
+            children.push_back(child);
+        }
+        stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
+    return list;
+}
+
+void Renderer::resolveLazyImage(DisplayList* list, const LazyImage& lazy, const MediaBufferPtr& media,
+                                qreal device_pixel_ratio) {
+    ElementView view;
+    view.tag = TagAtom::Img;
+    view.src = lazy.src;
+    view.width = lazy.width;
+    view.height = lazy.height;
+    view.media = media;
+    ImagePlan plan;
+    if (media) plan = planImage(view, device_pixel_ratio, true);
+    switch (plan.state) {
+    case ImageState::Ready:
+        list->setImageSize(lazy.item, plan.size);
+        list->setPixmap(lazy.item, plan.pixmap);
+        break;
+    case ImageState::Pending:
+        list->setImageSize(lazy.item, plan.size);
+        list->addPendingImage(PendingImage{lazy.item, plan.key, std::move(plan.request)});
+        break;
+    case ImageState::Failed:
+    case ImageState::Skipped:
+        list->setText(lazy.item, TextStyle::Notice, "Image not loaded");
+        QUICKDOM_TRACE_WARN("Failed to load pixmap", lazy.src);
+        break;
+    }
 }
\ No newline at end of file
@@ -5,12 +5,31 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "display_list.h"
 #include "html_parser.h"
+#include "image_decoder.h"
+#include "media_buffer.h"
 #include <QVBoxLayout>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Fetched media keyed by the src value that referenced it.
+ */
+using MediaMap = std::unordered_map<std::string, MediaBufferPtr>;
+
+/**
+ * @brief How Renderer::buildDisplayList() treats images.
+ */
+struct DisplayListOptions {
+    bool defer_decodes = false;     // leave uncached images to DisplayList::pendingImages()
+    bool lazy_images = false;       // leave images without fetched bytes to DisplayList::lazyImages()
+    qreal device_pixel_ratio = 1.0; // of the screen the page is shown on
+};
 
 /**
  * @class Renderer
- * @brief Renders DOM nodes into Qt widgets.
+ * @brief Renders DOM nodes into Qt widgets, or into a display list for PageView.
  */
 class Renderer {
 public:
@@ -20,6 +39,55 @@ public:
      * @param layout Target layout.
      */
     void render(const Node& node, QVBoxLayout* layout);
+
+    /**
+     * @brief Renders a parsed document into a layout.
+     * @param document Document to render, read in place without conversion.
+     * @param layout Target layout.
+     * @param media Image bytes to decode in memory; images missing from it
+     *        are loaded from their src path.
+     * @param decodes When set, images not yet cached get a placeholder of their
+     *        final size and are decoded on the worker pool; cancelling the group
+     *        drops the decodes still pending. Otherwise images decode in place.
+     */
+    void render(const Document& document, QVBoxLayout* layout, const MediaMap* media = nullptr,
+                const DecodeGroupPtr& decodes = nullptr);
+
+    /**
+     * @brief Builds the display list of a parsed document.
+     *
+     * One item per text block, link or image, in document order; the list is
+     * laid out and painted by PageView without a widget per element.
+     * @param document Document to render, read in place without conversion.
+     * @param media Image bytes to decode in memory; images missing from it
+     *        are loaded from their src path, or left to be fetched on demand.
+     * @param options With defer_decodes, images not yet cached get a
+     *        placeholder of their final size and are listed in
+     *        DisplayList::pendingImages(); otherwise they decode in place.
+     *        With lazy_images, images missing from media get a placeholder
+     *        sized from their width and height attributes and are listed in
+     *        DisplayList::lazyImages().
+     */
+    DisplayList buildDisplayList(const Document& document, const MediaMap* media = nullptr,
+                                 const DisplayListOptions& options = DisplayListOptions());
+
+    /**
+     * @brief Fills in a lazy image once its bytes are fetched.
+     *
+     * The placeholder takes the image's display size, which changes the layout
+     * only if the page gave no width and height. An image not yet cached is
+     * added to DisplayList::pendingImages() for decoding.
+     * @param list List the image belongs to.
+     * @param lazy The image, from list->lazyImages().
+     * @param media Fetched bytes; nullptr if the fetch failed.
+     * @param device_pixel_ratio Ratio of the screen the page is shown on.
+     */
+    static void resolveLazyImage(DisplayList* list, const LazyImage& lazy, const MediaBufferPtr& media,
+                                 qreal device_pixel_ratio);
+
+private:
+    void render(const Document& document, NodeId id, QVBoxLayout* layout, const MediaMap* media,
+                const DecodeGroupPtr& decodes);
 };
 
 #endif
\ No newline at end of file
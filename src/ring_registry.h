@@ -0,0 +1,127 @@
+/**
+ * @file ring_registry.h
+ * @brief Defines the registry of per-thread rings and the thread that drains
+ *        it periodically, shared by the tracer and the timeline.
+ */
+#ifndef RING_REGISTRY_H
+#define RING_REGISTRY_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trace_detail {
+
+/**
+ * Rings of all threads that ever recorded into a registry. Producers only
+ * take the mutex on their first record; consumers hold it while draining,
+ * and the owner may guard its own state with it too. A ring whose thread has
+ * exited is freed once drained, and its drop count is kept.
+ *
+ * There is one registry per ring type, created once and never destroyed, so
+ * it outlives the thread-local ring owners.
+ */
+template <typename Ring>
+class RingRegistry {
+public:
+    std::mutex mutex;
+
+    // Returns the calling thread's ring, registering it on first use.
+    Ring& localRing() {
+        thread_local Owner owner;
+        if (!owner.ring) {
+            std::lock_guard<std::mutex> lock(mutex);
+            owner.ring = std::make_shared<Ring>(next_thread_++);
+            rings_.push_back(owner.ring);
+        }
+        return *owner.ring;
+    }
+
+    // Calls fn for every record of every ring, then frees retired rings.
+    // The caller holds the mutex.
+    template <typename Fn>
+    void drainLocked(Fn&& fn) {
+        for (const auto& ring : rings_) ring->drain(fn);
+        auto retired = std::remove_if(rings_.begin(), rings_.end(), [this](const auto& ring) {
+            if (!ring->retired.load(std::memory_order_acquire) || !ring->empty()) return false;
+            retired_dropped_ += ring->dropped();
+            return true;
+        });
+        rings_.erase(retired, rings_.end());
+    }
+
+    // Returns how many records all rings, freed or not, dropped. The caller holds the mutex.
+    uint64_t droppedLocked() const {
+        uint64_t dropped = retired_dropped_;
+        for (const auto& ring : rings_) dropped += ring->dropped();
+        return dropped;
+    }
+
+private:
+    // Marks the ring retired when its thread exits.
+    struct Owner {
+        std::shared_ptr<Ring> ring;
+        ~Owner() {
+            if (ring) ring->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    std::vector<std::shared_ptr<Ring>> rings_;
+    uint32_t next_thread_ = 1;
+    uint64_t retired_dropped_ = 0;
+};
+
+/**
+ * Background thread that calls a drain function at a fixed interval, and
+ * once more when stopped. One still running at exit is stopped rather than
+ * left joinable.
+ */
+class DrainThread {
+public:
+    DrainThread() = default;
+    ~DrainThread() { stop(); }
+    DrainThread(const DrainThread&) = delete;
+    DrainThread& operator=(const DrainThread&) = delete;
+
+    // Does nothing if the thread is already running.
+    void start(std::chrono::milliseconds interval, void (*drain)()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (thread_.joinable()) return;
+        stop_ = false;
+        thread_ = std::thread([this, interval, drain] {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_) {
+                wake_.wait_for(lock, interval, [this] { return stop_; });
+                lock.unlock();
+                drain();
+                lock.lock();
+            }
+        });
+    }
+
+    void stop() {
+        std::thread thread;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            thread = std::move(thread_);
+        }
+        wake_.notify_all();
+        if (thread.joinable()) thread.join();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    bool stop_ = false;
+};
+
+} // namespace trace_detail
+
+#endif // RING_REGISTRY_H
\ No newline at end of file
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# Script to build and run QuickDOM benchmarks
+# Arguments are passed to the benchmark binary, e.g.
+#   ./run_bench.sh --benchmark_filter='parse/.*/1MB' --benchmark_out=after.json
+
+set -e
+
+SRC_DIR="$(pwd)"
+BENCH_DIR="$(dirname "$SRC_DIR")/bench"
+BUILD_DIR="$BENCH_DIR/build"
+BENCH_BINARY="$BUILD_DIR/quickdom_bench"
+
+# Ensure src and bench directories exist
+if [ ! -d "$BENCH_DIR" ]; then
+    echo "Error: Benchmark directory $BENCH_DIR does not exist."
+    exit 1
+fi
+
+# Create build directory
+mkdir -p "$BUILD_DIR"
+
+# Navigate to source directory
+cd "$SRC_DIR"
+
+# Run qmake for benchmark configuration
+echo "Running qmake for benchmark configuration..."
+qmake CONFIG+=bench browser.pro
+
+# Build the benchmarks
+echo "Building benchmarks..."
+make -j$(sysctl -n hw.ncpu)
+
+# Check if benchmark binary exists
+if [ ! -f "$BENCH_BINARY" ]; then
+    echo "Error: Benchmark binary $BENCH_BINARY not found."
+    exit 1
+fi
+
+# Run the benchmarks
+echo "Running benchmarks..."
+"$BENCH_BINARY" "$@"
+
+# Clean up
+make clean
+rm -f Makefile
\ No newline at end of file
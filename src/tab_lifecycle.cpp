@@ -0,0 +1,184 @@
+/**
+ * @file tab_lifecycle.cpp
+ * @brief Implements memory monitoring and the tab hibernation policy.
+ */
+#include "tab_lifecycle.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+// cgroup v1 reports "no limit" as a page-rounded LONG_MAX.
+constexpr unsigned long long kUnlimited = 1ull << 60;
+
+bool readFile(const std::string& path, std::string* text) {
+    std::ifstream file(path);
+    if (!file) return false;
+    text->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Reads a byte count; "max" and v1's near-LONG_MAX mean unlimited and give 0.
+bool readBytes(const std::string& path, size_t* bytes) {
+    std::string text;
+    if (!readFile(path, &text)) return false;
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) {
+        if (text.compare(0, 3, "max") != 0) return false;
+        *bytes = 0;
+        return true;
+    }
+    *bytes = value >= kUnlimited ? 0 : static_cast<size_t>(value);
+    return true;
+}
+
+// Parses "key=value" fields of a pressure line; returns avg10.
+bool parseAvg10(std::string_view line, double* avg10) {
+    const size_t pos = line.find("avg10=");
+    if (pos == std::string_view::npos) return false;
+    const std::string value(line.substr(pos + 6, line.find(' ', pos) - pos - 6));
+    char* end = nullptr;
+    *avg10 = std::strtod(value.c_str(), &end);
+    return end != value.c_str();
+}
+
+} // namespace
+
+MemoryMonitor::MemoryMonitor(std::string root) : root_(std::move(root)) {}
+
+bool MemoryMonitor::parsePressure(std::string_view text, double* some, double* full) {
+    bool found = false;
+    *some = *full = 0.0;
+    while (!text.empty()) {
+        const size_t end = std::min(text.find('\n'), text.size());
+        const std::string_view line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+        if (line.compare(0, 5, "some ") == 0) {
+            found = parseAvg10(line, some);
+        } else if (line.compare(0, 5, "full ") == 0) {
+            parseAvg10(line, full);
+        }
+    }
+    return found;
+}
+
+MemoryStatus MemoryMonitor::sample() const {
+    MemoryStatus status;
+    std::string text;
+    if (readFile(root_ + "/proc/pressure/memory", &text)) {
+        parsePressure(text, &status.pressure_some, &status.pressure_full);
+    }
+
+    // Find this process's cgroup: "0::/path" for v2, "N:memory:/path" for v1.
+    std::string v2_path, v1_path;
+    bool v2 = false, v1 = false;
+    if (readFile(root_ + "/proc/self/cgroup", &text)) {
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            const size_t first = line.find(':');
+            const size_t second = line.find(':', first + 1);
+            if (first == std::string::npos || second == std::string::npos) continue;
+            const std::string controllers = line.substr(first + 1, second - first - 1);
+            const std::string path = line.substr(second + 1);
+            if (line.compare(0, first, "0") == 0 && controllers.empty()) {
+                v2 = true;
+                v2_path = path == "/" ? "" : path;
+            } else if (controllers.find("memory") != std::string::npos) {
+                v1 = true;
+                v1_path = path == "/" ? "" : path;
+            }
+        }
+    }
+    // Inside a container the cgroup is often mounted at the root of the
+    // hierarchy, so fall back to the top-level files.
+    const std::string cgroup = root_ + "/sys/fs/cgroup";
+    auto readLimit = [&](const std::string& dir, const char* limit, const char* usage) {
+        return readBytes(dir + "/" + limit, &status.cgroup_limit) && readBytes(dir + "/" + usage, &status.cgroup_usage);
+    };
+    if (v1 && (readLimit(cgroup + "/memory" + v1_path, "memory.limit_in_bytes", "memory.usage_in_bytes") ||
+               readLimit(cgroup + "/memory", "memory.limit_in_bytes", "memory.usage_in_bytes"))) {
+        return status;
+    }
+    if (v2 && !readLimit(cgroup + v2_path, "memory.max", "memory.current")) {
+        readLimit(cgroup, "memory.max", "memory.current");
+    }
+    return status;
+}
+
+TabLifecycle::TabLifecycle(TabLifecycleOptions options) : options_(options) {}
+
+void TabLifecycle::touch(uint64_t tab) {
+    TabState& state = tabs_[tab];
+    state.last_used = ++clock_;
+    state.live = true;
+}
+
+void TabLifecycle::setFootprint(uint64_t tab, size_t bytes) {
+    auto it = tabs_.find(tab);
+    if (it != tabs_.end() && it->second.live) it->second.footprint = bytes;
+}
+
+void TabLifecycle::hibernated(uint64_t tab) {
+    auto it = tabs_.find(tab);
+    if (it == tabs_.end()) return;
+    it->second.live = false;
+    it->second.footprint = 0;
+}
+
+void TabLifecycle::remove(uint64_t tab) {
+    tabs_.erase(tab);
+}
+
+bool TabLifecycle::isLive(uint64_t tab) const {
+    auto it = tabs_.find(tab);
+    return it != tabs_.end() && it->second.live;
+}
+
+size_t TabLifecycle::liveBytes() const {
+    size_t total = 0;
+    for (const auto& entry : tabs_) total += entry.second.live ? entry.second.footprint : 0;
+    return total;
+}
+
+bool TabLifecycle::underPressure(const MemoryStatus& status) const {
+    return status.pressure_some >= options_.pressure_threshold;
+}
+
+std::vector<uint64_t> TabLifecycle::selectVictims(const MemoryStatus& status) const {
+    // Bytes to release: the budget overrun, or what brings the cgroup back
+    // under its high-water mark, whichever is more.
+    const size_t live = liveBytes();
+    size_t excess = live > options_.budget_bytes ? live - options_.budget_bytes : 0;
+    if (status.cgroup_limit > 0) {
+        const size_t high_water = static_cast<size_t>(static_cast<double>(status.cgroup_limit) *
+                                                      options_.cgroup_high_water);
+        if (status.cgroup_usage > high_water) excess = std::max(excess, status.cgroup_usage - high_water);
+    }
+    if (excess == 0 && underPressure(status)) excess = 1; // release one tab per check
+    if (excess == 0) return {};
+
+    std::vector<std::pair<uint64_t, uint64_t>> candidates; // last_used, tab
+    for (const auto& entry : tabs_) {
+        if (entry.second.live) candidates.emplace_back(entry.second.last_used, entry.first);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    const size_t hibernatable = candidates.size() > options_.min_live_tabs
+                                    ? candidates.size() - options_.min_live_tabs
+                                    : 0;
+
+    std::vector<uint64_t> victims;
+    size_t released = 0;
+    for (size_t i = 0; i < hibernatable && released < excess; ++i) {
+        const size_t footprint = tabs_.at(candidates[i].second).footprint;
+        if (footprint == 0) continue; // nothing to gain, e.g. still loading
+        victims.push_back(candidates[i].second);
+        released += footprint;
+    }
+    return victims;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * @file tab_lifecycle.h
+ * @brief Defines memory monitoring and the policy deciding which tabs hibernate.
+ */
+#ifndef TAB_LIFECYCLE_H
+#define TAB_LIFECYCLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief System memory state as seen by this process.
+ */
+struct MemoryStatus {
+    double pressure_some = 0.0; // % of the last 10 s some task stalled on memory
+    double pressure_full = 0.0; // % of the last 10 s all tasks stalled on memory
+    size_t cgroup_limit = 0;    // bytes; 0 if unlimited or unknown
+    size_t cgroup_usage = 0;    // bytes charged to the cgroup
+};
+
+/**
+ * @class MemoryMonitor
+ * @brief Samples Linux pressure stall information and cgroup memory limits.
+ *
+ * Reads /proc/pressure/memory and the memory controller of the process's
+ * cgroup, v2 (memory.max, memory.current) or v1 (memory.limit_in_bytes,
+ * memory.usage_in_bytes). Missing files, as on other systems or older
+ * kernels, leave the corresponding fields at zero.
+ */
+class MemoryMonitor {
+public:
+    /**
+     * @brief Creates a monitor.
+     * @param root Prefix for /proc and /sys paths, for tests; empty for the real ones.
+     */
+    explicit MemoryMonitor(std::string root = "");
+
+    /**
+     * @brief Reads the current memory status; a few small file reads.
+     */
+    MemoryStatus sample() const;
+
+    /**
+     * @brief Parses the avg10 values of a /proc/pressure/memory listing.
+     * @return False if the "some" line is missing or malformed.
+     */
+    static bool parsePressure(std::string_view text, double* some, double* full);
+
+private:
+    std::string root_;
+};
+
+/**
+ * @brief Limits a TabLifecycle enforces.
+ */
+struct TabLifecycleOptions {
+    size_t budget_bytes = 512u << 20; // footprint of all live tabs together
+    double pressure_threshold = 10.0; // "some" stall % that counts as pressure
+    double cgroup_high_water = 0.9;   // share of the cgroup limit that counts as pressure
+    size_t min_live_tabs = 1;         // most recently used tabs never hibernated
+};
+
+/**
+ * @class TabLifecycle
+ * @brief Tracks live tabs' footprints and recency and picks tabs to hibernate.
+ *
+ * Tabs are hibernated least recently used first, and only while the live
+ * tabs exceed the budget or the system reports memory pressure; tabs the
+ * user keeps returning to stay live. Under pressure with the budget met,
+ * one tab is released per check so the process backs off gradually.
+ */
+class TabLifecycle {
+public:
+    explicit TabLifecycle(TabLifecycleOptions options = TabLifecycleOptions());
+
+    /**
+     * @brief Marks a tab as just used; unknown tabs become live.
+     */
+    void touch(uint64_t tab);
+
+    /**
+     * @brief Records a live tab's estimated footprint in bytes.
+     */
+    void setFootprint(uint64_t tab, size_t bytes);
+
+    /**
+     * @brief Marks a tab as hibernated; it no longer counts against the budget.
+     */
+    void hibernated(uint64_t tab);
+
+    /**
+     * @brief Forgets a tab.
+     */
+    void remove(uint64_t tab);
+
+    bool isLive(uint64_t tab) const;
+
+    /**
+     * @brief Returns the total footprint of the live tabs.
+     */
+    size_t liveBytes() const;
+
+    /**
+     * @brief Picks the tabs to hibernate now, least recently used first.
+     * @param status Current memory status, e.g. from MemoryMonitor::sample().
+     */
+    std::vector<uint64_t> selectVictims(const MemoryStatus& status) const;
+
+    const TabLifecycleOptions& options() const { return options_; }
+    void setBudget(size_t bytes) { options_.budget_bytes = bytes; }
+
+private:
+    struct TabState {
+        uint64_t last_used = 0;
+        size_t footprint = 0;
+        bool live = true;
+    };
+
+    bool underPressure(const MemoryStatus& status) const;
+
+    TabLifecycleOptions options_;
+    uint64_t clock_ = 0;
+    std::unordered_map<uint64_t, TabState> tabs_;
+};
+
+#endif // TAB_LIFECYCLE_H
\ No newline at end of file
@@ -0,0 +1,374 @@
+/**
+ * @file tab_snapshot.cpp
+ * @brief Implements tab snapshot encoding and the snapshot store.
+ */
+#include "tab_snapshot.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include "trace.h"
+
+namespace {
+
+// "QDSN", a format version and a flags byte precede the payload.
+constexpr char kMagic[4] = {'Q', 'D', 'S', 'N'};
+constexpr uint8_t kVersion = 1;
+constexpr uint8_t kCompressed = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2;
+constexpr size_t kMinCompressBytes = 512;     // smaller payloads rarely shrink
+constexpr size_t kMaxPayloadBytes = 1u << 30; // refuse to inflate beyond this
+
+class Writer {
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<char>(value));
+    }
+
+    void bytes(std::string_view value) {
+        varint(value.size());
+        out_.append(value.data(), value.size());
+    }
+
+    std::string& str() { return out_; }
+
+private:
+    std::string out_;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view in) : in_(in) {}
+
+    bool varint(uint64_t* value) {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= in_.size()) return false;
+            const uint8_t byte = static_cast<uint8_t>(in_[pos_++]);
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reads a varint that must not exceed limit.
+    bool bounded(uint64_t limit, uint64_t* value) { return varint(value) && *value <= limit; }
+
+    bool bytes(std::string_view* value) {
+        uint64_t size = 0;
+        if (!bounded(in_.size() - pos_, &size)) return false;
+        *value = in_.substr(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool done() const { return pos_ == in_.size(); }
+
+private:
+    std::string_view in_;
+    size_t pos_ = 0;
+};
+
+// Deduplicating table of the strings the document's nodes use.
+class StringPool {
+public:
+    TextRange add(std::string_view value) {
+        if (value.empty()) return TextRange{};
+        auto it = ranges_.find(value);
+        if (it != ranges_.end()) return it->second;
+        TextRange range{static_cast<uint32_t>(data_.size()), static_cast<uint32_t>(value.size())};
+        data_.append(value.data(), value.size());
+        ranges_.emplace(value, range); // views into the document, which outlives the pool
+        return range;
+    }
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+    std::unordered_map<std::string_view, TextRange> ranges_;
+};
+
+// One node in document order; ranges point into the string pool.
+struct NodeRecord {
+    TagAtom tag;
+    TextRange text;
+    std::vector<std::pair<TextRange, TextRange>> attributes;
+    uint64_t child_count;
+};
+
+void writeRange(Writer& out, TextRange range) {
+    out.varint(range.offset);
+    out.varint(range.length);
+}
+
+bool readRange(Reader& in, size_t pool_size, TextRange* range) {
+    uint64_t offset = 0, length = 0;
+    if (!in.bounded(pool_size, &offset) || !in.bounded(pool_size - offset, &length)) return false;
+    *range = TextRange{static_cast<uint32_t>(offset), static_cast<uint32_t>(length)};
+    return true;
+}
+
+std::string encodeDocument(const Document& document) {
+    // Pool the strings first; the records refer to them by range.
+    StringPool pool;
+    std::vector<NodeRecord> records;
+    records.reserve(document.nodeCount());
+    document.forEachNode([&](NodeId id) {
+        NodeRecord record{document.node(id).tag, pool.add(document.text(id)), {}, 0};
+        for (size_t a = 0; a < document.attributeCount(id); ++a) {
+            record.attributes.emplace_back(pool.add(document.attributeName(id, a)),
+                                           pool.add(document.attributeValue(id, a)));
+        }
+        for (NodeId child = document.node(id).first_child; child != kNoNode;
+             child = document.node(child).next_sibling) {
+            ++record.child_count;
+        }
+        records.push_back(std::move(record));
+    });
+
+    Writer out;
+    out.bytes(pool.data());
+    out.varint(records.size());
+    for (const NodeRecord& record : records) {
+        out.varint(static_cast<uint64_t>(record.tag));
+        writeRange(out, record.text);
+        out.varint(record.attributes.size());
+        for (const auto& attribute : record.attributes) {
+            writeRange(out, attribute.first);
+            writeRange(out, attribute.second);
+        }
+        out.varint(record.child_count);
+    }
+    return std::move(out.str());
+}
+
+bool decodeDocument(Reader& in, Document* document) {
+    std::string_view pool;
+    uint64_t node_count = 0;
+    if (!in.bytes(&pool) || !in.bounded(std::numeric_limits<NodeId>::max() - 1, &node_count) || node_count == 0) {
+        return false;
+    }
+    Document result{std::string(pool)};
+
+    // Frames count the children still to read under each open node.
+    struct Frame {
+        NodeId parent;
+        uint64_t remaining;
+    };
+    std::vector<Frame> stack;
+    for (uint64_t i = 0; i < node_count; ++i) {
+        while (!stack.empty() && stack.back().remaining == 0) stack.pop_back();
+        if (i > 0 && stack.empty()) return false; // more records than the tree holds
+
+        uint64_t tag = 0, attribute_count = 0, child_count = 0;
+        TextRange text;
+        if (!in.bounded(kTagAtomCount - 1, &tag) || !readRange(in, pool.size(), &text)) return false;
+        NodeId id = result.root();
+        if (i > 0) {
+            --stack.back().remaining;
+            id = result.appendChild(stack.back().parent, static_cast<TagAtom>(tag));
+        }
+        result.setText(id, text.offset, text.length);
+        if (!in.bounded(std::numeric_limits<uint32_t>::max(), &attribute_count)) return false;
+        for (uint64_t a = 0; a < attribute_count; ++a) {
+            TextRange name, value;
+            if (!readRange(in, pool.size(), &name) || !readRange(in, pool.size(), &value)) return false;
+            result.addAttribute(id, name, value);
+        }
+        if (!in.bounded(node_count - 1 - i, &child_count)) return false;
+        if (child_count > 0) stack.push_back({id, child_count});
+    }
+    for (const Frame& frame : stack) {
+        if (frame.remaining != 0) return false; // fewer records than announced
+    }
+    *document = std::move(result);
+    return true;
+}
+
+} // namespace
+
+std::string encodeSnapshot(const TabSnapshot& snapshot, bool compress) {
+    Writer payload;
+    payload.bytes(snapshot.url);
+    payload.varint(static_cast<uint32_t>(std::max(0, snapshot.scroll_x)));
+    payload.varint(static_cast<uint32_t>(std::max(0, snapshot.scroll_y)));
+    payload.varint(snapshot.media.size());
+    for (const MediaReference& media : snapshot.media) {
+        payload.bytes(media.src);
+        payload.bytes(media.url);
+    }
+    payload.str() += encodeDocument(snapshot.document);
+    const std::string& raw = payload.str();
+
+    std::string out(kMagic, sizeof(kMagic));
+    out.push_back(static_cast<char>(kVersion));
+    if (compress && raw.size() >= kMinCompressBytes) {
+        uLongf packed_size = compressBound(static_cast<uLong>(raw.size()));
+        std::string packed(packed_size, '\0');
+        if (compress2(reinterpret_cast<Bytef*>(&packed[0]), &packed_size, reinterpret_cast<const Bytef*>(raw.data()),
+                      static_cast<uLong>(raw.size()), Z_BEST_SPEED) == Z_OK &&
+            packed_size < raw.size()) {
+            out.push_back(static_cast<char>(kCompressed));
+            Writer size;
+            size.varint(raw.size());
+            out += size.str();
+            out.append(packed.data(), packed_size);
+            return out;
+        }
+    }
+    out.push_back(0);
+    out += raw;
+    return out;
+}
+
+bool decodeSnapshot(std::string_view bytes, TabSnapshot* snapshot) {
+    if (bytes.size() < kHeaderSize || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0 ||
+        static_cast<uint8_t>(bytes[sizeof(kMagic)]) != kVersion) {
+        return false;
+    }
+    const uint8_t flags = static_cast<uint8_t>(bytes[sizeof(kMagic) + 1]);
+    std::string_view payload = bytes.substr(kHeaderSize);
+    std::string inflated;
+    if (flags & kCompressed) {
+        Reader header(payload);
+        uint64_t raw_size = 0;
+        if (!header.bounded(kMaxPayloadBytes, &raw_size)) return false;
+        Writer size;
+        size.varint(raw_size);
+        payload.remove_prefix(size.str().size());
+        inflated.resize(raw_size);
+        uLongf inflated_size = static_cast<uLongf>(raw_size);
+        if (uncompress(reinterpret_cast<Bytef*>(&inflated[0]), &inflated_size,
+                       reinterpret_cast<const Bytef*>(payload.data()), static_cast<uLong>(payload.size())) != Z_OK ||
+            inflated_size != raw_size) {
+            return false;
+        }
+        payload = inflated;
+    }
+
+    Reader in(payload);
+    TabSnapshot result;
+    std::string_view url;
+    uint64_t scroll_x = 0, scroll_y = 0, media_count = 0;
+    const uint64_t max_int = static_cast<uint64_t>(std::numeric_limits<int>::max());
+    if (!in.bytes(&url) || !in.bounded(max_int, &scroll_x) || !in.bounded(max_int, &scroll_y) ||
+        !in.bounded(payload.size(), &media_count)) {
+        return false;
+    }
+    result.url = std::string(url);
+    result.scroll_x = static_cast<int>(scroll_x);
+    result.scroll_y = static_cast<int>(scroll_y);
+    for (uint64_t i = 0; i < media_count; ++i) {
+        std::string_view src, media_url;
+        if (!in.bytes(&src) || !in.bytes(&media_url)) return false;
+        result.media.push_back(MediaReference{std::string(src), std::string(media_url)});
+    }
+    if (!decodeDocument(in, &result.document) || !in.done()) return false;
+    *snapshot = std::move(result);
+    return true;
+}
+
+SnapshotStore::SnapshotStore(std::string spill_dir, size_t memory_budget)
+    : spill_dir_(std::move(spill_dir)), memory_budget_(memory_budget) {}
+
+SnapshotStore::~SnapshotStore() {
+    for (const Entry& entry : entries_) {
+        if (entry.spilled) std::remove(pathOf(entry.id).c_str());
+    }
+}
+
+std::string SnapshotStore::pathOf(uint64_t id) const {
+    return spill_dir_ + "/tab_" + std::to_string(id) + ".snap";
+}
+
+void SnapshotStore::put(uint64_t id, std::string bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(id);
+    if (it != index_.end()) erase(it->second);
+    memory_bytes_ += bytes.size();
+    entries_.push_front(Entry{id, std::move(bytes)});
+    index_[id] = entries_.begin();
+    spill();
+}
+
+bool SnapshotStore::take(uint64_t id, std::string* bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(id);
+    if (it == index_.end()) return false;
+    bool ok = true;
+    if (it->second->spilled) {
+        std::ifstream file(pathOf(id), std::ios::binary);
+        bytes->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        ok = !file.bad() && !bytes->empty();
+        if (!ok) QUICKDOM_TRACE_WARN("Failed to read spilled snapshot", pathOf(id));
+    } else {
+        memory_bytes_ -= it->second->bytes.size();
+        bytes->clear();
+        bytes->swap(it->second->bytes); // leaves the entry empty for erase()
+    }
+    erase(it->second);
+    return ok;
+}
+
+bool SnapshotStore::contains(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(id) != 0;
+}
+
+void SnapshotStore::remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(id);
+    if (it != index_.end()) erase(it->second);
+}
+
+size_t SnapshotStore::memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_bytes_;
+}
+
+size_t SnapshotStore::spilledCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spilled_count_;
+}
+
+void SnapshotStore::erase(EntryList::iterator it) {
+    if (it->spilled) {
+        std::remove(pathOf(it->id).c_str());
+        --spilled_count_;
+    } else {
+        memory_bytes_ -= it->bytes.size();
+    }
+    index_.erase(it->id);
+    entries_.erase(it);
+}
+
+void SnapshotStore::spill() {
+    // Walk from the oldest; snapshots that cannot be written stay in memory.
+    for (auto it = entries_.rbegin(); it != entries_.rend() && memory_bytes_ > memory_budget_; ++it) {
+        if (it->spilled) continue;
+        std::error_code error;
+        std::filesystem::create_directories(spill_dir_, error);
+        std::ofstream file(pathOf(it->id), std::ios::binary | std::ios::trunc);
+        file.write(it->bytes.data(), static_cast<std::streamsize>(it->bytes.size()));
+        if (!file) {
+            QUICKDOM_TRACE_WARN("Failed to spill snapshot", pathOf(it->id));
+            continue;
+        }
+        memory_bytes_ -= it->bytes.size();
+        std::string().swap(it->bytes);
+        it->spilled = true;
+        ++spilled_count_;
+    }
+}
\ No newline at end of file
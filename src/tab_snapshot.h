@@ -0,0 +1,129 @@
+/**
+ * @file tab_snapshot.h
+ * @brief Defines compact binary snapshots of hibernated tabs and their store.
+ */
+#ifndef TAB_SNAPSHOT_H
+#define TAB_SNAPSHOT_H
+
+#include "dom.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An image of a hibernated page, restored from the media cache.
+ */
+struct MediaReference {
+    std::string src; // src value the page used
+    std::string url; // resolved URL the media cache knows it by
+};
+
+/**
+ * @brief Everything needed to show a tab again without network or parse work.
+ */
+struct TabSnapshot {
+    std::string url;
+    Document document;
+    std::vector<MediaReference> media;
+    int scroll_x = 0;
+    int scroll_y = 0;
+};
+
+/**
+ * @brief Serializes a snapshot.
+ *
+ * Only the strings the nodes use are kept, each distinct string once, so the
+ * result is usually a fraction of the page source. Nodes are written in
+ * document order as varint records.
+ * @param snapshot Snapshot to write.
+ * @param compress Deflate the payload when that makes it smaller.
+ * @return The encoded bytes.
+ */
+std::string encodeSnapshot(const TabSnapshot& snapshot, bool compress = true);
+
+/**
+ * @brief Rebuilds a snapshot written by encodeSnapshot().
+ *
+ * The string table becomes the source of the rebuilt document, so decoding
+ * allocates little beyond the arena.
+ * @return False if the bytes are truncated, corrupt or of another version.
+ */
+bool decodeSnapshot(std::string_view bytes, TabSnapshot* snapshot);
+
+/**
+ * @class SnapshotStore
+ * @brief Holds encoded tab snapshots in memory and spills the oldest to disk.
+ *
+ * Snapshots stay in memory up to a byte budget; beyond it the least recently
+ * stored ones are written to the spill directory and read back on take().
+ * Spilled files are removed when taken and when the store is destroyed.
+ * Thread-safe.
+ */
+class SnapshotStore {
+public:
+    /**
+     * @brief Creates a store.
+     * @param spill_dir Directory for spilled snapshots, created on demand.
+     * @param memory_budget Bytes kept in memory before spilling.
+     */
+    explicit SnapshotStore(std::string spill_dir = "snapshots", size_t memory_budget = 4u << 20);
+    ~SnapshotStore();
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /**
+     * @brief Stores a snapshot, replacing any under the same id.
+     */
+    void put(uint64_t id, std::string bytes);
+
+    /**
+     * @brief Removes a snapshot and returns its bytes.
+     * @return False if there is none or its spill file cannot be read.
+     */
+    bool take(uint64_t id, std::string* bytes);
+
+    bool contains(uint64_t id) const;
+
+    /**
+     * @brief Drops a snapshot without reading it.
+     */
+    void remove(uint64_t id);
+
+    /**
+     * @brief Returns the bytes held in memory.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Returns how many snapshots have been spilled to disk.
+     */
+    size_t spilledCount() const;
+
+private:
+    struct Entry {
+        uint64_t id;
+        std::string bytes; // empty once spilled
+        bool spilled = false;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    std::string pathOf(uint64_t id) const;
+    void erase(EntryList::iterator it);
+    void spill();
+
+    std::string spill_dir_;
+    size_t memory_budget_;
+    size_t memory_bytes_ = 0;
+    size_t spilled_count_ = 0;
+    EntryList entries_; // most recently stored first
+    std::unordered_map<uint64_t, EntryList::iterator> index_;
+    mutable std::mutex mutex_;
+};
+
+#endif // TAB_SNAPSHOT_H
\ No newline at end of file
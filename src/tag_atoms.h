@@ -0,0 +1,296 @@
+/**
+ * @file tag_atoms.h
+ * @brief Interned HTML tag names with a compile-time perfect-hash lookup.
+ */
+#ifndef TAG_ATOMS_H
+#define TAG_ATOMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief The HTML tag vocabulary as (enumerator, lowercase name) pairs.
+ *
+ * Adding a tag here gives it an atom and a slot in the lookup table.
+ */
+#define QUICKDOM_TAG_LIST(X) \
+    X(A, "a") \
+    X(Abbr, "abbr") \
+    X(Address, "address") \
+    X(Area, "area") \
+    X(Article, "article") \
+    X(Aside, "aside") \
+    X(Audio, "audio") \
+    X(B, "b") \
+    X(Base, "base") \
+    X(Bdi, "bdi") \
+    X(Bdo, "bdo") \
+    X(Big, "big") \
+    X(Blockquote, "blockquote") \
+    X(Body, "body") \
+    X(Br, "br") \
+    X(Button, "button") \
+    X(Canvas, "canvas") \
+    X(Caption, "caption") \
+    X(Center, "center") \
+    X(Cite, "cite") \
+    X(Code, "code") \
+    X(Col, "col") \
+    X(Colgroup, "colgroup") \
+    X(Data, "data") \
+    X(Datalist, "datalist") \
+    X(Dd, "dd") \
+    X(Del, "del") \
+    X(Details, "details") \
+    X(Dfn, "dfn") \
+    X(Dialog, "dialog") \
+    X(Div, "div") \
+    X(Dl, "dl") \
+    X(Dt, "dt") \
+    X(Em, "em") \
+    X(Embed, "embed") \
+    X(Fieldset, "fieldset") \
+    X(Figcaption, "figcaption") \
+    X(Figure, "figure") \
+    X(Font, "font") \
+    X(Footer, "footer") \
+    X(Form, "form") \
+    X(Frame, "frame") \
+    X(Frameset, "frameset") \
+    X(H1, "h1") \
+    X(H2, "h2") \
+    X(H3, "h3") \
+    X(H4, "h4") \
+    X(H5, "h5") \
+    X(H6, "h6") \
+    X(Head, "head") \
+    X(Header, "header") \
+    X(Hgroup, "hgroup") \
+    X(Hr, "hr") \
+    X(Html, "html") \
+    X(I, "i") \
+    X(Iframe, "iframe") \
+    X(Img, "img") \
+    X(Input, "input") \
+    X(Ins, "ins") \
+    X(Kbd, "kbd") \
+    X(Label, "label") \
+    X(Legend, "legend") \
+    X(Li, "li") \
+    X(Link, "link") \
+    X(Main, "main") \
+    X(Map, "map") \
+    X(Mark, "mark") \
+    X(Marquee, "marquee") \
+    X(Math, "math") \
+    X(Menu, "menu") \
+    X(Meta, "meta") \
+    X(Meter, "meter") \
+    X(Nav, "nav") \
+    X(Nobr, "nobr") \
+    X(Noframes, "noframes") \
+    X(Noscript, "noscript") \
+    X(Object, "object") \
+    X(Ol, "ol") \
+    X(Optgroup, "optgroup") \
+    X(Option, "option") \
+    X(Output, "output") \
+    X(P, "p") \
+    X(Param, "param") \
+    X(Picture, "picture") \
+    X(Pre, "pre") \
+    X(Progress, "progress") \
+    X(Q, "q") \
+    X(Rp, "rp") \
+    X(Rt, "rt") \
+    X(Ruby, "ruby") \
+    X(S, "s") \
+    X(Samp, "samp") \
+    X(Script, "script") \
+    X(Search, "search") \
+    X(Section, "section") \
+    X(Select, "select") \
+    X(Slot, "slot") \
+    X(Small, "small") \
+    X(Source, "source") \
+    X(Span, "span") \
+    X(Strike, "strike") \
+    X(Strong, "strong") \
+    X(Style, "style") \
+    X(Sub, "sub") \
+    X(Summary, "summary") \
+    X(Sup, "sup") \
+    X(Svg, "svg") \
+    X(Table, "table") \
+    X(Tbody, "tbody") \
+    X(Td, "td") \
+    X(Template, "template") \
+    X(Textarea, "textarea") \
+    X(Tfoot, "tfoot") \
+    X(Th, "th") \
+    X(Thead, "thead") \
+    X(Time, "time") \
+    X(Title, "title") \
+    X(Tr, "tr") \
+    X(Track, "track") \
+    X(Tt, "tt") \
+    X(U, "u") \
+    X(Ul, "ul") \
+    X(Var, "var") \
+    X(Video, "video") \
+    X(Wbr, "wbr")
+
+/**
+ * @brief Small integer identifying a tag name.
+ *
+ * Root and Text are pseudo-atoms for the document root and text runs; they
+ * have no HTML spelling and are never returned by lookupTag().
+ */
+enum class TagAtom : uint8_t {
+    Unknown,
+#define QUICKDOM_TAG_ENUM(id, name) id,
+    QUICKDOM_TAG_LIST(QUICKDOM_TAG_ENUM)
+#undef QUICKDOM_TAG_ENUM
+    Root,
+    Text,
+    Count
+};
+
+constexpr size_t kTagAtomCount = static_cast<size_t>(TagAtom::Count);
+
+namespace tag_atoms_detail {
+
+constexpr std::string_view kNames[kTagAtomCount] = {
+    "",
+#define QUICKDOM_TAG_NAME(id, name) name,
+    QUICKDOM_TAG_LIST(QUICKDOM_TAG_NAME)
+#undef QUICKDOM_TAG_NAME
+    "#root",
+    "#text",
+};
+
+constexpr size_t kBuckets = 64;
+constexpr size_t kSlots = 256;
+constexpr size_t kMaxNameLength = 10;
+
+// FNV-1a over the name with ASCII letters folded to lowercase. Tag names are
+// letters and digits only, and '|0x20' leaves digits unchanged.
+constexpr uint32_t hashName(std::string_view name) {
+    uint32_t h = 2166136261u;
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c | 0x20);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+constexpr size_t bucketOf(uint32_t h) {
+    return mix(h) & (kBuckets - 1);
+}
+
+constexpr size_t slotOf(uint32_t h, uint32_t displacement) {
+    return mix(h ^ (displacement * 0x9E3779B9u)) & (kSlots - 1);
+}
+
+struct Table {
+    uint16_t displacement[kBuckets] = {};
+    uint8_t slot_atoms[kSlots] = {}; // TagAtom values; 0 (Unknown) marks a free slot
+};
+
+/**
+ * Hash-and-displace construction: every name hashes to a bucket, and each
+ * bucket gets the smallest displacement that sends all of its names to free
+ * slots. Buckets are placed largest first. Evaluated by the compiler, so a
+ * vocabulary that cannot be placed fails the build instead of a lookup.
+ */
+constexpr Table buildTable() {
+    constexpr size_t first = 1;
+    constexpr size_t last = static_cast<size_t>(TagAtom::Root); // exclusive
+    Table table;
+    size_t bucket_size[kBuckets] = {};
+    for (size_t atom = first; atom < last; ++atom) ++bucket_size[bucketOf(hashName(kNames[atom]))];
+
+    size_t order[kBuckets] = {};
+    for (size_t b = 0; b < kBuckets; ++b) order[b] = b;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        for (size_t j = i + 1; j < kBuckets; ++j) {
+            if (bucket_size[order[j]] > bucket_size[order[i]]) {
+                size_t tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < kBuckets; ++i) {
+        const size_t bucket = order[i];
+        if (bucket_size[bucket] == 0) break;
+        for (uint32_t d = 0;; ++d) {
+            if (d > 0xFFFF) throw "tag_atoms: no displacement fits; grow kSlots";
+            bool fits = true;
+            size_t placed[kSlots] = {};
+            size_t placed_count = 0;
+            for (size_t atom = first; atom < last && fits; ++atom) {
+                const uint32_t h = hashName(kNames[atom]);
+                if (bucketOf(h) != bucket) continue;
+                const size_t slot = slotOf(h, d);
+                if (table.slot_atoms[slot] != 0) fits = false;
+                for (size_t k = 0; k < placed_count; ++k) {
+                    if (placed[k] == slot) fits = false;
+                }
+                placed[placed_count++] = slot;
+            }
+            if (!fits) continue;
+            for (size_t atom = first; atom < last; ++atom) {
+                const uint32_t h = hashName(kNames[atom]);
+                if (bucketOf(h) == bucket) table.slot_atoms[slotOf(h, d)] = static_cast<uint8_t>(atom);
+            }
+            table.displacement[bucket] = static_cast<uint16_t>(d);
+            break;
+        }
+    }
+    return table;
+}
+
+constexpr Table kTable = buildTable();
+
+} // namespace tag_atoms_detail
+
+/**
+ * @brief Returns the lowercase name of an atom ("" for Unknown).
+ */
+constexpr std::string_view tagName(TagAtom atom) {
+    return tag_atoms_detail::kNames[static_cast<size_t>(atom)];
+}
+
+/**
+ * @brief Maps a tag name to its atom with one hash and one compare.
+ * @param name Tag name in any ASCII case.
+ * @return The atom, or TagAtom::Unknown for names outside the vocabulary.
+ */
+constexpr TagAtom lookupTag(std::string_view name) {
+    using namespace tag_atoms_detail;
+    if (name.empty() || name.size() > kMaxNameLength) return TagAtom::Unknown;
+    const uint32_t h = hashName(name);
+    const uint8_t atom = kTable.slot_atoms[slotOf(h, kTable.displacement[bucketOf(h)])];
+    const std::string_view expected = kNames[atom];
+    if (atom == 0 || expected.size() != name.size()) return TagAtom::Unknown;
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != expected[i]) return TagAtom::Unknown;
+    }
+    return static_cast<TagAtom>(atom);
+}
+
+#endif // TAG_ATOMS_H
\ No newline at end of file
@@ -0,0 +1,429 @@
+/**
+ * @file text_normalizer.cpp
+ * @brief Implements entity decoding, whitespace collapsing and encoding repair of text runs.
+ */
+#include "text_normalizer.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define QUICKDOM_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define QUICKDOM_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kReplacement = 0xFFFD;
+// Longest entity name looked up; the longest known one is shorter.
+constexpr size_t kMaxEntityName = 8;
+
+inline bool isWhitespace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+inline bool isAlnum(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// A byte the fast scan stops at: '&', controls, non-ASCII, and a space after a space.
+inline bool isSpecial(const char* data, size_t pos) {
+    const unsigned char c = static_cast<unsigned char>(data[pos]);
+    return c == '&' || c < 0x20 || c >= 0x80 || (c == ' ' && pos > 0 && data[pos - 1] == ' ');
+}
+
+using FindSpecialFn = size_t (*)(const char* data, size_t pos, size_t size);
+
+size_t findSpecialScalar(const char* data, size_t pos, size_t size) {
+    while (pos < size && !isSpecial(data, pos)) ++pos;
+    return pos;
+}
+
+#if defined(QUICKDOM_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define QUICKDOM_TARGET(isa)
+#else
+#define QUICKDOM_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+inline unsigned countTrailingZeros(uint32_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+// Signed compares put bytes >= 0x80 below 0x20 too, so one compare finds
+// controls and non-ASCII. Doubled spaces are the space mask ANDed with itself
+// shifted by one byte, carrying the previous block's last byte in.
+QUICKDOM_TARGET("sse2")
+size_t findSpecialSse2(const char* data, size_t pos, size_t size) {
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i limit = _mm_set1_epi8(0x20);
+    uint32_t carry = pos > 0 && data[pos - 1] == ' ';
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const uint32_t special = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmplt_epi8(v, limit))));
+        const uint32_t spaces = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, space)));
+        const uint32_t bits = special | (spaces & ((spaces << 1) | carry));
+        if (bits) return pos + countTrailingZeros(bits);
+        carry = spaces >> 15;
+    }
+    return findSpecialScalar(data, pos, size);
+}
+
+QUICKDOM_TARGET("avx2")
+size_t findSpecialAvx2(const char* data, size_t pos, size_t size) {
+    const __m256i amp = _mm256_set1_epi8('&');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i limit = _mm256_set1_epi8(0x20);
+    uint32_t carry = pos > 0 && data[pos - 1] == ' ';
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const uint32_t special = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, amp), _mm256_cmpgt_epi8(limit, v))));
+        const uint32_t spaces = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, space)));
+        const uint32_t bits = special | (spaces & ((spaces << 1) | carry));
+        if (bits) return pos + countTrailingZeros(bits);
+        carry = spaces >> 31;
+    }
+    return findSpecialSse2(data, pos, size);
+}
+#endif
+
+#if defined(QUICKDOM_HAVE_NEON)
+// Without movemask, test 16 bytes at a time and locate the byte in scalar code.
+size_t findSpecialNeon(const char* data, size_t pos, size_t size) {
+    const uint8x16_t amp = vdupq_n_u8('&');
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t low = vdupq_n_u8(0x20);
+    const uint8x16_t high = vdupq_n_u8(0x7F);
+    uint8x16_t previous = vdupq_n_u8(pos > 0 && data[pos - 1] == ' ' ? 0xFF : 0);
+    for (; pos + 16 <= size; pos += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        const uint8x16_t spaces = vceqq_u8(v, space);
+        uint8x16_t special = vorrq_u8(vceqq_u8(v, amp), vorrq_u8(vcltq_u8(v, low), vcgtq_u8(v, high)));
+        special = vorrq_u8(special, vandq_u8(spaces, vextq_u8(previous, spaces, 15)));
+        if (vmaxvq_u8(special)) return findSpecialScalar(data, pos, pos + 16);
+        previous = spaces;
+    }
+    return findSpecialScalar(data, pos, size);
+}
+#endif
+
+FindSpecialFn bestFindSpecial() {
+#if defined(QUICKDOM_X86)
+    if (cpuFeatures().avx2) return findSpecialAvx2;
+    if (cpuFeatures().sse2) return findSpecialSse2;
+#elif defined(QUICKDOM_HAVE_NEON)
+    return findSpecialNeon;
+#endif
+    return findSpecialScalar;
+}
+
+const FindSpecialFn findSpecial = bestFindSpecial();
+
+} // namespace
+
+size_t utf8SequenceLength(std::string_view text, size_t pos) {
+    const auto byte = [&text](size_t i) { return static_cast<unsigned char>(text[i]); };
+    const unsigned char lead = byte(pos);
+    if (lead < 0x80) return 1;
+    size_t length;
+    unsigned char min = 0x80, max = 0xBF; // range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) min = 0xA0; // overlong
+        if (lead == 0xED) max = 0x9F; // surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) min = 0x90; // overlong
+        if (lead == 0xF4) max = 0x8F; // above U+10FFFF
+    } else {
+        return 0;
+    }
+    if (pos + length > text.size()) return 0;
+    if (byte(pos + 1) < min || byte(pos + 1) > max) return 0;
+    for (size_t i = 2; i < length; ++i) {
+        if ((byte(pos + i) & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+namespace {
+
+void appendUtf8(uint32_t code, std::string* out) {
+    if (code < 0x80) {
+        out->push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+// Windows-1252 differs from Latin-1 in 0x80-0x9F; HTML reads both labels as
+// Windows-1252, and numeric references in this range the same way.
+constexpr uint16_t kWindows1252[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+    0x2039, 0x0152, 0x008D, 0x017D, 0x008F, 0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+    0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178};
+
+uint32_t fromWindows1252(unsigned char c) {
+    return c >= 0x80 && c < 0xA0 ? kWindows1252[c - 0x80] : c;
+}
+
+// Names of U+00A0 to U+00FF, in order.
+constexpr const char* kLatin1Entities[96] = {
+    "nbsp",   "iexcl",  "cent",   "pound",  "curren", "yen",    "brvbar", "sect",   "uml",    "copy",
+    "ordf",   "laquo",  "not",    "shy",    "reg",    "macr",   "deg",    "plusmn", "sup2",   "sup3",
+    "acute",  "micro",  "para",   "middot", "cedil",  "sup1",   "ordm",   "raquo",  "frac14", "frac12",
+    "frac34", "iquest", "Agrave", "Aacute", "Acirc",  "Atilde", "Auml",   "Aring",  "AElig",  "Ccedil",
+    "Egrave", "Eacute", "Ecirc",  "Euml",   "Igrave", "Iacute", "Icirc",  "Iuml",   "ETH",    "Ntilde",
+    "Ograve", "Oacute", "Ocirc",  "Otilde", "Ouml",   "times",  "Oslash", "Ugrave", "Uacute", "Ucirc",
+    "Uuml",   "Yacute", "THORN",  "szlig",  "agrave", "aacute", "acirc",  "atilde", "auml",   "aring",
+    "aelig",  "ccedil", "egrave", "eacute", "ecirc",  "euml",   "igrave", "iacute", "icirc",  "iuml",
+    "eth",    "ntilde", "ograve", "oacute", "ocirc",  "otilde", "ouml",   "divide", "oslash", "ugrave",
+    "uacute", "ucirc",  "uuml",   "yacute", "thorn",  "yuml"};
+
+struct NamedEntity {
+    const char* name;
+    uint32_t code;
+};
+
+// Markup, typography and the symbols pages commonly use.
+constexpr NamedEntity kOtherEntities[] = {
+    {"quot", 0x22},     {"amp", 0x26},      {"apos", 0x27},     {"lt", 0x3C},      {"gt", 0x3E},
+    {"OElig", 0x152},   {"oelig", 0x153},   {"Scaron", 0x160},  {"scaron", 0x161}, {"Yuml", 0x178},
+    {"fnof", 0x192},    {"circ", 0x2C6},    {"tilde", 0x2DC},   {"ensp", 0x2002},  {"emsp", 0x2003},
+    {"thinsp", 0x2009}, {"zwnj", 0x200C},   {"zwj", 0x200D},    {"lrm", 0x200E},   {"rlm", 0x200F},
+    {"ndash", 0x2013},  {"mdash", 0x2014},  {"lsquo", 0x2018},  {"rsquo", 0x2019}, {"sbquo", 0x201A},
+    {"ldquo", 0x201C},  {"rdquo", 0x201D},  {"bdquo", 0x201E},  {"dagger", 0x2020}, {"Dagger", 0x2021},
+    {"bull", 0x2022},   {"hellip", 0x2026}, {"permil", 0x2030}, {"prime", 0x2032}, {"Prime", 0x2033},
+    {"lsaquo", 0x2039}, {"rsaquo", 0x203A}, {"oline", 0x203E},  {"frasl", 0x2044}, {"euro", 0x20AC},
+    {"trade", 0x2122},  {"larr", 0x2190},   {"uarr", 0x2191},   {"rarr", 0x2192},  {"darr", 0x2193},
+    {"harr", 0x2194},   {"minus", 0x2212},  {"infin", 0x221E},  {"ne", 0x2260},    {"le", 0x2264},
+    {"ge", 0x2265},     {"hearts", 0x2665}};
+
+uint32_t lookupEntity(std::string_view name) {
+    static const std::unordered_map<std::string_view, uint32_t> entities = [] {
+        std::unordered_map<std::string_view, uint32_t> result;
+        for (uint32_t i = 0; i < 96; ++i) result.emplace(kLatin1Entities[i], 0xA0 + i);
+        for (const NamedEntity& entity : kOtherEntities) result.emplace(entity.name, entity.code);
+        return result;
+    }();
+    auto it = entities.find(name);
+    return it != entities.end() ? it->second : 0;
+}
+
+// Decodes the character reference at pos ('&'); returns its length, or 0
+// if it is not one and the '&' stands for itself.
+size_t decodeReference(std::string_view text, size_t pos, uint32_t* code) {
+    size_t i = pos + 1;
+    if (i < text.size() && text[i] == '#') {
+        ++i;
+        const bool hex = i < text.size() && (text[i] == 'x' || text[i] == 'X');
+        if (hex) ++i;
+        const size_t digits_begin = i;
+        uint32_t value = 0;
+        for (; i < text.size(); ++i) {
+            const char c = text[i];
+            uint32_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<uint32_t>(c - '0');
+            } else if (hex && c >= 'a' && c <= 'f') {
+                digit = static_cast<uint32_t>(c - 'a' + 10);
+            } else if (hex && c >= 'A' && c <= 'F') {
+                digit = static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                break;
+            }
+            // Saturate; anything past U+10FFFF is replaced below.
+            value = value > 0x10FFFF ? value : value * (hex ? 16 : 10) + digit;
+        }
+        if (i == digits_begin) return 0;
+        if (i < text.size() && text[i] == ';') ++i; // optional for numeric references
+        if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+            value = kReplacement;
+        } else if (value >= 0x80 && value < 0xA0) {
+            value = fromWindows1252(static_cast<unsigned char>(value));
+        }
+        *code = value;
+        return i - pos;
+    }
+    const size_t name_begin = i;
+    while (i < text.size() && i - name_begin <= kMaxEntityName && isAlnum(static_cast<unsigned char>(text[i]))) ++i;
+    if (i == name_begin || i >= text.size() || text[i] != ';') return 0;
+    const uint32_t value = lookupEntity(text.substr(name_begin, i - name_begin));
+    if (value == 0) return 0;
+    *code = value;
+    return i + 1 - pos;
+}
+
+// Returns the length of the prefix of text that normalizes to itself; the
+// whole size if text is normal. Sets latin1 if text is not valid UTF-8, in
+// which case the prefix ends at its first non-ASCII byte.
+size_t normalPrefix(std::string_view text, bool* latin1) {
+    *latin1 = false;
+    const size_t size = text.size();
+    if (size == 0) return 0;
+    if (isWhitespace(static_cast<unsigned char>(text[0]))) return 0;
+    size_t first_non_ascii = size;
+    size_t change = size;
+    size_t pos = 0;
+    while ((pos = findSpecial(text.data(), pos, size)) < size) {
+        const unsigned char c = static_cast<unsigned char>(text[pos]);
+        if (c >= 0x80) {
+            const size_t length = utf8SequenceLength(text, pos);
+            if (length == 0) {
+                *latin1 = true;
+                return std::min(first_non_ascii, pos);
+            }
+            first_non_ascii = std::min(first_non_ascii, pos);
+            pos += length;
+            continue;
+        }
+        uint32_t code;
+        if (isWhitespace(c) || (c == '&' && decodeReference(text, pos, &code) > 0)) {
+            change = pos;
+            break;
+        }
+        ++pos; // another control, or an '&' that is just an ampersand
+    }
+    // A single trailing space is the one change the scan does not stop at.
+    if (change == size && text[size - 1] == ' ') change = size - 1;
+    // Whether the rest is UTF-8 is not known yet; rewriting finds out.
+    return change;
+}
+
+class Writer {
+public:
+    explicit Writer(std::string* out) : out_(out), start_(out->size()) {}
+
+    // Whitespace is held back until something follows it, which drops it at
+    // both ends of the run and collapses it in between.
+    void space() { space_ = true; }
+
+    void code(uint32_t code) {
+        if (code < 0x80 && isWhitespace(static_cast<unsigned char>(code))) {
+            space_ = true;
+            return;
+        }
+        flushSpace();
+        appendUtf8(code, out_);
+    }
+
+    // Appends a span of the input with no whitespace runs and nothing to decode.
+    void verbatim(std::string_view span) {
+        if (span.empty()) return;
+        if (span.front() == ' ') {
+            space_ = true;
+            span.remove_prefix(1);
+        }
+        if (!span.empty() && span.back() == ' ') {
+            span.remove_suffix(1);
+            if (!span.empty()) {
+                flushSpace();
+                out_->append(span.data(), span.size());
+            }
+            space_ = true;
+            return;
+        }
+        if (span.empty()) return;
+        flushSpace();
+        out_->append(span.data(), span.size());
+    }
+
+    void restart() {
+        out_->resize(start_);
+        space_ = false;
+    }
+
+private:
+    void flushSpace() {
+        if (space_ && out_->size() > start_) out_->push_back(' ');
+        space_ = false;
+    }
+
+    std::string* out_;
+    size_t start_;
+    bool space_ = false;
+};
+
+// Rewrites text from pos on, after the normal prefix before it.
+void rewrite(std::string_view text, size_t pos, bool latin1, std::string* out) {
+    Writer writer(out);
+    writer.verbatim(text.substr(0, pos));
+    const size_t size = text.size();
+    while (pos < size) {
+        // Spans between special bytes are ASCII, so they read the same in either encoding.
+        const size_t special = findSpecial(text.data(), pos, size);
+        if (special > pos) {
+            writer.verbatim(text.substr(pos, special - pos));
+            pos = special;
+            continue;
+        }
+        const unsigned char c = static_cast<unsigned char>(text[pos]);
+        if (isWhitespace(c)) {
+            writer.space();
+            ++pos;
+        } else if (c == '&') {
+            uint32_t code;
+            const size_t length = decodeReference(text, pos, &code);
+            writer.code(length > 0 ? code : '&');
+            pos += length > 0 ? length : 1;
+        } else if (c < 0x80) {
+            writer.code(c);
+            ++pos;
+        } else if (latin1) {
+            writer.code(fromWindows1252(c));
+            ++pos;
+        } else {
+            const size_t length = utf8SequenceLength(text, pos);
+            if (length == 0) {
+                // Not UTF-8 after all; start over reading it as Windows-1252.
+                writer.restart();
+                latin1 = true;
+                pos = 0;
+                continue;
+            }
+            writer.verbatim(text.substr(pos, length));
+            pos += length;
+        }
+    }
+}
+
+} // namespace
+
+bool normalizeText(std::string_view text, std::string* out) {
+    bool latin1;
+    const size_t prefix = normalPrefix(text, &latin1);
+    if (prefix == text.size()) return true;
+    rewrite(text, prefix, latin1, out);
+    return false;
+}
+
+std::string normalizedText(std::string_view text) {
+    std::string result;
+    if (normalizeText(text, &result)) result.assign(text.data(), text.size());
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+/**
+ * @file text_normalizer.h
+ * @brief Defines normalization of element text for display.
+ */
+#ifndef TEXT_NORMALIZER_H
+#define TEXT_NORMALIZER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Normalizes a run of element text, copying only when it has to.
+ *
+ * - Character references (&amp;, &eacute;, &#233;, &#xE9;) are
+ *   decoded. Unknown names and malformed references stay as written.
+ * - Runs of spaces, tabs, CRs, LFs and form feeds become one space, and
+ *   whitespace at either end is dropped.
+ * - A run that is not valid UTF-8 is read as Windows-1252, the superset of
+ *   Latin-1 pages declare, and transcoded to UTF-8.
+ *
+ * Most runs need none of this. A vector scan over the run finds the first
+ * byte that could need work ('&', a control or non-ASCII byte, or a second
+ * space); if the run turns out to be normal, nothing is written. Otherwise
+ * the verified prefix is copied as is and only the rest is rewritten.
+ * @param text The run as written in the page.
+ * @param out Receives the normalized text, appended, when it differs from text.
+ * @return True if text is already normal and nothing was appended.
+ */
+bool normalizeText(std::string_view text, std::string* out);
+
+/**
+ * @brief Returns the normalized form of a run of text.
+ */
+std::string normalizedText(std::string_view text);
+
+/**
+ * @brief Returns the length of the valid UTF-8 sequence at pos.
+ *
+ * ASCII bytes are sequences of one. Overlong forms, surrogates and code
+ * points past U+10FFFF are malformed.
+ * @return 1 to 4, or 0 if the bytes at pos are not valid UTF-8.
+ */
+size_t utf8SequenceLength(std::string_view text, size_t pos);
+
+#endif // TEXT_NORMALIZER_H
\ No newline at end of file
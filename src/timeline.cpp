@@ -0,0 +1,183 @@
+/**
+ * @file timeline.cpp
+ * @brief Implements span capture, collection and Chrome trace-event export.
+ */
+#include "timeline.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "json_text.h"
+#include "ring_registry.h"
+#include "trace.h"
+
+namespace timeline_detail {
+
+std::atomic<bool> enabled{false};
+
+} // namespace timeline_detail
+
+namespace {
+
+// How often the collector empties the rings while capture is on.
+constexpr std::chrono::milliseconds kCollectInterval{50};
+// Spans kept between exports, about 40 MB; later ones are dropped and counted.
+constexpr size_t kMaxStoredSpans = size_t(1) << 18;
+
+using TimelineRing = trace_detail::SpscRing<TimelineRecord, 2048>;
+
+// Every thread's ring, and the spans collected from them; the registry
+// mutex also guards the store.
+struct Timeline {
+    trace_detail::RingRegistry<TimelineRing> rings;
+    std::vector<TimelineRecord> spans;
+    uint64_t store_dropped = 0; // spans that did not fit the store
+};
+
+Timeline& timeline() {
+    static Timeline* instance = new Timeline(); // outlives thread-local rings
+    return *instance;
+}
+
+thread_local uint64_t current_tab = kNoTimelineTab;
+
+// Moves every ring's spans into the store; the caller holds the registry mutex.
+void collectLocked(Timeline& t) {
+    t.rings.drainLocked([&t](const TimelineRecord& record) {
+        if (t.spans.size() < kMaxStoredSpans) {
+            t.spans.push_back(record);
+        } else {
+            ++t.store_dropped;
+        }
+    });
+}
+
+void collect() {
+    Timeline& t = timeline();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+    collectLocked(t);
+}
+
+trace_detail::DrainThread& collector() {
+    static trace_detail::DrainThread instance;
+    return instance;
+}
+
+// Writes nanoseconds as microseconds with three decimals, without floating point.
+void appendMicroseconds(std::string& out, uint64_t ns) {
+    char digits[32];
+    const int length = std::snprintf(digits, sizeof(digits), "%llu.%03u",
+                                     static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+    out.append(digits, static_cast<size_t>(length));
+}
+
+} // namespace
+
+void setTimelineEnabled(bool enabled) {
+    static std::mutex toggle_mutex; // keeps the flag and the collector in step
+    std::lock_guard<std::mutex> lock(toggle_mutex);
+    if (enabled == timelineEnabled()) return;
+    timeline_detail::enabled.store(enabled, std::memory_order_relaxed);
+    if (enabled) {
+        collector().start(kCollectInterval, collect);
+    } else {
+        collector().stop();
+    }
+    QUICKDOM_TRACE_INFO("Timeline capture", enabled ? "started" : "stopped");
+}
+
+uint64_t timelineTab() {
+    return current_tab;
+}
+
+void recordTimelineSpan(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                        std::string_view url, uint64_t tab) {
+    if (!timelineEnabled()) return;
+    TimelineRing& ring = timeline().rings.localRing();
+    TimelineRecord* record = ring.reserve();
+    if (!record) return;
+    record->start_ns = start_ns;
+    record->end_ns = end_ns < start_ns ? start_ns : end_ns;
+    record->name = name;
+    record->category = category;
+    record->tab = tab;
+    const size_t length = std::min(url.size(), TimelineRecord::kUrlBytes);
+    std::memcpy(record->url, url.data(), length);
+    record->url_length = static_cast<uint8_t>(length);
+    ring.commit();
+}
+
+TimelineTabScope::TimelineTabScope(uint64_t tab) : previous_(current_tab) {
+    current_tab = tab;
+}
+
+TimelineTabScope::~TimelineTabScope() {
+    current_tab = previous_;
+}
+
+std::string timelineJson() {
+    std::vector<TimelineRecord> spans;
+    {
+        Timeline& t = timeline();
+        std::lock_guard<std::mutex> lock(t.rings.mutex);
+        collectLocked(t);
+        spans.swap(t.spans);
+    }
+    std::stable_sort(spans.begin(), spans.end(),
+                     [](const TimelineRecord& a, const TimelineRecord& b) { return a.start_ns < b.start_ns; });
+
+    // Times count from the first span, which keeps the numbers short.
+    const uint64_t origin = spans.empty() ? 0 : spans.front().start_ns;
+    std::string out;
+    out.reserve(128 + spans.size() * 200);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"QuickDOM\"}}";
+    for (const TimelineRecord& span : spans) {
+        out += ",\n{\"name\":";
+        appendJsonString(out, span.name);
+        out += ",\"cat\":";
+        appendJsonString(out, span.category);
+        out += ",\"ph\":\"X\",\"ts\":";
+        appendMicroseconds(out, span.start_ns - origin);
+        out += ",\"dur\":";
+        appendMicroseconds(out, span.end_ns - span.start_ns);
+        out += ",\"pid\":1,\"tid\":" + std::to_string(span.thread) + ",\"args\":{";
+        if (span.tab != kNoTimelineTab) out += "\"tab\":" + std::to_string(span.tab) + ",";
+        out += "\"url\":";
+        appendJsonString(out, std::string_view(span.url, span.url_length));
+        out += "}}";
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool writeTimeline(const std::string& path) {
+    const std::string json = timelineJson();
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        QUICKDOM_TRACE_ERROR("Cannot write timeline", path);
+        return false;
+    }
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    const bool closed = std::fclose(file) == 0;
+    if (written && closed) {
+        QUICKDOM_TRACE_INFO("Timeline written", path);
+    } else {
+        QUICKDOM_TRACE_ERROR("Cannot write timeline", path);
+    }
+    return written && closed;
+}
+
+void clearTimeline() {
+    Timeline& t = timeline();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+    collectLocked(t);
+    t.spans.clear();
+}
+
+uint64_t timelineDroppedCount() {
+    Timeline& t = timeline();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+    return t.store_dropped + t.rings.droppedLocked();
+}
\ No newline at end of file
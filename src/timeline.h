@@ -0,0 +1,151 @@
+/**
+ * @file timeline.h
+ * @brief Defines the page-load timeline: spans recorded per thread and
+ *        exported as Chrome trace-event JSON.
+ *
+ * Capture is off by default and is switched at runtime. While it is off a
+ * span costs one relaxed atomic load. While it is on, a finished span is
+ * copied into a ring owned by the recording thread without locking; a
+ * collector thread moves the rings' contents into one store, and
+ * writeTimeline() exports it for chrome://tracing or Perfetto.
+ */
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Marks a span that belongs to no tab.
+ */
+constexpr uint64_t kNoTimelineTab = ~uint64_t(0);
+
+/**
+ * @brief One finished span as stored in a ring.
+ */
+struct TimelineRecord {
+    static constexpr size_t kUrlBytes = 118;
+
+    uint64_t start_ns;   // steady clock
+    uint64_t end_ns;
+    const char* name;    // static string: "fetch", "parse", "curl", ...
+    const char* category; // static string: "load", "net" or "image"
+    uint64_t tab;        // tab index, or kNoTimelineTab
+    uint32_t thread;     // small per-process thread number
+    uint8_t url_length;  // bytes used in url
+    char url[kUrlBytes]; // URL the span worked on, truncated to fit
+};
+
+namespace timeline_detail {
+
+extern std::atomic<bool> enabled;
+
+} // namespace timeline_detail
+
+/**
+ * @brief Checks whether spans are being captured.
+ */
+inline bool timelineEnabled() {
+    return timeline_detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Starts or stops capture. Spans already captured are kept until
+ *        writeTimeline() or clearTimeline().
+ */
+void setTimelineEnabled(bool enabled);
+
+/**
+ * @brief Returns the steady clock in nanoseconds, the time base of spans.
+ */
+inline uint64_t timelineNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Returns the tab the calling thread is working for.
+ */
+uint64_t timelineTab();
+
+/**
+ * @brief Records a span with explicit times, e.g. from libcurl's own timers.
+ *
+ * Does nothing while capture is off.
+ */
+void recordTimelineSpan(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                        std::string_view url, uint64_t tab = timelineTab());
+
+/**
+ * @class TimelineTabScope
+ * @brief Tags the spans of the calling thread with a tab while in scope.
+ *
+ * Set where work for a tab enters a thread (a load, a lazy image batch, a
+ * decode), so spans recorded deeper down, such as curl transfers, carry the
+ * tab without it being passed through.
+ */
+class TimelineTabScope {
+public:
+    explicit TimelineTabScope(uint64_t tab);
+    ~TimelineTabScope();
+    TimelineTabScope(const TimelineTabScope&) = delete;
+    TimelineTabScope& operator=(const TimelineTabScope&) = delete;
+
+private:
+    uint64_t previous_;
+};
+
+/**
+ * @class TimelineSpan
+ * @brief Records the time from construction to destruction as a span.
+ *
+ * The URL is copied when the span ends, so it must stay valid until then.
+ * A span started while capture is off records nothing.
+ */
+class TimelineSpan {
+public:
+    TimelineSpan(const char* name, const char* category, std::string_view url)
+        : name_(name), category_(category), url_(url), start_ns_(timelineEnabled() ? timelineNow() : 0) {}
+    ~TimelineSpan() {
+        if (start_ns_) recordTimelineSpan(name_, category_, start_ns_, timelineNow(), url_);
+    }
+    TimelineSpan(const TimelineSpan&) = delete;
+    TimelineSpan& operator=(const TimelineSpan&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    std::string_view url_;
+    uint64_t start_ns_;
+};
+
+/**
+ * @brief Writes every captured span as Chrome trace-event JSON and forgets them.
+ *
+ * Spans become complete ("X") events with the tab and URL as arguments,
+ * sorted by start time. Spans still held in rings are collected first.
+ * @param path File to write.
+ * @return True if the file was written.
+ */
+bool writeTimeline(const std::string& path);
+
+/**
+ * @brief Returns the captured spans as Chrome trace-event JSON and forgets them.
+ */
+std::string timelineJson();
+
+/**
+ * @brief Forgets every captured span.
+ */
+void clearTimeline();
+
+/**
+ * @brief Returns how many spans were lost to a full ring or store.
+ */
+uint64_t timelineDroppedCount();
+
+#endif // TIMELINE_H
\ No newline at end of file
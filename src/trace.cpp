@@ -0,0 +1,96 @@
+/**
+ * @file trace.cpp
+ * @brief Implements the trace flusher on top of the shared ring registry.
+ */
+#include "trace.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "ring_registry.h"
+
+namespace {
+
+using trace_detail::TraceRing;
+
+const char* levelName(TraceLevel level) {
+    switch (level) {
+        case TraceLevel::Error: return "error";
+        case TraceLevel::Warn: return "warn";
+        case TraceLevel::Info: return "info";
+        case TraceLevel::Debug: return "debug";
+        case TraceLevel::Off: break;
+    }
+    return "off";
+}
+
+// Every thread's ring, plus the sink; the registry mutex also guards these.
+struct Tracer {
+    trace_detail::RingRegistry<TraceRing> rings;
+    uint64_t reported_dropped = 0;
+    FILE* sink = stderr;
+    std::vector<TraceRecord> scratch;
+};
+
+Tracer& tracer() {
+    static Tracer* instance = new Tracer(); // outlives thread-local rings
+    return *instance;
+}
+
+trace_detail::DrainThread& flusher() {
+    static trace_detail::DrainThread instance;
+    return instance;
+}
+
+} // namespace
+
+namespace trace_detail {
+
+TraceRing& localRing() {
+    return tracer().rings.localRing();
+}
+
+} // namespace trace_detail
+
+void traceFlush() {
+    Tracer& t = tracer();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+
+    // Merge all rings by time so events from different threads interleave.
+    t.scratch.clear();
+    t.rings.drainLocked([&t](const TraceRecord& record) { t.scratch.push_back(record); });
+    std::stable_sort(t.scratch.begin(), t.scratch.end(),
+                     [](const TraceRecord& a, const TraceRecord& b) { return a.time_ns < b.time_ns; });
+    for (const TraceRecord& record : t.scratch) {
+        std::fprintf(t.sink, "[%s] T%u %s: %.*s\n", levelName(record.level), record.thread, record.event,
+                     static_cast<int>(record.length), record.text);
+    }
+
+    const uint64_t dropped = t.rings.droppedLocked();
+    if (dropped > t.reported_dropped) {
+        std::fprintf(t.sink, "[warn] trace: %llu records dropped (ring full)\n",
+                     static_cast<unsigned long long>(dropped - t.reported_dropped));
+        t.reported_dropped = dropped;
+    }
+    std::fflush(t.sink);
+}
+
+void setTraceSink(FILE* sink) {
+    Tracer& t = tracer();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+    t.sink = sink ? sink : stderr;
+}
+
+void startTraceFlusher(std::chrono::milliseconds interval) {
+    flusher().start(interval, traceFlush);
+}
+
+void stopTraceFlusher() {
+    flusher().stop();
+    traceFlush();
+}
+
+uint64_t traceDroppedCount() {
+    Tracer& t = tracer();
+    std::lock_guard<std::mutex> lock(t.rings.mutex);
+    return t.rings.droppedLocked();
+}
\ No newline at end of file
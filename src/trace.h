@@ -0,0 +1,212 @@
+/**
+ * @file trace.h
+ * @brief Defines compile-time filtered tracing into per-thread ring buffers.
+ *
+ * Trace points below QUICKDOM_TRACE_LEVEL compile to nothing; their
+ * arguments are not evaluated. Enabled trace points copy a short record into
+ * a ring owned by the calling thread without locking or I/O, and a flusher
+ * (traceFlush() or the optional background thread) writes the records out.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Trace severity, from most to least important.
+ */
+enum class TraceLevel : uint8_t {
+    Off = 0,
+    Error = 1,
+    Warn = 2,
+    Info = 3,
+    Debug = 4
+};
+
+// Highest level compiled in. Release builds keep warnings and errors;
+// debug builds keep everything. Override with -DQUICKDOM_TRACE_LEVEL=<0..4>.
+#ifndef QUICKDOM_TRACE_LEVEL
+#if defined(NDEBUG) || defined(QT_NO_DEBUG)
+#define QUICKDOM_TRACE_LEVEL 2
+#else
+#define QUICKDOM_TRACE_LEVEL 4
+#endif
+#endif
+
+/**
+ * @brief Checks whether a level is compiled in.
+ *
+ * Internal linkage, since translation units may choose different levels.
+ */
+static constexpr bool traceEnabled(TraceLevel level) {
+    return level != TraceLevel::Off && static_cast<int>(level) <= QUICKDOM_TRACE_LEVEL;
+}
+
+/**
+ * @brief One trace event as stored in a ring.
+ */
+struct TraceRecord {
+    static constexpr size_t kTextBytes = 96;
+
+    uint64_t time_ns;    // steady clock
+    const char* event;   // static string naming the event
+    uint32_t thread;     // small per-process thread number
+    TraceLevel level;
+    uint8_t length;      // bytes used in text
+    char text[kTextBytes]; // detail, truncated to fit
+};
+
+/**
+ * @brief Writes all buffered records to the sink, oldest first.
+ *
+ * Safe to call from any thread; producers are never blocked.
+ */
+void traceFlush();
+
+/**
+ * @brief Sets where traceFlush() writes records (default stderr).
+ * @param sink Open stream; not closed by the tracer.
+ */
+void setTraceSink(FILE* sink);
+
+/**
+ * @brief Starts a background thread that flushes periodically.
+ * @param interval Time between flushes.
+ */
+void startTraceFlusher(std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+/**
+ * @brief Stops the background flusher, then flushes what is left.
+ */
+void stopTraceFlusher();
+
+/**
+ * @brief Returns how many records were dropped because a ring was full.
+ */
+uint64_t traceDroppedCount();
+
+namespace trace_detail {
+
+/**
+ * Single-producer, single-consumer ring owned by one thread. When full, new
+ * records are dropped and counted rather than blocking the producer. Record
+ * must have a uint32_t thread member, which reserve() fills in.
+ */
+template <typename Record, size_t Capacity>
+class SpscRing {
+public:
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static constexpr size_t kCapacity = Capacity;
+
+    explicit SpscRing(uint32_t thread) : thread_(thread) {}
+
+    // Producer side: returns a slot to fill, or nullptr if the ring is full.
+    Record* reserve() {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Record* record = &records_[head & (Capacity - 1)];
+        record->thread = thread_;
+        return record;
+    }
+
+    void commit() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer side: calls fn for every committed record and frees them.
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) fn(records_[tail & (Capacity - 1)]);
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> retired{false}; // owning thread has exited
+
+private:
+    Record records_[Capacity];
+    uint32_t thread_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+using TraceRing = SpscRing<TraceRecord, 1024>;
+
+/**
+ * Returns the calling thread's ring, registering it on first use.
+ */
+TraceRing& localRing();
+
+inline void append(TraceRecord& record, std::string_view text) {
+    const size_t room = TraceRecord::kTextBytes - record.length;
+    const size_t count = text.size() < room ? text.size() : room;
+    std::memcpy(record.text + record.length, text.data(), count);
+    record.length = static_cast<uint8_t>(record.length + count);
+}
+
+template <typename T>
+void appendValue(TraceRecord& record, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        append(record, value ? "true" : "false");
+    } else if constexpr (std::is_integral_v<T>) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(record, std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    } else {
+        append(record, std::string_view(value));
+    }
+}
+
+template <typename... Args>
+void traceEvent(TraceLevel level, const char* event, const Args&... args) {
+    TraceRing& ring = localRing();
+    TraceRecord* record = ring.reserve();
+    if (!record) return;
+    record->length = 0;
+    record->time_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    record->event = event;
+    record->level = level;
+    (appendValue(*record, args), ...);
+    ring.commit();
+}
+
+} // namespace trace_detail
+
+/**
+ * @brief Records an event if level is compiled in.
+ *
+ * The detail arguments (strings, string views or integers) are concatenated
+ * into the record; they are not evaluated when the level is compiled out.
+ */
+#define QUICKDOM_TRACE(level, event, ...)                               \
+    do {                                                                \
+        if constexpr (traceEnabled(level)) {                            \
+            ::trace_detail::traceEvent(level, event, __VA_ARGS__);      \
+        }                                                               \
+    } while (0)
+
+#define QUICKDOM_TRACE_ERROR(event, ...) QUICKDOM_TRACE(TraceLevel::Error, event, __VA_ARGS__)
+#define QUICKDOM_TRACE_WARN(event, ...) QUICKDOM_TRACE(TraceLevel::Warn, event, __VA_ARGS__)
+#define QUICKDOM_TRACE_INFO(event, ...) QUICKDOM_TRACE(TraceLevel::Info, event, __VA_ARGS__)
+#define QUICKDOM_TRACE_DEBUG(event, ...) QUICKDOM_TRACE(TraceLevel::Debug, event, __VA_ARGS__)
+
+#endif // TRACE_H
\ No newline at end of file
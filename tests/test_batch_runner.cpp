@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include "batch_runner.h"
+#include "parser_factory.h"
+
+namespace fs = std::filesystem;
+
+// Test fixture for BatchRunner tests; records are written through the event loop
+class BatchRunnerTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+    }
+
+    static void TearDownTestSuite() {
+        delete app;
+    }
+
+    void SetUp() override {
+        fs::create_directory("cache");
+        std::ofstream("batch_first.html") << "<h1>First</h1><p>Go <a href=\"/second\">on</a> or <a href=\"/x\\y\">x</a></p>";
+        std::ofstream("batch_second.html") << "<p>Second &amp; last</p>";
+        parser = createParser(ParserKind::Auto);
+        network = std::make_unique<Network>();
+    }
+
+    void TearDown() override {
+        fs::remove("batch_first.html");
+        fs::remove("batch_second.html");
+        fs::remove_all("cache");
+    }
+
+    // Runs a batch to the end, or until a few seconds pass; returns the lines written.
+    std::vector<std::string> run(const std::vector<std::string>& urls, BatchOptions options = BatchOptions()) {
+        std::ostringstream out;
+        {
+            BatchRunner runner(*network, *parser, out, options);
+            bool finished = false;
+            QObject::connect(&runner, &BatchRunner::finished, [&finished]() { finished = true; });
+            runner.start(urls);
+            const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!finished && std::chrono::steady_clock::now() < give_up) {
+                QCoreApplication::processEvents();
+            }
+            EXPECT_TRUE(finished);
+            complete = runner.completeCount();
+        }
+        std::vector<std::string> lines;
+        std::istringstream in(out.str());
+        for (std::string line; std::getline(in, line);) lines.push_back(line);
+        return lines;
+    }
+
+    static bool contains(const std::string& line, const std::string& part) {
+        return line.find(part) != std::string::npos;
+    }
+
+    static QApplication* app;
+    std::unique_ptr<Network> network;
+    std::unique_ptr<HtmlParser> parser;
+    size_t complete = 0;
+};
+
+QApplication* BatchRunnerTest::app = nullptr;
+
+// Unit Test: Page lists skip blanks and comments, and paths become file URLs
+TEST_F(BatchRunnerTest, ReadsPageList) {
+    std::istringstream list("https://example.com/\n\n  # a comment\n  batch_first.html  \r\n");
+    const std::vector<std::string> urls = readBatchList(list);
+    ASSERT_EQ(urls.size(), 2u);
+    EXPECT_EQ(urls[0], "https://example.com/");
+    EXPECT_EQ(urls[1], "file://" + fs::absolute("batch_first.html").string());
+    EXPECT_EQ(batchUrl("file:///tmp/a.html"), "file:///tmp/a.html");
+}
+
+// Unit Test: Every page gets one record with its index, links and timings
+TEST_F(BatchRunnerTest, WritesOneRecordPerPage) {
+    const std::vector<std::string> urls = {batchUrl("batch_first.html"), batchUrl("batch_second.html")};
+    BatchOptions options;
+    options.threads = 2;
+    const std::vector<std::string> lines = run(urls, options);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(complete, 2u);
+    for (const std::string& line : lines) {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_EQ(line.back(), '}');
+        EXPECT_TRUE(contains(line, "\"complete\":true"));
+        EXPECT_TRUE(contains(line, "\"parse_us\":"));
+        EXPECT_FALSE(contains(line, "\"dom\":"));
+        EXPECT_FALSE(contains(line, "\"height\":"));
+        const std::string& url = contains(line, "\"index\":0") ? urls[0] : urls[1];
+        EXPECT_TRUE(contains(line, "\"url\":\"" + url + "\"")) << line;
+    }
+    const std::string& first = contains(lines[0], "\"index\":0") ? lines[0] : lines[1];
+    EXPECT_TRUE(contains(first, "\"links\":[\"/second\",\"/x\\\\y\"]")) << first;
+}
+
+// Unit Test: Rendering and the element tree are added on request
+TEST_F(BatchRunnerTest, AddsRenderAndDom) {
+    BatchOptions options;
+    options.render = true;
+    options.dom = true;
+    const std::vector<std::string> lines = run({batchUrl("batch_second.html")}, options);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_TRUE(contains(lines[0], "\"render_us\":"));
+    EXPECT_TRUE(contains(lines[0], "\"height\":"));
+    EXPECT_TRUE(contains(lines[0], "\"items\":"));
+    EXPECT_TRUE(contains(lines[0], "\"dom\":{\"tag\":\"#root\",\"children\":[{\"tag\":\"p\",\"text\":\"Second & last\"}]}"))
+        << lines[0];
+}
+
+// Unit Test: A page that cannot be fetched is still reported, as incomplete
+TEST_F(BatchRunnerTest, ReportsFailedPages) {
+    const std::vector<std::string> lines = run({batchUrl("batch_missing.html"), batchUrl("batch_second.html")});
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(complete, 1u);
+    const std::string& missing = contains(lines[0], "\"index\":0") ? lines[0] : lines[1];
+    EXPECT_TRUE(contains(missing, "\"complete\":false"));
+}
+
+// Unit Test: More pages than the in-flight window all come through
+TEST_F(BatchRunnerTest, RunsLongListsThroughBoundedWindow) {
+    BatchOptions options;
+    options.threads = 1;
+    const std::vector<std::string> urls(9, batchUrl("batch_second.html"));
+    const std::vector<std::string> lines = run(urls, options);
+    ASSERT_EQ(lines.size(), urls.size());
+    for (size_t index = 0; index < urls.size(); ++index) {
+        const std::string tag = "\"index\":" + std::to_string(index) + ",";
+        EXPECT_EQ(std::count_if(lines.begin(), lines.end(), [&](const std::string& line) { return contains(line, tag); }), 1);
+    }
+}
+
+// Unit Test: An empty batch finishes at once
+TEST_F(BatchRunnerTest, EmptyBatchFinishes) {
+    EXPECT_TRUE(run({}).empty());
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QLabel>
+#include <QVBoxLayout>
+#include "computed_style.h"
+#include "renderer.h"
+#include "html_parser.h"
+
+// Test fixture for computed style tests
+class ComputedStyleTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+    }
+
+    static void TearDownTestSuite() {
+        delete app;
+    }
+
+    static StyleValues parse(const char* declarations) {
+        return StyleTable::parse(StyleValues(), declarations);
+    }
+
+    static QApplication* app;
+};
+
+QApplication* ComputedStyleTest::app = nullptr;
+
+// Unit Test: Each role has the look its tags always had
+TEST_F(ComputedStyleTest, RoleDefaults) {
+    StyleTable& styles = StyleTable::instance();
+    EXPECT_EQ(styles.defaultStyle(TextStyle::Body)->values().pixel_size, 14);
+    EXPECT_TRUE(styles.defaultStyle(TextStyle::Header)->font().bold());
+    EXPECT_EQ(styles.defaultStyle(TextStyle::Header)->values().pixel_size, 18);
+    EXPECT_TRUE(styles.defaultStyle(TextStyle::Link)->font().underline());
+    EXPECT_EQ(styles.defaultStyle(TextStyle::Link)->color(), QColor("#00008B"));
+    EXPECT_TRUE(styles.defaultStyle(TextStyle::Notice)->hasBackground());
+    EXPECT_EQ(styles.defaultStyle(TextStyle::Notice)->padding(), 5);
+    EXPECT_FALSE(styles.defaultStyle(TextStyle::Body)->hasBackground());
+}
+
+// Unit Test: Elements with the same style share one record
+TEST_F(ComputedStyleTest, SharesRecords) {
+    StyleTable& styles = StyleTable::instance();
+    const ComputedStyle* red = styles.resolve(TextStyle::Body, "color: red");
+    EXPECT_EQ(styles.resolve(TextStyle::Body, "color: red"), red);
+    EXPECT_EQ(styles.resolve(TextStyle::Body, "COLOR:#ff0000;"), red); // other text, same effect
+    EXPECT_NE(styles.resolve(TextStyle::Body, "color: blue"), red);
+    EXPECT_NE(styles.resolve(TextStyle::Header, "color: red"), red);
+    EXPECT_EQ(styles.resolve(TextStyle::Body, ""), styles.defaultStyle(TextStyle::Body));
+    EXPECT_EQ(styles.resolve(TextStyle::Body, "font-size: 14px"), styles.defaultStyle(TextStyle::Body));
+}
+
+// Unit Test: Inline declarations override the role's defaults only where given
+TEST_F(ComputedStyleTest, InlineOverridesDefaults) {
+    const ComputedStyle* link = StyleTable::instance().resolve(TextStyle::Link, "color: red; font-size: 20px");
+    EXPECT_EQ(link->color(), QColor("red"));
+    EXPECT_EQ(link->values().pixel_size, 20);
+    EXPECT_TRUE(link->font().underline());
+}
+
+// Unit Test: Font declarations
+TEST_F(ComputedStyleTest, ParsesFonts) {
+    EXPECT_EQ(parse("font-size: 12pt").pixel_size, 16);
+    EXPECT_EQ(parse("font-size: 2em").pixel_size, 28);
+    EXPECT_EQ(parse("font-size: 10px; font-size: 150%").pixel_size, 15);
+    EXPECT_EQ(parse("font-size: large").pixel_size, 0); // keywords are ignored
+    EXPECT_TRUE(parse("font-weight: 700").bold);
+    EXPECT_FALSE(parse("font-weight: bold; font-weight: 400").bold);
+    EXPECT_TRUE(parse("font-style: italic").italic);
+    const StyleValues decorated = parse("text-decoration: underline line-through");
+    EXPECT_TRUE(decorated.underline);
+    EXPECT_TRUE(decorated.strike_out);
+    EXPECT_FALSE(StyleTable::parse(decorated, "text-decoration: none").underline);
+}
+
+// Unit Test: Color declarations
+TEST_F(ComputedStyleTest, ParsesColors) {
+    EXPECT_EQ(parse("color: #fff").color, 0xffffffffu);
+    EXPECT_EQ(parse("color: rgb(255, 0, 0)").color, 0xffff0000u);
+    EXPECT_EQ(parse("color: rgba(0, 0, 255, 0.5)").color, 0x800000ffu);
+    EXPECT_EQ(parse("background: navy").background, 0xff000080u);
+    EXPECT_EQ(parse("background-color: transparent").background, 0u);
+    EXPECT_EQ(parse("color: nonsense").color, StyleValues().color);
+    EXPECT_EQ(parse("color: rgb(1, 2)").color, StyleValues().color);
+}
+
+// Unit Test: Box declarations, importance and junk
+TEST_F(ComputedStyleTest, ParsesBoxAndIgnoresJunk) {
+    EXPECT_EQ(parse("padding: 4px 8px").padding, 4);
+    EXPECT_EQ(parse("margin: 1px 2px 3px 4px").spacing, 3);
+    EXPECT_EQ(parse("margin: 10px").spacing, 10);
+    EXPECT_EQ(parse("margin-bottom: 0").spacing, 0);
+    EXPECT_EQ(parse("padding: 100000px").padding, 512);
+    EXPECT_EQ(parse("padding: -5px").padding, 0);
+    EXPECT_EQ(parse("color: red !important").color, 0xffff0000u);
+    EXPECT_EQ(parse(";;display: none; color; :red; font-size: px"), StyleValues());
+}
+
+// Unit Test: Applying a style sets font, palette and box; clearing undoes it
+TEST_F(ComputedStyleTest, AppliesToWidgets) {
+    QLabel label;
+    StyleTable::instance().defaultStyle(TextStyle::Notice)->apply(&label);
+    EXPECT_TRUE(label.autoFillBackground());
+    EXPECT_EQ(label.contentsMargins().left(), 5);
+    EXPECT_EQ(label.palette().color(QPalette::WindowText), QColor(Qt::white));
+    ComputedStyle::clear(&label);
+    EXPECT_FALSE(label.autoFillBackground());
+    EXPECT_EQ(label.contentsMargins().left(), 0);
+    EXPECT_TRUE(label.styleSheet().isEmpty());
+}
+
+// Unit Test: Inline styles reach both the widgets and the display list
+TEST_F(ComputedStyleTest, RendererResolvesInlineStyles) {
+    const Document document = SimdParser().parseDocument(
+        "<p style=\"font-weight: bold\">One</p><p style=\"font-weight: bold\">Two</p><p>Three</p>");
+    QWidget page;
+    auto* layout = new QVBoxLayout(&page);
+    Renderer renderer;
+    renderer.render(document, layout);
+    ASSERT_EQ(layout->count(), 3);
+    EXPECT_TRUE(layout->itemAt(0)->widget()->font().bold());
+    EXPECT_FALSE(layout->itemAt(2)->widget()->font().bold());
+    EXPECT_TRUE(layout->itemAt(0)->widget()->styleSheet().isEmpty());
+
+    const DisplayList list = renderer.buildDisplayList(document);
+    ASSERT_EQ(list.size(), static_cast<size_t>(3));
+    EXPECT_TRUE(list.item(0).computed->font().bold());
+    EXPECT_EQ(list.item(0).computed, list.item(1).computed);
+    EXPECT_EQ(list.item(2).computed, StyleTable::instance().defaultStyle(TextStyle::Body));
+}
+
+// Unit Test: Spacing from margins moves the items below
+TEST_F(ComputedStyleTest, SpacingAffectsLayout) {
+    Renderer renderer;
+    DisplayList tight = renderer.buildDisplayList(
+        SimdParser().parseDocument("<p style=\"margin: 0\">One</p><p>Two</p>"));
+    DisplayList loose = renderer.buildDisplayList(
+        SimdParser().parseDocument("<p style=\"margin-bottom: 40px\">One</p><p>Two</p>"));
+    tight.layout(600);
+    loose.layout(600);
+    EXPECT_EQ(tight.item(1).rect.top(), tight.item(0).rect.bottom() + 1);
+    EXPECT_EQ(loose.item(1).rect.top(), loose.item(0).rect.bottom() + 41);
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QBuffer>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QSignalSpy>
+#include <QtTest>
+#include "renderer.h"
+#include "page_view.h"
+#include "html_parser.h"
+#include "image_cache.h"
+
+// Test fixture for display list and page view tests
+class DisplayListTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+    }
+
+    static void TearDownTestSuite() {
+        ImageCache::instance().clear();
+        delete app;
+    }
+
+    static DisplayList build(const std::string& html, bool defer_decodes = false, bool lazy_images = false) {
+        DisplayListOptions options;
+        options.defer_decodes = defer_decodes;
+        options.lazy_images = lazy_images;
+        return Renderer().buildDisplayList(SimdParser().parseDocument(html), nullptr, options);
+    }
+
+    static std::string paragraphs(int count) {
+        std::string html;
+        for (int i = 0; i < count; ++i) html += "<p>Paragraph " + std::to_string(i) + "</p>";
+        return html + "<a href=\"http://example.com/end\">End</a>";
+    }
+
+    static QApplication* app;
+};
+
+QApplication* DisplayListTest::app = nullptr;
+
+// Unit Test: Each text block, header and link becomes one item
+TEST_F(DisplayListTest, OneItemPerBlock) {
+    DisplayList list = build("<h1>Title</h1><p>Body</p><div></div><a href=\"/x\">Link</a><a>No href</a>");
+    ASSERT_EQ(list.size(), static_cast<size_t>(3));
+    EXPECT_EQ(list.item(0).style, TextStyle::Header);
+    EXPECT_EQ(list.item(1).style, TextStyle::Body);
+    EXPECT_EQ(list.item(2).style, TextStyle::Link);
+    EXPECT_EQ(list.item(2).href, QString("/x"));
+}
+
+// Unit Test: Items stack top to bottom without overlapping
+TEST_F(DisplayListTest, LayoutStacksItems) {
+    DisplayList list = build(paragraphs(50));
+    const int height = list.layout(600);
+    for (size_t i = 1; i < list.size(); ++i) {
+        EXPECT_GT(list.item(i).rect.top(), list.item(i - 1).rect.bottom());
+    }
+    EXPECT_GT(height, list.item(list.size() - 1).rect.bottom());
+}
+
+// Unit Test: Narrower pages wrap text onto more lines
+TEST_F(DisplayListTest, WrapsToWidth) {
+    std::string words;
+    for (int i = 0; i < 100; ++i) words += "word ";
+    DisplayList list = build("<p>" + words + "</p>");
+    const int wide = list.layout(4000);
+    const int narrow = list.layout(200);
+    EXPECT_GT(narrow, wide);
+}
+
+// Unit Test: Only the items in the viewport are visited
+TEST_F(DisplayListTest, ItemsInViewport) {
+    DisplayList list = build(paragraphs(10000));
+    list.layout(800);
+    const int top = list.height() / 2;
+    const auto range = list.itemsIn(top, top + 600);
+    ASSERT_LT(range.first, range.second);
+    EXPECT_LT(range.second - range.first, static_cast<size_t>(100));
+    for (size_t i = range.first; i < range.second; ++i) {
+        EXPECT_TRUE(list.item(i).rect.intersects(QRect(0, top, 800, 600)));
+    }
+    EXPECT_LT(list.item(range.first - 1).rect.bottom(), top);
+    EXPECT_GE(list.item(range.second).rect.top(), top + 600);
+}
+
+// Unit Test: Links are found by position
+TEST_F(DisplayListTest, LinkHitTest) {
+    DisplayList list = build(paragraphs(100));
+    list.layout(800);
+    const DisplayItem& link = list.item(list.size() - 1);
+    const DisplayItem* hit = list.linkAt(link.rect.center());
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit->href, QString("http://example.com/end"));
+    EXPECT_EQ(list.linkAt(list.item(0).rect.center()), nullptr);
+    EXPECT_EQ(list.linkAt(QPoint(1, list.height() + 100)), nullptr);
+}
+
+// Unit Test: Deferred images keep the size of their attributes
+TEST_F(DisplayListTest, DeferredImagePlaceholder) {
+    DisplayList list = build("<img src=\"icon.svg\" width=\"40\" height=\"30\"><img src=\"missing.png\">", true);
+    ASSERT_EQ(list.size(), static_cast<size_t>(2));
+    EXPECT_EQ(list.item(0).kind, DisplayItem::Kind::Image);
+    EXPECT_EQ(list.item(0).size, QSize(40, 30));
+    EXPECT_TRUE(list.item(0).pixmap.isNull());
+    ASSERT_EQ(list.pendingImages().size(), static_cast<size_t>(1));
+    EXPECT_EQ(list.pendingImages()[0].item, static_cast<size_t>(0));
+    EXPECT_EQ(list.item(1).style, TextStyle::Notice); // unreadable header
+}
+
+// Unit Test: A long page is a single widget and clicks reach its links
+TEST_F(DisplayListTest, PageViewIsOneWidget) {
+    PageView view(build(paragraphs(10000)));
+    view.resize(800, 600);
+    EXPECT_TRUE(view.findChildren<QWidget*>().isEmpty());
+    EXPECT_GT(view.minimumHeight(), 10000);
+
+    QSignalSpy spy(&view, &PageView::linkClicked);
+    const DisplayList& list = view.displayList();
+    QTest::mouseClick(&view, Qt::LeftButton, Qt::NoModifier, list.item(list.size() - 1).rect.center());
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.at(0).at(0).toString(), QString("http://example.com/end"));
+}
+
+// Unit Test: Lazy images wait as placeholders sized from their attributes
+TEST_F(DisplayListTest, LazyImagePlaceholders) {
+    DisplayList list = build("<img src=\"a.png\" width=\"300\" height=\"200\"><img src=\"b.png\">", true, true);
+    ASSERT_EQ(list.size(), static_cast<size_t>(2));
+    EXPECT_EQ(list.item(0).size, QSize(300, 200));
+    EXPECT_EQ(list.item(1).size, QSize(100, 100)); // no attributes: a default square
+    ASSERT_EQ(list.lazyImages().size(), static_cast<size_t>(2));
+    EXPECT_EQ(list.lazyImages()[1].src, "b.png");
+    EXPECT_TRUE(list.pendingImages().empty());
+    list.layout(800);
+    EXPECT_EQ(list.lazyImagesIn(0, 100), (std::pair<size_t, size_t>(0, 1)));
+}
+
+// Unit Test: A fetched lazy image takes its size and is queued for decoding
+TEST_F(DisplayListTest, ResolvesLazyImage) {
+    QImage image(40, 20, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+
+    DisplayList list = build("<img src=\"a.png\"><img src=\"b.png\">", true, true);
+    list.layout(800);
+    Renderer::resolveLazyImage(&list, list.lazyImages()[0],
+                               MediaBuffer::fromBytes(bytes.toStdString(), "image/png", "http://x/a.png"), 1.0);
+    EXPECT_EQ(list.item(0).size, QSize(40, 20));
+    EXPECT_EQ(list.layoutWidth(), -1); // items below move up
+    ASSERT_EQ(list.pendingImages().size(), static_cast<size_t>(1));
+    EXPECT_EQ(list.pendingImages()[0].item, static_cast<size_t>(0));
+
+    Renderer::resolveLazyImage(&list, list.lazyImages()[1], nullptr, 1.0);
+    EXPECT_EQ(list.item(1).style, TextStyle::Notice);
+}
+
+// Unit Test: Only images near the visible area are fetched
+TEST_F(DisplayListTest, FetchesNearbyImagesOnly) {
+    std::string html = "<img src=\"top.png\" width=\"10\" height=\"10\">";
+    for (int i = 0; i < 2000; ++i) html += "<p>Filler</p>";
+    html += "<img src=\"bottom.png\" width=\"10\" height=\"10\">";
+    QScrollArea area;
+    area.setWidgetResizable(true);
+    area.resize(800, 600);
+    auto* view = new PageView(build(html, true, true));
+    area.setWidget(view);
+    std::vector<std::string> requested;
+    view->setMediaFetcher([&requested](const std::vector<std::string>& sources, PageView::MediaDone) {
+        requested.insert(requested.end(), sources.begin(), sources.end());
+    }, 200);
+    area.show();
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(&area));
+    QCoreApplication::processEvents();
+    EXPECT_EQ(requested, std::vector<std::string>{"top.png"});
+
+    area.verticalScrollBar()->setValue(area.verticalScrollBar()->maximum());
+    QCoreApplication::processEvents();
+    EXPECT_EQ(requested, (std::vector<std::string>{"top.png", "bottom.png"}));
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "dom.h"
+#include "html_parser.h"
+
+// Test fixture for Document tests
+class DocumentTest : public ::testing::Test {
+protected:
+    Document parse(const std::string& html) {
+        return SimdParser().parseDocument(html);
+    }
+};
+
+// Unit Test: Empty document has only a root
+TEST_F(DocumentTest, EmptyDocument) {
+    Document document;
+    EXPECT_EQ(document.nodeCount(), static_cast<size_t>(1));
+    EXPECT_EQ(document.node(document.root()).tag, TagAtom::Root);
+    EXPECT_EQ(document.node(document.root()).first_child, kNoNode);
+}
+
+// Unit Test: Text and attributes are views into the source
+TEST_F(DocumentTest, ViewsIntoSource) {
+    Document document = parse("<a href=\"http://example.com\">Link</a>");
+    NodeId link = document.node(document.root()).first_child;
+    ASSERT_NE(link, kNoNode);
+    const std::string& source = document.source();
+    std::string_view text = document.text(link);
+    std::string_view href = document.attribute(link, "href");
+    EXPECT_EQ(text, "Link");
+    EXPECT_EQ(href, "http://example.com");
+    EXPECT_GE(text.data(), source.data());
+    EXPECT_LT(text.data(), source.data() + source.size());
+    EXPECT_GE(href.data(), source.data());
+    EXPECT_LT(href.data(), source.data() + source.size());
+}
+
+// Unit Test: Children are linked in document order
+TEST_F(DocumentTest, SiblingLinks) {
+    Document document = parse("<p>One</p><div>Two</div><span>Three</span>");
+    std::vector<std::string> texts;
+    for (NodeId id = document.node(document.root()).first_child; id != kNoNode;
+         id = document.node(id).next_sibling) {
+        texts.emplace_back(document.text(id));
+    }
+    EXPECT_EQ(texts, (std::vector<std::string>{"One", "Two", "Three"}));
+}
+
+// Unit Test: forEachNode visits every node once, in document order
+TEST_F(DocumentTest, ForEachNodeInDocumentOrder) {
+    Document document = parse("<div><p>One</p><span>Two</span></div><h1>Three</h1>");
+    std::vector<TagAtom> tags;
+    document.forEachNode([&](NodeId id) { tags.push_back(document.node(id).tag); });
+    EXPECT_EQ(tags, (std::vector<TagAtom>{TagAtom::Root, TagAtom::Div, TagAtom::P, TagAtom::Span, TagAtom::H1}));
+}
+
+// Unit Test: Attribute lookup ignores case and the last duplicate wins
+TEST_F(DocumentTest, AttributeLookup) {
+    Document document = parse("<div ID=\"a\" class=\"c\" id=\"b\">x</div>");
+    NodeId div = document.node(document.root()).first_child;
+    EXPECT_EQ(document.attributeCount(div), static_cast<size_t>(3));
+    EXPECT_EQ(document.attributeName(div, 0), "ID");
+    EXPECT_EQ(document.attribute(div, "id"), "b");
+    std::string_view value;
+    EXPECT_FALSE(document.findAttribute(div, "title", value));
+    EXPECT_TRUE(document.attribute(div, "title").empty());
+}
+
+// Unit Test: Replaced attribute values live in the side buffer
+TEST_F(DocumentTest, ReplaceAttribute) {
+    Document document = parse("<img src=\"logo.png\">");
+    NodeId img = document.node(document.root()).first_child;
+    EXPECT_TRUE(document.replaceAttribute(img, "src", "cache/123.media"));
+    EXPECT_EQ(document.attribute(img, "src"), "cache/123.media");
+    EXPECT_FALSE(document.replaceAttribute(img, "alt", "x"));
+    EXPECT_EQ(document.source(), "<img src=\"logo.png\">");
+}
+
+// Unit Test: Arena grows without breaking links
+TEST_F(DocumentTest, ArenaGrowth) {
+    std::string html;
+    for (int i = 0; i < 2000; ++i) html += "<p a=\"1\" b=\"2\" c=\"3\">t" + std::to_string(i) + "</p>";
+    DomArena arena(64);
+    for (int i = 0; i < 1000; ++i) {
+        arena.node(arena.addNode()).first_attribute = static_cast<uint32_t>(i);
+        arena.attribute(arena.addAttribute()).name.offset = static_cast<uint32_t>(i);
+    }
+    for (uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(arena.node(i).first_attribute, i);
+        EXPECT_EQ(arena.attribute(i).name.offset, i);
+    }
+    Document parsed = parse(html);
+    EXPECT_EQ(parsed.nodeCount(), static_cast<size_t>(2001));
+    NodeId last = parsed.node(parsed.root()).last_child;
+    EXPECT_EQ(parsed.text(last), "t1999");
+    EXPECT_EQ(parsed.attribute(last, "c"), "3");
+}
+
+// Unit Test: toNode matches the legacy parser output
+TEST_F(DocumentTest, ToNodeMatchesScalar) {
+    const std::string html = "<H1>Title</H1><p CLASS=\"x\">Body</p><img src=\"a.png\"><a href=\"/n\">Next</a>";
+    Node expected = ScalarParser().parse(html);
+    Node actual = parse(html).toNode();
+    ASSERT_EQ(actual.children.size(), expected.children.size());
+    for (size_t i = 0; i < expected.children.size(); ++i) {
+        EXPECT_EQ(actual.children[i].type, expected.children[i].type);
+        EXPECT_EQ(actual.children[i].text, expected.children[i].text);
+        EXPECT_EQ(actual.children[i].attributes, expected.children[i].attributes);
+    }
+}
+
+// Unit Test: fromNode round-trips a hand-built tree
+TEST_F(DocumentTest, FromNodeRoundTrip) {
+    Node root;
+    root.type = "root";
+    Node div;
+    div.type = "div";
+    div.text = "outer";
+    Node link;
+    link.type = "link";
+    link.text = "inner";
+    link.attributes["href"] = "http://example.com";
+    div.children.push_back(link);
+    root.children.push_back(div);
+
+    Node copy = Document::fromNode(root).toNode();
+    ASSERT_EQ(copy.children.size(), static_cast<size_t>(1));
+    EXPECT_EQ(copy.children[0].type, "div");
+    EXPECT_EQ(copy.children[0].text, "outer");
+    ASSERT_EQ(copy.children[0].children.size(), static_cast<size_t>(1));
+    EXPECT_EQ(copy.children[0].children[0].type, "link");
+    EXPECT_EQ(copy.children[0].children[0].attributes["href"], "http://example.com");
+}
+
+// Unit Test: Default parseDocument adapts parse()
+TEST_F(DocumentTest, ScalarParseDocument) {
+    Document document = ScalarParser().parseDocument("<p>Hi</p>");
+    NodeId p = document.node(document.root()).first_child;
+    ASSERT_NE(p, kNoNode);
+    EXPECT_EQ(document.node(p).tag, TagAtom::P);
+    EXPECT_EQ(document.text(p), "Hi");
+}
+
+// Unit Test: Memory accounting covers the source and the arena
+TEST_F(DocumentTest, MemoryBytes) {
+    Document document(std::string(1000, 'x'));
+    const size_t before = document.memoryBytes();
+    EXPECT_GE(before, static_cast<size_t>(1000));
+    for (int i = 0; i < 1000; ++i) document.appendChild(document.root(), TagAtom::Div);
+    EXPECT_GT(document.memoryBytes(), before);
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "html_parser.h"
+#include <algorithm>
+#include <random>
 
 // Заглушочная реализация HtmlParser для тестов
 class ConcreteHtmlParser : public HtmlParser {
@@ -153,4 +155,196 @@ TEST_F(HtmlParserTest, ScalarParser_InvalidAttributes) {
     ASSERT_EQ(result.children.size(), static_cast<size_t>(1));
     EXPECT_EQ(result.children[0].type, "p");
     EXPECT_EQ(result.children[0].text, "<p class=>Invalid</p>");
+}
+
+// Unit Test: An attribute value left open at the end of the input ends the tag
+TEST_F(HtmlParserTest, ScalarParser_UnterminatedAttributeAtEnd) {
+    Node result = ScalarParser().parse("<p class=\"open");
+    ASSERT_EQ(result.children.size(), static_cast<size_t>(1));
+    EXPECT_EQ(result.children[0].type, "p");
+    EXPECT_EQ(result.children[0].attributes.at("class"), "open");
+    EXPECT_EQ(result.children[0].text, "");
+}
+
+// Recursively compares two DOM trees
+static void ExpectSameTree(const Node& expected, const Node& actual) {
+    EXPECT_EQ(expected.type, actual.type);
+    EXPECT_EQ(expected.text, actual.text);
+    EXPECT_EQ(expected.attributes, actual.attributes);
+    ASSERT_EQ(expected.children.size(), actual.children.size());
+    for (size_t i = 0; i < expected.children.size(); ++i) {
+        ExpectSameTree(expected.children[i], actual.children[i]);
+    }
+}
+
+// Markup shared by the parser equivalence tests
+static const std::vector<std::string> kParserCorpus = {
+    "",
+    "Just text",
+    "<p>Hello, World!</p>",
+    "<div><p>Nested</p></div>",
+    "<p>First</p><p>Second</p>",
+    "<p>Text</p><!-- Comment -->",
+    "<p>Unclosed tag",
+    "<a href=\"http://example.com\" class=\"test-class\">Link</a>",
+    "  <p>  Text  </p>  ",
+    "<br/>",
+    "<p class=>Invalid</p>",
+    "<P CLASS=\"Upper\">Mixed case</P><H1>Title</H1><h2>Sub</h2>",
+    "<img src=\"a.png\" width=\"10\" height=\"20\" /><span>after image</span>",
+    "<a href=x>unquoted</a><a href=\"unterminated>",
+    "<div id=\"a\" id=\"b\" data-x>dup</div><p",
+    "<",
+    "<p>trailing <",
+    "</p></div>text<p>ok</p>",
+    "<span title=\"a > b\">quoted gt</span>",
+};
+
+// Vectorized parsers share one tokenizer and must agree with ScalarParser
+template <typename T>
+class VectorParserTest : public ::testing::Test {};
+
+// Pins SimdParser to one instruction set (portable classifier if the CPU lacks it)
+template <SimdLevel Level>
+class FixedSimdParser : public SimdParser {
+public:
+    FixedSimdParser() : SimdParser(Level) {}
+};
+
+using VectorParsers = ::testing::Types<SimdParser, FixedSimdParser<SimdLevel::Sse2>,
+                                       FixedSimdParser<SimdLevel::Avx2>,
+                                       FixedSimdParser<SimdLevel::Avx512>, NeonParser>;
+TYPED_TEST_SUITE(VectorParserTest, VectorParsers);
+
+// Unit Test: Vectorized parsers match ScalarParser on the shared corpus
+TYPED_TEST(VectorParserTest, MatchesScalarOnCorpus) {
+    ScalarParser scalar;
+    TypeParam vector_parser;
+    for (const auto& html : kParserCorpus) {
+        SCOPED_TRACE(html);
+        ExpectSameTree(scalar.parse(html), vector_parser.parse(html));
+    }
+}
+
+// Unit Test: Vectorized parsers match ScalarParser at every 64-byte block boundary
+TYPED_TEST(VectorParserTest, MatchesScalarAcrossBlockBoundaries) {
+    ScalarParser scalar;
+    TypeParam vector_parser;
+    const std::string tail = "<a href=\"http://example.com/x\" class=\"c\">Link</a><img src=\"i.png\">";
+    for (size_t pad = 0; pad < 130; ++pad) {
+        std::string html(pad, 'x');
+        html += tail;
+        SCOPED_TRACE(pad);
+        ExpectSameTree(scalar.parse(html), vector_parser.parse(html));
+    }
+}
+
+// Unit Test: Vectorized parsers match ScalarParser on a large generated page
+TYPED_TEST(VectorParserTest, MatchesScalarOnLargePage) {
+    std::string html = "<html><body>";
+    for (int i = 0; i < 5000; ++i) {
+        html += "<div class=\"row\" id=\"r" + std::to_string(i) + "\"><h2>Item " + std::to_string(i) + "</h2>";
+        html += "<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit.</p>";
+        html += "<img src=\"/img/" + std::to_string(i) + ".jpg\" width=\"120\" height=\"80\">";
+        html += "<a href=\"/item/" + std::to_string(i) + "\">More</a></div>\n";
+    }
+    html += "</body></html>";
+    Node expected = ScalarParser().parse(html);
+    Node actual = TypeParam().parse(html);
+    ASSERT_EQ(expected.children.size(), static_cast<size_t>(25000));
+    ExpectSameTree(expected, actual);
+}
+
+
+// Unit Test: Vectorized parsers keep every attribute of an element with more than 65,535 of them
+TYPED_TEST(VectorParserTest, MatchesScalarOnManyAttributes) {
+    const size_t count = 70000;
+    std::string html = "<p";
+    for (size_t i = 0; i < count; ++i) html += " a" + std::to_string(i) + "=\"" + std::to_string(i) + "\"";
+    html += ">Text</p>";
+    Node expected = ScalarParser().parse(html);
+    ASSERT_EQ(expected.children.size(), static_cast<size_t>(1));
+    ASSERT_EQ(expected.children[0].attributes.size(), count);
+    const Document document = TypeParam().parseDocument(html);
+    EXPECT_EQ(document.attributeCount(document.node(document.root()).first_child), count);
+    ExpectSameTree(expected, TypeParam().parse(html));
+}
+
+// Unit Test: Vectorized parsers match ScalarParser on random markup fragments
+TYPED_TEST(VectorParserTest, MatchesScalarOnRandomMarkup) {
+    static const char* kPieces[] = {"<", ">", "</", "\"", "=", " ", "p", "img", "a", "div", "span",
+                                    "h1", "href", "src", "text", "\n", "<p>", "<a href=\"", "<img "};
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(kPieces) / sizeof(kPieces[0]) - 1);
+    ScalarParser scalar;
+    TypeParam vector_parser;
+    for (int round = 0; round < 200; ++round) {
+        std::string html;
+        for (int i = 0; i < 300; ++i) html += kPieces[pick(rng)];
+        SCOPED_TRACE(html);
+        ExpectSameTree(scalar.parse(html), vector_parser.parse(html));
+    }
+}
+
+// Feeds html to a stream in pieces of the given sizes (cycled) and finishes it
+static Node ParseInChunks(HtmlParser& parser, const std::string& html, const std::vector<size_t>& sizes) {
+    std::unique_ptr<ParseStream> stream = parser.stream();
+    size_t pos = 0;
+    for (size_t i = 0; pos < html.size(); ++i) {
+        const size_t size = std::min(sizes[i % sizes.size()], html.size() - pos);
+        stream->feed(html.data() + pos, size);
+        pos += size;
+    }
+    return stream->finish().toNode();
+}
+
+// Unit Test: Streaming matches a one-shot parse for every two-chunk split
+TYPED_TEST(VectorParserTest, StreamMatchesAtEverySplit) {
+    ScalarParser scalar;
+    TypeParam vector_parser;
+    for (const auto& html : kParserCorpus) {
+        const Node expected = scalar.parse(html);
+        for (size_t split = 0; split <= html.size(); ++split) {
+            SCOPED_TRACE(html + " @" + std::to_string(split));
+            std::unique_ptr<ParseStream> stream = vector_parser.stream();
+            stream->feed(html.data(), split);
+            stream->feed(html.data() + split, html.size() - split);
+            ExpectSameTree(expected, stream->finish().toNode());
+        }
+    }
+}
+
+// Unit Test: Streaming one byte at a time resumes mid-tag, mid-attribute and mid-text
+TYPED_TEST(VectorParserTest, StreamMatchesByteAtATime) {
+    ScalarParser scalar;
+    TypeParam vector_parser;
+    for (const auto& html : kParserCorpus) {
+        SCOPED_TRACE(html);
+        ExpectSameTree(scalar.parse(html), ParseInChunks(vector_parser, html, {1}));
+    }
+}
+
+// Unit Test: Streaming a large page in uneven chunks matches a one-shot parse
+TYPED_TEST(VectorParserTest, StreamMatchesOnLargePage) {
+    std::string html;
+    for (int i = 0; i < 2000; ++i) {
+        html += "<div id=\"r" + std::to_string(i) + "\"><p>Paragraph " + std::to_string(i) + "</p>";
+        html += "<img src=\"/img/" + std::to_string(i) + ".jpg\"><a href=\"/i/" + std::to_string(i) + "\">More</a></div>";
+    }
+    TypeParam vector_parser;
+    const Node expected = vector_parser.parse(html);
+    ExpectSameTree(expected, ParseInChunks(vector_parser, html, {1, 7, 63, 64, 65, 4096, 3}));
+}
+
+// Unit Test: Parsers without an incremental tokenizer buffer the stream
+TEST_F(HtmlParserTest, ScalarParser_StreamBuffers) {
+    const std::string html = "<p>Hello</p><a href=\"x\">Link</a>";
+    ExpectSameTree(scalar_parser->parse(html), ParseInChunks(*scalar_parser, html, {2, 5}));
+}
+
+// Unit Test: Finishing an empty stream yields an empty document
+TEST_F(HtmlParserTest, SimdParser_EmptyStream) {
+    Document document = SimdParser().stream()->finish();
+    EXPECT_EQ(document.nodeCount(), static_cast<size_t>(1));
+    EXPECT_TRUE(document.source().empty());
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "http_cache.h"
+#include <ctime>
+#include <string>
+
+// Fixed clock for freshness arithmetic
+static const std::time_t kNow = 1700000000;
+
+// Formats a time as an IMF-fixdate HTTP-date
+static std::string HttpDate(std::time_t t) {
+    char buffer[64];
+    std::tm tm_utc{};
+#if defined(_WIN32)
+    gmtime_s(&tm_utc, &t);
+#else
+    gmtime_r(&t, &tm_utc);
+#endif
+    std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+    return buffer;
+}
+
+// Unit Test: URLs are normalized into cache keys
+TEST(HttpCacheTest, NormalizeUrl) {
+    EXPECT_EQ(HttpCache::normalizeUrl("HTTP://Example.COM"), "http://example.com/");
+    EXPECT_EQ(HttpCache::normalizeUrl("http://example.com:80/a/B?x=1#frag"), "http://example.com/a/B?x=1");
+    EXPECT_EQ(HttpCache::normalizeUrl("https://example.com:443?q"), "https://example.com/?q");
+    EXPECT_EQ(HttpCache::normalizeUrl("http://example.com:8080/"), "http://example.com:8080/");
+}
+
+// Unit Test: max-age keeps an entry fresh, then it goes stale
+TEST(HttpCacheTest, MaxAge) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.cache_control = "public, max-age=60";
+    headers.etag = "\"v1\"";
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    HttpCache::Lookup hit = cache.lookup("http://EXAMPLE.com/#top", kNow + 59);
+    EXPECT_EQ(hit.state, HttpCache::State::Fresh);
+    ASSERT_TRUE(hit.body);
+    EXPECT_EQ(*hit.body, "body");
+    HttpCache::Lookup stale = cache.lookup("http://example.com/", kNow + 60);
+    EXPECT_EQ(stale.state, HttpCache::State::Stale);
+    EXPECT_EQ(stale.etag, "\"v1\"");
+}
+
+// Unit Test: no-store responses are never kept
+TEST(HttpCacheTest, NoStore) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.cache_control = "no-store, max-age=600";
+    EXPECT_FALSE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow).state, HttpCache::State::Miss);
+}
+
+// Unit Test: no-cache responses are kept but always revalidated
+TEST(HttpCacheTest, NoCache) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.cache_control = "no-cache";
+    headers.last_modified = HttpDate(kNow - 3600);
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    HttpCache::Lookup lookup = cache.lookup("http://example.com/", kNow);
+    EXPECT_EQ(lookup.state, HttpCache::State::Stale);
+    EXPECT_EQ(lookup.last_modified, headers.last_modified);
+}
+
+// Unit Test: Expires is measured from the response Date
+TEST(HttpCacheTest, Expires) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.date = HttpDate(kNow);
+    headers.expires = HttpDate(kNow + 120);
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 119).state, HttpCache::State::Fresh);
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 120).state, HttpCache::State::Stale);
+}
+
+// Unit Test: Without explicit freshness, 10% of the Last-Modified age is used
+TEST(HttpCacheTest, HeuristicFreshness) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.date = HttpDate(kNow);
+    headers.last_modified = HttpDate(kNow - 1000);
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 99).state, HttpCache::State::Fresh);
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 100).state, HttpCache::State::Stale);
+}
+
+// Unit Test: Responses that are never fresh and have no validators are skipped
+TEST(HttpCacheTest, UncacheableWithoutValidators) {
+    HttpCache cache;
+    CacheHeaders headers;
+    EXPECT_FALSE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    headers.cache_control = "max-age=60";
+    EXPECT_FALSE(cache.store("http://example.com/", 404, headers, "missing", kNow));
+    EXPECT_EQ(cache.entryCount(), static_cast<size_t>(0));
+}
+
+// Unit Test: storable() decides from the headers alone what store() keeps
+TEST(HttpCacheTest, Storable) {
+    HttpCache cache(16);
+    CacheHeaders headers;
+    headers.cache_control = "max-age=60";
+    EXPECT_TRUE(cache.storable(200, headers, 0, kNow));
+    EXPECT_TRUE(cache.storable(200, headers, 16, kNow));
+    EXPECT_FALSE(cache.storable(200, headers, 17, kNow));
+    EXPECT_FALSE(cache.storable(404, headers, 0, kNow));
+    headers.cache_control = "max-age=60, no-store";
+    EXPECT_FALSE(cache.storable(200, headers, 0, kNow));
+    headers.cache_control.clear();
+    EXPECT_FALSE(cache.storable(200, headers, 0, kNow));
+    headers.etag = "\"v1\"";
+    EXPECT_TRUE(cache.storable(200, headers, 0, kNow));
+}
+
+// Unit Test: The Age header counts against freshness
+TEST(HttpCacheTest, AgeHeader) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.cache_control = "max-age=100";
+    headers.age = "90";
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 9).state, HttpCache::State::Fresh);
+    EXPECT_EQ(cache.lookup("http://example.com/", kNow + 10).state, HttpCache::State::Stale);
+}
+
+// Unit Test: A 304 refreshes the entry and replays the stored body
+TEST(HttpCacheTest, Revalidated) {
+    HttpCache cache;
+    CacheHeaders headers;
+    headers.cache_control = "max-age=10";
+    headers.etag = "\"v1\"";
+    ASSERT_TRUE(cache.store("http://example.com/", 200, headers, "body", kNow));
+    ASSERT_EQ(cache.lookup("http://example.com/", kNow + 20).state, HttpCache::State::Stale);
+    CacheHeaders not_modified;
+    not_modified.cache_control = "max-age=30";
+    auto body = cache.revalidated("http://example.com/", not_modified, kNow + 20);
+    ASSERT_TRUE(body);
+    EXPECT_EQ(*body, "body");
+    HttpCache::Lookup lookup = cache.lookup("http://example.com/", kNow + 49);
+    EXPECT_EQ(lookup.state, HttpCache::State::Fresh);
+    EXPECT_EQ(lookup.etag, "\"v1\"");
+    EXPECT_FALSE(cache.revalidated("http://example.com/other", not_modified, kNow));
+}
+
+// Unit Test: Least recently used entries are evicted past the byte budget
+TEST(HttpCacheTest, EvictsLeastRecentlyUsed) {
+    HttpCache cache(10);
+    CacheHeaders headers;
+    headers.cache_control = "max-age=60";
+    cache.store("http://a/", 200, headers, "aaaa", kNow);
+    cache.store("http://b/", 200, headers, "bbbb", kNow);
+    cache.lookup("http://a/", kNow); // a is now most recent
+    cache.store("http://c/", 200, headers, "cccc", kNow);
+    EXPECT_EQ(cache.lookup("http://b/", kNow).state, HttpCache::State::Miss);
+    EXPECT_EQ(cache.lookup("http://a/", kNow).state, HttpCache::State::Fresh);
+    EXPECT_EQ(cache.lookup("http://c/", kNow).state, HttpCache::State::Fresh);
+    EXPECT_EQ(cache.sizeBytes(), static_cast<size_t>(8));
+    EXPECT_FALSE(cache.store("http://big/", 200, headers, std::string(11, 'x'), kNow));
+}
+
+// Unit Test: Header lines are parsed case-insensitively and reset per response
+TEST(HttpCacheTest, ParseHeaderLines) {
+    CacheHeaders headers;
+    headers.parseLine("HTTP/1.1 301 Moved Permanently\r\n");
+    headers.parseLine("ETag: \"old\"\r\n");
+    headers.parseLine("HTTP/1.1 200 OK\r\n");
+    headers.parseLine("cache-control: public\r\n");
+    headers.parseLine("CACHE-CONTROL: max-age=5\r\n");
+    headers.parseLine("Last-Modified:  Tue, 14 Nov 2023 22:13:20 GMT \r\n");
+    headers.parseLine("\r\n");
+    EXPECT_TRUE(headers.etag.empty());
+    EXPECT_EQ(headers.cache_control, "public, max-age=5");
+    EXPECT_EQ(headers.last_modified, "Tue, 14 Nov 2023 22:13:20 GMT");
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QPixmap>
+#include "image_cache.h"
+
+// Test fixture for ImageCache tests; pixmaps need a GUI application
+class ImageCacheTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+    }
+
+    static void TearDownTestSuite() {
+        delete app;
+    }
+
+    static ImageKey Key(const std::string& source, int width = -1, int height = -1, qreal ratio = 1.0) {
+        ImageKey key;
+        key.source = source;
+        key.source_size = 100;
+        key.width = width;
+        key.height = height;
+        key.device_pixel_ratio = ratio;
+        return key;
+    }
+
+    static QApplication* app;
+};
+
+QApplication* ImageCacheTest::app = nullptr;
+
+// Unit Test: A stored pixmap is found and shared, not copied
+TEST_F(ImageCacheTest, FindSharesPixmap) {
+    ImageCache cache;
+    QPixmap pixmap(10, 10);
+    pixmap.fill(Qt::red);
+    cache.insert(Key("http://a/logo.png"), pixmap);
+    QPixmap found;
+    ASSERT_TRUE(cache.find(Key("http://a/logo.png"), &found));
+    EXPECT_EQ(found.cacheKey(), pixmap.cacheKey());
+}
+
+// Unit Test: Hits and misses are counted
+TEST_F(ImageCacheTest, CountsHitsAndMisses) {
+    ImageCache cache;
+    EXPECT_FALSE(cache.find(Key("http://a/logo.png"), nullptr));
+    cache.insert(Key("http://a/logo.png"), QPixmap(4, 4));
+    EXPECT_TRUE(cache.find(Key("http://a/logo.png"), nullptr));
+    EXPECT_TRUE(cache.find(Key("http://a/logo.png"), nullptr));
+    ImageCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, static_cast<size_t>(1));
+    EXPECT_EQ(stats.bytes, ImageCache::costOf(QPixmap(4, 4)));
+}
+
+// Unit Test: Size, pixel ratio and encoded size are part of the key
+TEST_F(ImageCacheTest, KeyIncludesRendition) {
+    ImageCache cache;
+    cache.insert(Key("http://a/logo.png", 20, 20, 1.0), QPixmap(20, 20));
+    EXPECT_FALSE(cache.find(Key("http://a/logo.png", 40, 40, 1.0), nullptr));
+    EXPECT_FALSE(cache.find(Key("http://a/logo.png", 20, 20, 2.0), nullptr));
+    ImageKey changed = Key("http://a/logo.png", 20, 20, 1.0);
+    changed.source_size = 101;
+    EXPECT_FALSE(cache.find(changed, nullptr));
+    EXPECT_TRUE(cache.find(Key("http://a/logo.png", 20, 20, 1.0), nullptr));
+}
+
+// Unit Test: Least recently used pixmaps are evicted past the cap
+TEST_F(ImageCacheTest, EvictsLeastRecentlyUsed) {
+    const size_t cost = ImageCache::costOf(QPixmap(10, 10));
+    ImageCache cache(cost * 2);
+    cache.insert(Key("a"), QPixmap(10, 10));
+    cache.insert(Key("b"), QPixmap(10, 10));
+    cache.find(Key("a"), nullptr); // b is now least recently used
+    cache.insert(Key("c"), QPixmap(10, 10));
+    EXPECT_FALSE(cache.find(Key("b"), nullptr));
+    EXPECT_TRUE(cache.find(Key("a"), nullptr));
+    EXPECT_TRUE(cache.find(Key("c"), nullptr));
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+// Unit Test: Pixmaps larger than the cap are not kept
+TEST_F(ImageCacheTest, SkipsOversized) {
+    ImageCache cache(16);
+    cache.insert(Key("big"), QPixmap(100, 100));
+    EXPECT_FALSE(cache.find(Key("big"), nullptr));
+    EXPECT_EQ(cache.stats().bytes, static_cast<size_t>(0));
+}
+
+// Unit Test: Lowering the cap evicts at once
+TEST_F(ImageCacheTest, SetCapacityEvicts) {
+    ImageCache cache;
+    cache.insert(Key("a"), QPixmap(10, 10));
+    cache.insert(Key("b"), QPixmap(10, 10));
+    cache.setCapacity(ImageCache::costOf(QPixmap(10, 10)));
+    EXPECT_EQ(cache.stats().entries, static_cast<size_t>(1));
+    EXPECT_TRUE(cache.find(Key("b"), nullptr));
+    cache.clear();
+    EXPECT_EQ(cache.stats().entries, static_cast<size_t>(0));
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QImage>
+#include <QThread>
+#include <QThreadPool>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include "image_decoder.h"
+
+namespace {
+
+const char kSvg[] = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                    "<rect width=\"10\" height=\"10\"/></svg>";
+
+} // namespace
+
+// Test fixture for image decoder tests; results are delivered through the event loop
+class ImageDecoderTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+        QImage image(40, 20, QImage::Format_ARGB32);
+        image.fill(Qt::red);
+        image.save("decoder_test.png");
+    }
+
+    static void TearDownTestSuite() {
+        std::remove("decoder_test.png");
+        delete app;
+    }
+
+    // Waits for every queued decode, then runs the deliveries they posted.
+    static void settle() {
+        QThreadPool::globalInstance()->waitForDone();
+        QCoreApplication::processEvents();
+    }
+
+    static DecodeRequest pngRequest(QSize target = QSize()) {
+        DecodeRequest request;
+        request.path = "decoder_test.png";
+        request.target = target;
+        return request;
+    }
+
+    static QApplication* app;
+};
+
+QApplication* ImageDecoderTest::app = nullptr;
+
+// Unit Test: The natural size is read from the header
+TEST_F(ImageDecoderTest, ReadsImageSize) {
+    EXPECT_EQ(imageSize(pngRequest()), QSize(40, 20));
+    DecodeRequest bad;
+    bad.media = MediaBuffer::fromBytes("not an image", "image/png");
+    EXPECT_FALSE(imageSize(bad).isValid());
+}
+
+// Unit Test: Raster images decode straight to the target size
+TEST_F(ImageDecoderTest, DecodesAtTargetSize) {
+    EXPECT_EQ(decodeImage(pngRequest()).size(), QSize(40, 20));
+    EXPECT_EQ(decodeImage(pngRequest(QSize(20, 10))).size(), QSize(20, 10));
+}
+
+// Unit Test: SVG is rasterized from memory at the target size
+TEST_F(ImageDecoderTest, RasterizesSvg) {
+    DecodeRequest request;
+    request.media = MediaBuffer::fromBytes(kSvg, "image/svg+xml");
+    request.svg = true;
+    request.target = QSize(30, 30);
+    EXPECT_EQ(decodeImage(request).size(), QSize(30, 30));
+    request.media = MediaBuffer::fromBytes("<svg", "image/svg+xml");
+    EXPECT_TRUE(decodeImage(request).isNull());
+}
+
+// Unit Test: Async results arrive on the GUI thread
+TEST_F(ImageDecoderTest, DeliversOnGuiThread) {
+    auto group = std::make_shared<DecodeGroup>();
+    QObject receiver;
+    QSize size;
+    QThread* thread = nullptr;
+    decodeAsync(group, pngRequest(QSize(8, 4)), &receiver, [&](const QImage& image) {
+        size = image.size();
+        thread = QThread::currentThread();
+    });
+    settle();
+    EXPECT_EQ(size, QSize(8, 4));
+    EXPECT_EQ(thread, app->thread());
+}
+
+// Unit Test: A cancelled group drops its results
+TEST_F(ImageDecoderTest, CancelledGroupDropsResults) {
+    auto group = std::make_shared<DecodeGroup>();
+    QObject receiver;
+    int delivered = 0;
+    for (int i = 0; i < 8; ++i) {
+        decodeAsync(group, pngRequest(), &receiver, [&](const QImage&) { ++delivered; });
+    }
+    group->cancel();
+    settle();
+    EXPECT_EQ(delivered, 0);
+}
+
+// Unit Test: A destroyed receiver is never called back
+TEST_F(ImageDecoderTest, DestroyedReceiverDropsResult) {
+    auto group = std::make_shared<DecodeGroup>();
+    auto receiver = std::make_unique<QObject>();
+    bool delivered = false;
+    decodeAsync(group, pngRequest(), receiver.get(), [&](const QImage&) { delivered = true; });
+    QThreadPool::globalInstance()->waitForDone();
+    receiver.reset();
+    QCoreApplication::processEvents();
+    EXPECT_FALSE(delivered);
+}
\ No newline at end of file
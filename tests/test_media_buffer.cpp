@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "media_buffer.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Unit Test: A downloaded body is wrapped without copying
+TEST(MediaBufferTest, FromBytes) {
+    std::string body(1000, 'x');
+    const char* bytes = body.data();
+    MediaBufferPtr buffer = MediaBuffer::fromBytes(std::move(body), "image/png");
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(buffer->size(), static_cast<size_t>(1000));
+    EXPECT_EQ(buffer->data(), bytes);
+    EXPECT_EQ(buffer->contentType(), "image/png");
+    EXPECT_FALSE(buffer->isMapped());
+}
+
+// Unit Test: A file is mapped with its exact contents
+TEST(MediaBufferTest, MapsFile) {
+    std::ofstream("media_buffer_test.bin", std::ios::binary) << "mapped bytes";
+    MediaBufferPtr buffer = MediaBuffer::map("media_buffer_test.bin", "image/gif");
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(std::string(buffer->data(), buffer->size()), "mapped bytes");
+    EXPECT_EQ(buffer->contentType(), "image/gif");
+    fs::remove("media_buffer_test.bin");
+}
+
+// Unit Test: Missing and empty files do not map
+TEST(MediaBufferTest, MapFailures) {
+    EXPECT_FALSE(MediaBuffer::map("media_buffer_missing.bin", ""));
+    std::ofstream("media_buffer_empty.bin", std::ios::binary).close();
+    EXPECT_FALSE(MediaBuffer::map("media_buffer_empty.bin", ""));
+    fs::remove("media_buffer_empty.bin");
+}
+
+// Unit Test: A mapping stays readable after its file is unlinked
+TEST(MediaBufferTest, OutlivesUnlink) {
+    std::ofstream("media_buffer_test.bin", std::ios::binary) << "still here";
+    MediaBufferPtr buffer = MediaBuffer::map("media_buffer_test.bin", "");
+    ASSERT_TRUE(buffer);
+    fs::remove("media_buffer_test.bin");
+    EXPECT_EQ(std::string(buffer->data(), buffer->size()), "still here");
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "media_cache.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define QUICKDOM_TEST_FORK 1
+#endif
+
+namespace fs = std::filesystem;
+
+// Test fixture with a scratch cache directory
+class MediaCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override { fs::remove_all(dir); }
+    void TearDown() override { fs::remove_all(dir); }
+
+    // Downloads (writes) a body into a temp file and commits it
+    std::string Put(MediaCache& cache, const std::string& url, const std::string& body) {
+        const std::string temp = cache.tempPath();
+        std::ofstream(temp, std::ios::binary) << body;
+        return cache.commit(url, temp, "image/png; charset=binary", "\"tag\"", "");
+    }
+
+    const std::string dir = "media_cache_test";
+};
+
+// Unit Test: Keys are MurmurHash3 x64/128 and stable across builds
+TEST_F(MediaCacheTest, StableKeys) {
+    MediaCache::Key key = MediaCache::keyFor("The quick brown fox jumps over the lazy dog");
+    EXPECT_EQ(key.hi, 0xe34bbc7bbc071b6cull);
+    EXPECT_EQ(key.lo, 0x7a433ca9c49a9347ull);
+    EXPECT_EQ(key.hex(), "e34bbc7bbc071b6c7a433ca9c49a9347");
+    EXPECT_EQ(MediaCache::keyFor("HTTP://Example.com/a.png#x"), MediaCache::keyFor("http://example.com/a.png"));
+    EXPECT_FALSE(MediaCache::keyFor("http://example.com/a.png") == MediaCache::keyFor("http://example.com/b.png"));
+}
+
+// Unit Test: A committed file is found with its metadata
+TEST_F(MediaCacheTest, CommitAndLookup) {
+    MediaCache cache(dir);
+    EXPECT_FALSE(cache.lookup("http://example.com/a.png"));
+    const std::string path = Put(cache, "http://example.com/a.png", "pixels");
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path, cache.pathFor(MediaCache::keyFor("http://example.com/a.png")));
+    MediaEntry entry;
+    ASSERT_TRUE(cache.lookup("http://example.com/a.png", &entry));
+    EXPECT_EQ(entry.path, path);
+    EXPECT_EQ(entry.size, static_cast<uint64_t>(6));
+    EXPECT_EQ(entry.content_type, "image/png");
+    EXPECT_EQ(entry.etag, "\"tag\"");
+    EXPECT_EQ(fs::file_size(path), static_cast<uintmax_t>(6));
+    EXPECT_EQ(cache.sizeBytes(), static_cast<uint64_t>(6));
+}
+
+// Unit Test: Commit renames the temporary file into place
+TEST_F(MediaCacheTest, CommitIsRename) {
+    MediaCache cache(dir);
+    const std::string temp = cache.tempPath();
+    EXPECT_NE(temp, cache.tempPath());
+    std::ofstream(temp, std::ios::binary) << "data";
+    const std::string path = cache.commit("http://example.com/a.png", temp, "", "", "");
+    EXPECT_FALSE(fs::exists(temp));
+    EXPECT_TRUE(fs::exists(path));
+    EXPECT_TRUE(cache.commit("http://example.com/b.png", dir + "/missing.tmp", "", "", "").empty());
+}
+
+// Unit Test: Least recently used files are evicted past the budget
+TEST_F(MediaCacheTest, EvictsLeastRecentlyUsed) {
+    MediaCache cache(dir, 100);
+    const std::string a = Put(cache, "http://x/a", std::string(40, 'a'));
+    const std::string b = Put(cache, "http://x/b", std::string(40, 'b'));
+    EXPECT_TRUE(cache.lookup("http://x/a")); // b is now least recently used
+    const std::string c = Put(cache, "http://x/c", std::string(40, 'c'));
+    EXPECT_FALSE(cache.lookup("http://x/b"));
+    EXPECT_FALSE(fs::exists(b));
+    EXPECT_TRUE(cache.lookup("http://x/a"));
+    EXPECT_TRUE(cache.lookup("http://x/c"));
+    EXPECT_LE(cache.sizeBytes(), static_cast<uint64_t>(100));
+    EXPECT_EQ(cache.entryCount(), static_cast<size_t>(2));
+}
+
+// Unit Test: The index never fills; old entries make room for new ones
+TEST_F(MediaCacheTest, EvictsWhenIndexIsFull) {
+    MediaCache cache(dir, 1 << 20, 16);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_FALSE(Put(cache, "http://x/" + std::to_string(i), "v").empty());
+    }
+    EXPECT_LE(cache.entryCount(), static_cast<size_t>(12));
+    EXPECT_TRUE(cache.lookup("http://x/99"));
+    size_t files = 0;
+    for (const auto& file : fs::directory_iterator(dir)) files += file.path().extension() == ".media";
+    EXPECT_EQ(files, cache.entryCount());
+}
+
+// Unit Test: Removing an entry deletes its file and keeps the others reachable
+TEST_F(MediaCacheTest, Remove) {
+    MediaCache cache(dir);
+    for (int i = 0; i < 50; ++i) Put(cache, "http://x/" + std::to_string(i), "v");
+    const std::string path = cache.pathFor(MediaCache::keyFor("http://x/7"));
+    cache.remove("http://x/7");
+    EXPECT_FALSE(cache.lookup("http://x/7"));
+    EXPECT_FALSE(fs::exists(path));
+    for (int i = 0; i < 50; ++i) {
+        if (i == 7) continue;
+        EXPECT_TRUE(cache.lookup("http://x/" + std::to_string(i))) << i;
+    }
+}
+
+// Unit Test: The index persists across instances
+TEST_F(MediaCacheTest, Persists) {
+    {
+        MediaCache cache(dir);
+        Put(cache, "http://example.com/a.png", "pixels");
+    }
+    MediaCache reopened(dir);
+    MediaEntry entry;
+    ASSERT_TRUE(reopened.lookup("http://example.com/a.png", &entry));
+    EXPECT_EQ(entry.size, static_cast<uint64_t>(6));
+    EXPECT_EQ(reopened.entryCount(), static_cast<size_t>(1));
+}
+
+// Unit Test: A damaged index is rebuilt and its orphaned files removed
+TEST_F(MediaCacheTest, ResetsDamagedIndex) {
+    std::string path;
+    {
+        MediaCache cache(dir);
+        path = Put(cache, "http://example.com/a.png", "pixels");
+    }
+    std::ofstream(dir + "/index.bin", std::ios::binary | std::ios::trunc) << "garbage";
+    MediaCache reopened(dir);
+    EXPECT_FALSE(reopened.lookup("http://example.com/a.png"));
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_FALSE(Put(reopened, "http://example.com/a.png", "pixels").empty());
+}
+
+// Unit Test: A body in memory is written and indexed by store
+TEST_F(MediaCacheTest, StoreWritesBuffer) {
+    MediaCache cache(dir);
+    MediaBufferPtr buffer = MediaBuffer::fromBytes("pixels", "image/png");
+    const std::string path = cache.store("http://example.com/a.png", *buffer, "", "");
+    ASSERT_FALSE(path.empty());
+    MediaEntry entry;
+    ASSERT_TRUE(cache.lookup("http://example.com/a.png", &entry));
+    EXPECT_EQ(entry.content_type, "image/png");
+    EXPECT_EQ(fs::file_size(path), static_cast<uintmax_t>(6));
+}
+
+// Unit Test: Queued bodies are served from memory until written in the background
+TEST_F(MediaCacheTest, StoreAsync) {
+    MediaCache cache(dir);
+    MediaBufferPtr buffer = MediaBuffer::fromBytes("pixels", "image/png");
+    cache.storeAsync("http://example.com/a.png", buffer, "\"v1\"", "");
+    MediaBufferPtr pending = cache.pending("http://example.com/a.png");
+    EXPECT_TRUE(!pending || pending == buffer); // null once already written
+    cache.flush();
+    EXPECT_FALSE(cache.pending("http://example.com/a.png"));
+    MediaEntry entry;
+    ASSERT_TRUE(cache.lookup("http://example.com/a.png", &entry));
+    EXPECT_EQ(entry.etag, "\"v1\"");
+    EXPECT_EQ(fs::file_size(entry.path), static_cast<uintmax_t>(6));
+}
+
+// Unit Test: Destroying the cache finishes queued writes
+TEST_F(MediaCacheTest, StoreAsyncCompletesOnDestruction) {
+    {
+        MediaCache cache(dir);
+        for (int i = 0; i < 20; ++i) {
+            cache.storeAsync("http://x/" + std::to_string(i), MediaBuffer::fromBytes("v", ""), "", "");
+        }
+    }
+    MediaCache reopened(dir);
+    EXPECT_EQ(reopened.entryCount(), static_cast<size_t>(20));
+}
+
+#if defined(QUICKDOM_TEST_FORK)
+// Unit Test: Processes sharing a directory see each other's entries
+TEST_F(MediaCacheTest, SharedBetweenProcesses) {
+    MediaCache cache(dir);
+    Put(cache, "http://x/parent", "p");
+    pid_t child = fork();
+    if (child == 0) {
+        MediaCache other(dir);
+        bool ok = other.lookup("http://x/parent");
+        for (int i = 0; i < 20; ++i) {
+            ok = ok && !Put(other, "http://x/child" + std::to_string(i), "c").empty();
+        }
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    for (int i = 0; i < 20; ++i) EXPECT_TRUE(cache.lookup("http://x/child" + std::to_string(i))) << i;
+    EXPECT_EQ(cache.entryCount(), static_cast<size_t>(21));
+}
+#endif
\ No newline at end of file
@@ -1,9 +1,26 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "network.h"
+#include "http_cache.h"
+#include "media_cache.h"
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <curl/curl.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define QUICKDOM_TEST_HTTP_SERVER 1
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // clients that hang up early must not kill the test with SIGPIPE
+#endif
+#endif
 
 namespace fs = std::filesystem;
 
@@ -105,4 +122,375 @@ TEST_F(NetworkTest, FetchMedia_NoCacheDirectory) {
     fs::remove_all("cache");
     std::string result = network->fetchMedia("test.jpg", "http://example.com");
     EXPECT_TRUE(result.empty());
+}
+// Unit Test: Streaming fetch delivers the whole body in order
+TEST_F(NetworkTest, Fetch_StreamsChunks) {
+    std::string body;
+    for (int i = 0; i < 20000; ++i) body += "<p>line " + std::to_string(i) + "</p>\n";
+    std::ofstream("cache/page.html", std::ios::binary) << body;
+    std::string received;
+    size_t chunks = 0;
+    bool ok = network->fetch("file://" + fs::absolute("cache/page.html").string(),
+                             [&](const char* data, size_t size) {
+                                 received.append(data, size);
+                                 ++chunks;
+                             });
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(received, body);
+    EXPECT_GT(chunks, static_cast<size_t>(1));
+}
+
+// Unit Test: Streaming fetch with invalid URL reports failure
+TEST_F(NetworkTest, Fetch_StreamHandlesInvalidUrl) {
+    size_t chunks = 0;
+    bool ok = network->fetch("invalid://url", [&](const char*, size_t) { ++chunks; });
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(chunks, static_cast<size_t>(0));
+}
+
+// Writes a file under cache/ and returns its file:// directory URL
+static std::string MakeMediaDir() {
+    fs::create_directories("cache/src");
+    std::ofstream("cache/src/a.png", std::ios::binary) << "aaaa";
+    std::ofstream("cache/src/b.png", std::ios::binary) << "bbbbbb";
+    return "file://" + fs::absolute("cache/src").string() + "/";
+}
+
+// Unit Test: Batch fetch reports every URL once, merging duplicates
+TEST_F(NetworkTest, FetchMediaBatch_ReportsEachUrl) {
+    std::string base = MakeMediaDir();
+    std::vector<std::string> urls = {"a.png", "b.png", "missing.png", "a.png", ""};
+    std::vector<int> calls(urls.size(), 0);
+    std::vector<std::string> paths(urls.size());
+    network->fetchMediaBatch(urls, base, [&](size_t index, const std::string& path) {
+        ++calls[index];
+        paths[index] = path;
+    });
+    EXPECT_EQ(calls, std::vector<int>(urls.size(), 1));
+    EXPECT_FALSE(paths[0].empty());
+    EXPECT_FALSE(paths[1].empty());
+    EXPECT_TRUE(paths[2].empty());
+    EXPECT_EQ(paths[3], paths[0]);
+    EXPECT_TRUE(paths[4].empty());
+    EXPECT_EQ(fs::file_size(paths[1]), static_cast<uintmax_t>(6));
+}
+
+// Unit Test: Batch fetch matches fetchMedia and reuses its cache
+TEST_F(NetworkTest, FetchMediaBatch_SharesCache) {
+    std::string base = MakeMediaDir();
+    std::string single = network->fetchMedia("a.png", base);
+    ASSERT_FALSE(single.empty());
+    fs::remove("cache/src/a.png"); // only the cached copy remains
+    std::vector<std::string> paths = network->fetchMediaBatch({"a.png"}, base);
+    ASSERT_EQ(paths.size(), static_cast<size_t>(1));
+    EXPECT_EQ(paths[0], single);
+}
+
+// Unit Test: Buffer batch hands over bytes, then maps the persisted copy
+TEST_F(NetworkTest, FetchMediaBuffers_DeliversBytes) {
+    std::string base = MakeMediaDir();
+    std::vector<std::string> urls = {"a.png", "missing.png", "b.png"};
+    std::vector<MediaBufferPtr> buffers(urls.size());
+    std::vector<int> calls(urls.size(), 0);
+    auto collect = [&](size_t index, const MediaBufferPtr& buffer) {
+        ++calls[index];
+        buffers[index] = buffer;
+    };
+    network->fetchMediaBuffers(urls, base, collect);
+    EXPECT_EQ(calls, std::vector<int>(urls.size(), 1));
+    ASSERT_TRUE(buffers[0]);
+    EXPECT_EQ(std::string(buffers[0]->data(), buffers[0]->size()), "aaaa");
+    EXPECT_FALSE(buffers[0]->isMapped());
+    EXPECT_FALSE(buffers[1]);
+    ASSERT_TRUE(buffers[2]);
+    EXPECT_EQ(std::string(buffers[2]->data(), buffers[2]->size()), "bbbbbb");
+
+    network->mediaCache().flush();
+    fs::remove("cache/src/a.png"); // only the cached copy remains
+    network->fetchMediaBuffers({"a.png"}, base, collect);
+    ASSERT_TRUE(buffers[0]);
+    EXPECT_TRUE(buffers[0]->isMapped());
+    EXPECT_EQ(std::string(buffers[0]->data(), buffers[0]->size()), "aaaa");
+}
+
+// Unit Test: Empty batch completes without callbacks
+TEST_F(NetworkTest, FetchMediaBatch_Empty) {
+    int calls = 0;
+    network->fetchMediaBatch({}, "http://example.com", [&](size_t, const std::string&) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+#if defined(QUICKDOM_TEST_HTTP_SERVER)
+// Minimal HTTP server on 127.0.0.1 that answers every request after a delay
+// and records how many requests it served at once and how many connections
+// it accepted. With keep_alive it serves many requests per connection.
+// Extra response headers can be set for cache tests; a request carrying
+// If-None-Match is answered with 304 Not Modified.
+class SlowHttpServer {
+public:
+    explicit SlowHttpServer(std::chrono::milliseconds delay, bool keep_alive = false)
+        : delay_(delay), keep_alive_(keep_alive) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        listen(listen_fd_, 64);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~SlowHttpServer() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        thread_.join();
+        // Unblock workers waiting on kept-alive connections.
+        for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+        for (auto& worker : workers_) worker.join();
+        for (int fd : client_fds_) close(fd);
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_) + "/"; }
+    int maxConcurrent() const { return max_concurrent_; }
+    int connections() const { return connections_; }
+    int requests() const { return requests_; }
+    int notModified() const { return not_modified_; }
+
+    void setHeaders(const std::string& headers) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        headers_ = headers;
+    }
+
+private:
+    void serve() {
+        while (true) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) return;
+            ++connections_;
+            client_fds_.push_back(fd);
+            workers_.emplace_back([this, fd] { respond(fd); });
+        }
+    }
+
+    void respond(int fd) {
+        std::string request;
+        char buffer[1024];
+        while (true) {
+            size_t end;
+            while ((end = request.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+                if (n <= 0) {
+                    shutdown(fd, SHUT_RDWR);
+                    return;
+                }
+                request.append(buffer, static_cast<size_t>(n));
+            }
+            const bool conditional = request.substr(0, end).find("If-None-Match:") != std::string::npos;
+            request.erase(0, end + 4);
+            ++requests_;
+            int now = ++concurrent_;
+            int seen = max_concurrent_;
+            while (now > seen && !max_concurrent_.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(delay_);
+            --concurrent_;
+            std::string headers;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                headers = headers_;
+            }
+            if (conditional) ++not_modified_;
+            const std::string response = std::string(conditional ? "HTTP/1.1 304 Not Modified\r\n"
+                                                                 : "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n") +
+                                         headers + "Connection: " + (keep_alive_ ? "keep-alive" : "close") +
+                                         "\r\n\r\n" + (conditional ? "" : "image");
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+            if (!keep_alive_) break;
+        }
+        shutdown(fd, SHUT_RDWR);
+    }
+
+    std::chrono::milliseconds delay_;
+    bool keep_alive_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::thread thread_;
+    std::vector<std::thread> workers_;
+    std::vector<int> client_fds_; // closed by the destructor, not the workers
+    std::atomic<int> concurrent_{0};
+    std::atomic<int> max_concurrent_{0};
+    std::atomic<int> connections_{0};
+    std::atomic<int> requests_{0};
+    std::atomic<int> not_modified_{0};
+    std::mutex mutex_;
+    std::string headers_; // each line ends in \r\n
+};
+
+// Unit Test: Batch fetches overlap up to the per-host limit and no further
+TEST_F(NetworkTest, FetchMediaBatch_PerHostLimit) {
+    SlowHttpServer server(std::chrono::milliseconds(100));
+    std::vector<std::string> urls;
+    for (int i = 0; i < 8; ++i) urls.push_back("img" + std::to_string(i) + ".png");
+    MediaBatchOptions options;
+    options.max_total = 8;
+    options.max_per_host = 3;
+    std::vector<std::string> paths(urls.size());
+    network->fetchMediaBatch(urls, server.url(),
+                             [&](size_t index, const std::string& path) { paths[index] = path; }, options);
+    for (const auto& path : paths) EXPECT_FALSE(path.empty());
+    EXPECT_GT(server.maxConcurrent(), 1);
+    EXPECT_LE(server.maxConcurrent(), 3);
+}
+
+// Unit Test: The total limit caps concurrency across the batch
+TEST_F(NetworkTest, FetchMediaBatch_TotalLimit) {
+    SlowHttpServer server(std::chrono::milliseconds(50));
+    std::vector<std::string> urls;
+    for (int i = 0; i < 6; ++i) urls.push_back("t" + std::to_string(i) + ".png");
+    MediaBatchOptions options;
+    options.max_total = 1;
+    options.max_per_host = 6;
+    size_t done = 0;
+    network->fetchMediaBatch(urls, server.url(),
+                             [&](size_t, const std::string& path) { done += path.empty() ? 0 : 1; }, options);
+    EXPECT_EQ(done, urls.size());
+    EXPECT_EQ(server.maxConcurrent(), 1);
+}
+
+// Unit Test: Sequential requests to one host reuse a pooled connection
+TEST_F(NetworkTest, Fetch_ReusesConnection) {
+    SlowHttpServer server(std::chrono::milliseconds(0), true);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(network->fetch(server.url() + "page" + std::to_string(i)), "image");
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+// Unit Test: Media requests reuse the connection the page was loaded on
+TEST_F(NetworkTest, FetchMedia_ReusesPageConnection) {
+    SlowHttpServer server(std::chrono::milliseconds(0), true);
+    EXPECT_EQ(network->fetch(server.url()), "image");
+    EXPECT_FALSE(network->fetchMedia("logo.png", server.url()).empty());
+    EXPECT_FALSE(network->fetchMedia("icon.png", server.url()).empty());
+    EXPECT_EQ(server.connections(), 1);
+}
+
+// Unit Test: Transfers of one media batch reuse each other's connection
+TEST_F(NetworkTest, FetchMediaBatch_ReusesConnection) {
+    SlowHttpServer server(std::chrono::milliseconds(0), true);
+    std::vector<std::string> urls = {"logo.png", "icon.png", "photo.png"};
+    MediaBatchOptions options;
+    options.max_total = 1;
+    size_t done = 0;
+    network->fetchMediaBatch(urls, server.url(),
+                             [&](size_t, const std::string& path) { done += path.empty() ? 0 : 1; }, options);
+    EXPECT_EQ(done, urls.size());
+    EXPECT_EQ(server.connections(), 1);
+}
+
+// Unit Test: A fresh cached document is served without a request
+TEST_F(NetworkTest, Fetch_ServesFreshFromCache) {
+    SlowHttpServer server(std::chrono::milliseconds(0));
+    server.setHeaders("Cache-Control: max-age=300\r\n");
+    EXPECT_EQ(network->fetch(server.url() + "doc"), "image");
+    EXPECT_EQ(network->fetch(server.url() + "doc#section"), "image");
+    EXPECT_EQ(server.requests(), 1);
+    EXPECT_EQ(network->documentCache().entryCount(), static_cast<size_t>(1));
+}
+
+// Unit Test: A stale cached document is revalidated and replayed on 304
+TEST_F(NetworkTest, Fetch_RevalidatesStale) {
+    SlowHttpServer server(std::chrono::milliseconds(0));
+    server.setHeaders("Cache-Control: no-cache\r\nETag: \"v1\"\r\n");
+    EXPECT_EQ(network->fetch(server.url() + "doc"), "image");
+    std::string replayed;
+    EXPECT_TRUE(network->fetch(server.url() + "doc", [&](const char* data, size_t size) {
+        replayed.append(data, size);
+    }));
+    EXPECT_EQ(replayed, "image");
+    EXPECT_EQ(server.requests(), 2);
+    EXPECT_EQ(server.notModified(), 1);
+}
+
+// Unit Test: A transfer past its deadline is aborted
+TEST_F(NetworkTest, Fetch_AbortsAtDeadline) {
+    SlowHttpServer server(std::chrono::milliseconds(1500));
+    TransferControl control;
+    control.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(network->fetch(server.url() + "doc", [](const char*, size_t) {}, &control));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    EXPECT_EQ(network->documentCache().entryCount(), static_cast<size_t>(0));
+}
+
+// Unit Test: Cancelling from another thread aborts a transfer in flight
+TEST_F(NetworkTest, Fetch_CancelledFromAnotherThread) {
+    SlowHttpServer server(std::chrono::milliseconds(3000));
+    TransferControl control;
+    std::thread canceller([&control] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        control.cancel();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(network->fetch(server.url() + "doc", [](const char*, size_t) {}, &control));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2500));
+    canceller.join();
+}
+
+// Unit Test: A cancelled batch reports every URL as failed without requests
+TEST_F(NetworkTest, FetchMediaBuffers_CancelledBatch) {
+    SlowHttpServer server(std::chrono::milliseconds(0));
+    TransferControl control;
+    control.cancel();
+    MediaBatchOptions options;
+    options.control = &control;
+    size_t failed = 0;
+    network->fetchMediaBuffers({"a.png", "b.png", "c.png"}, server.url(),
+                               [&](size_t, const MediaBufferPtr& buffer) { failed += buffer ? 0 : 1; }, options);
+    EXPECT_EQ(failed, static_cast<size_t>(3));
+    EXPECT_EQ(server.requests(), 0);
+}
+
+// Unit Test: no-store documents are fetched every time
+TEST_F(NetworkTest, Fetch_NoStoreBypassesCache) {
+    SlowHttpServer server(std::chrono::milliseconds(0));
+    server.setHeaders("Cache-Control: no-store\r\nETag: \"v1\"\r\n");
+    EXPECT_EQ(network->fetch(server.url() + "doc"), "image");
+    EXPECT_EQ(network->fetch(server.url() + "doc"), "image");
+    EXPECT_EQ(server.requests(), 2);
+    EXPECT_EQ(server.notModified(), 0);
+}
+#endif
+
+// Unit Test: Finished requests return their handle to the pool
+TEST_F(NetworkTest, Pool_ReturnsHandles) {
+    EXPECT_EQ(network->idleHandleCount(), static_cast<size_t>(0));
+    network->fetch("invalid://url");
+    EXPECT_EQ(network->idleHandleCount(), static_cast<size_t>(1));
+    network->fetch("invalid://url");
+    EXPECT_EQ(network->idleHandleCount(), static_cast<size_t>(1));
+    std::string base = MakeMediaDir();
+    network->fetchMediaBatch({"a.png", "b.png"}, base);
+    EXPECT_EQ(network->idleHandleCount(), static_cast<size_t>(2));
+}
+
+// Unit Test: Concurrent callers share one Network safely
+TEST_F(NetworkTest, Pool_ConcurrentCallers) {
+    std::string base = MakeMediaDir();
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10; ++i) {
+                std::string body = network->fetch(base + (t % 2 ? "a.png" : "b.png"));
+                if (body != (t % 2 ? "aaaa" : "bbbbbb")) ++failures;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(failures, 0);
+    EXPECT_LE(network->idleHandleCount(), static_cast<size_t>(8));
 }
\ No newline at end of file
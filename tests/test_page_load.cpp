@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QThreadPool>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include "page_load.h"
+#include "parser_factory.h"
+#include "timeline.h"
+
+namespace fs = std::filesystem;
+
+// Test fixture for PageLoad tests; results are delivered through the event loop
+class PageLoadTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        int argc = 0;
+        char* argv[] = {nullptr};
+        app = new QApplication(argc, argv);
+    }
+
+    static void TearDownTestSuite() {
+        delete app;
+    }
+
+    void SetUp() override {
+        fs::create_directory("cache");
+        std::ofstream("page_load_test.html") << "<h1>Title</h1><p>Body</p>";
+        url = "file://" + fs::absolute("page_load_test.html").string();
+        parser = createParser(ParserKind::Auto);
+        network = std::make_unique<Network>();
+    }
+
+    void TearDown() override {
+        pool.waitForDone();
+        fs::remove("page_load_test.html");
+        fs::remove_all("cache");
+    }
+
+    // Runs the event loop until the load finishes or a few seconds pass.
+    static bool waitFor(PageLoad& load) {
+        bool finished = false;
+        QObject::connect(&load, &PageLoad::finished, [&finished]() { finished = true; });
+        const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!finished && std::chrono::steady_clock::now() < give_up) {
+            QCoreApplication::processEvents();
+        }
+        return finished;
+    }
+
+    static QApplication* app;
+    QThreadPool pool;
+    std::unique_ptr<Network> network;
+    std::unique_ptr<HtmlParser> parser;
+    std::string url;
+};
+
+QApplication* PageLoadTest::app = nullptr;
+
+// Unit Test: A load fetches and parses the page on a worker thread
+TEST_F(PageLoadTest, LoadsDocument) {
+    PageLoad load(*network, *parser, url);
+    load.start(&pool);
+    ASSERT_TRUE(waitFor(load));
+    PageLoadResult result = load.takeResult();
+    EXPECT_TRUE(result.complete);
+    EXPECT_EQ(result.url, url);
+    EXPECT_GT(result.document.nodeCount(), static_cast<size_t>(2));
+}
+
+// Unit Test: A cancelled load never reports
+TEST_F(PageLoadTest, CancelledLoadNeverFinishes) {
+    PageLoad load(*network, *parser, url);
+    load.start(&pool);
+    load.cancel();
+    EXPECT_TRUE(load.isCancelled());
+    pool.waitForDone();
+    bool finished = false;
+    QObject::connect(&load, &PageLoad::finished, [&finished]() { finished = true; });
+    QCoreApplication::processEvents();
+    EXPECT_FALSE(finished);
+}
+
+// Unit Test: Destroying a load, e.g. with its tab, drops its result
+TEST_F(PageLoadTest, DestroyedLoadIsDropped) {
+    auto owner = std::make_unique<QObject>();
+    auto* load = new PageLoad(*network, *parser, url, PageLoad::kDefaultTimeout, owner.get());
+    load->start(&pool);
+    owner.reset();
+    pool.waitForDone();
+    QCoreApplication::processEvents(); // must not touch the deleted load
+    SUCCEED();
+}
+
+// Unit Test: Past its deadline a load finishes incomplete
+TEST_F(PageLoadTest, DeadlineMarksIncomplete) {
+    PageLoad load(*network, *parser, url, std::chrono::milliseconds(0));
+    load.start(&pool);
+    ASSERT_TRUE(waitFor(load));
+    EXPECT_FALSE(load.takeResult().complete);
+}
+
+// Unit Test: Several loads run in parallel and each finishes
+TEST_F(PageLoadTest, ParallelLoads) {
+    std::vector<std::unique_ptr<PageLoad>> loads;
+    int finished = 0;
+    for (int i = 0; i < 4; ++i) {
+        loads.push_back(std::make_unique<PageLoad>(*network, *parser, url));
+        QObject::connect(loads.back().get(), &PageLoad::finished, [&finished]() { ++finished; });
+        loads.back()->start(&pool);
+    }
+    const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (finished < 4 && std::chrono::steady_clock::now() < give_up) {
+        QCoreApplication::processEvents();
+    }
+    EXPECT_EQ(finished, 4);
+}
+
+// Unit Test: Only images marked loading="eager" come with the page
+TEST_F(PageLoadTest, FetchesEagerImagesOnly) {
+    const std::string svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"4\" height=\"4\"/>";
+    std::ofstream("eager_image.svg") << svg;
+    std::ofstream("lazy_image.svg") << svg;
+    std::ofstream("page_load_test.html") << "<img src=\"eager_image.svg\" loading=\"eager\">"
+                                            "<div><img src=\"lazy_image.svg\"></div>";
+    for (bool lazy : {true, false}) {
+        PageLoad load(*network, *parser, url);
+        load.setLazyImages(lazy);
+        load.start(&pool);
+        ASSERT_TRUE(waitFor(load));
+        PageLoadResult result = load.takeResult();
+        EXPECT_EQ(result.media.count("eager_image.svg"), static_cast<size_t>(1));
+        EXPECT_EQ(result.media.count("lazy_image.svg"), static_cast<size_t>(lazy ? 0 : 1));
+    }
+    fs::remove("eager_image.svg");
+    fs::remove("lazy_image.svg");
+}
+
+// Unit Test: With the timeline on, a load records its phases tagged with its tab
+TEST_F(PageLoadTest, RecordsTimelineSpans) {
+    clearTimeline();
+    setTimelineEnabled(true);
+    PageLoad load(*network, *parser, url);
+    load.setTimelineTab(5);
+    load.start(&pool);
+    ASSERT_TRUE(waitFor(load));
+    setTimelineEnabled(false);
+    const std::string json = timelineJson();
+    for (const char* phase : {"fetch", "parse", "media"}) {
+        EXPECT_NE(json.find(std::string("{\"name\":\"") + phase + "\",\"cat\":\"load\""), std::string::npos) << phase;
+    }
+    EXPECT_NE(json.find("\"args\":{\"tab\":5,\"url\":\"file://"), std::string::npos) << json;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "parser_factory.h"
+#include "cpu_features.h"
+#include <cstdlib>
+
+// Test fixture for parser factory tests
+class ParserFactoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        unsetenv("QUICKDOM_PARSER");
+    }
+
+    void TearDown() override {
+        unsetenv("QUICKDOM_PARSER");
+    }
+
+    static std::string sample() {
+        return "<h1>Title</h1><p class=\"intro\">Hello</p><img src=\"a.png\"><a href=\"/next\">Next</a>";
+    }
+};
+
+// Unit Test: Parse known parser names
+TEST_F(ParserFactoryTest, KindFromName) {
+    ParserKind kind = ParserKind::Auto;
+    ASSERT_TRUE(parserKindFromName("scalar", kind));
+    EXPECT_EQ(kind, ParserKind::Scalar);
+    ASSERT_TRUE(parserKindFromName("AVX2", kind));
+    EXPECT_EQ(kind, ParserKind::Avx2);
+    ASSERT_TRUE(parserKindFromName("neon", kind));
+    EXPECT_EQ(kind, ParserKind::Neon);
+}
+
+// Unit Test: Reject unknown parser names
+TEST_F(ParserFactoryTest, KindFromUnknownName) {
+    ParserKind kind = ParserKind::Scalar;
+    EXPECT_FALSE(parserKindFromName("mmx", kind));
+    EXPECT_EQ(kind, ParserKind::Scalar);
+}
+
+// Unit Test: Names round-trip
+TEST_F(ParserFactoryTest, NameRoundTrip) {
+    for (ParserKind kind : {ParserKind::Auto, ParserKind::Scalar, ParserKind::Sse2,
+                            ParserKind::Avx2, ParserKind::Avx512, ParserKind::Neon}) {
+        ParserKind parsed = ParserKind::Auto;
+        ASSERT_TRUE(parserKindFromName(parserKindName(kind), parsed));
+        EXPECT_EQ(parsed, kind);
+    }
+}
+
+// Unit Test: Best kind is always supported
+TEST_F(ParserFactoryTest, BestKindSupported) {
+    ParserKind best = bestParserKind();
+    EXPECT_NE(best, ParserKind::Auto);
+    EXPECT_TRUE(parserKindSupported(best));
+}
+
+// Unit Test: Detected features are consistent
+TEST_F(ParserFactoryTest, FeatureHierarchy) {
+    const CpuFeatures& cpu = cpuFeatures();
+    if (cpu.avx512bw) {
+        EXPECT_TRUE(cpu.avx2);
+    }
+    if (cpu.avx2) {
+        EXPECT_TRUE(cpu.sse2);
+    }
+    EXPECT_FALSE(cpu.sse2 && cpu.neon);
+}
+
+// Unit Test: Environment variable overrides Auto
+TEST_F(ParserFactoryTest, EnvironmentOverride) {
+    setenv("QUICKDOM_PARSER", "scalar", 1);
+    EXPECT_EQ(resolveParserKind(ParserKind::Auto), ParserKind::Scalar);
+}
+
+// Unit Test: Explicit kind wins over the environment
+TEST_F(ParserFactoryTest, ExplicitKindIgnoresEnvironment) {
+    setenv("QUICKDOM_PARSER", "avx512", 1);
+    EXPECT_EQ(resolveParserKind(ParserKind::Scalar), ParserKind::Scalar);
+}
+
+// Unit Test: Unknown environment value falls back to detection
+TEST_F(ParserFactoryTest, UnknownEnvironmentValue) {
+    setenv("QUICKDOM_PARSER", "bogus", 1);
+    EXPECT_EQ(resolveParserKind(ParserKind::Auto), bestParserKind());
+}
+
+// Unit Test: Unsupported kinds fall back to a supported one
+TEST_F(ParserFactoryTest, UnsupportedKindFallsBack) {
+    for (ParserKind kind : {ParserKind::Sse2, ParserKind::Avx2, ParserKind::Avx512, ParserKind::Neon}) {
+        ParserKind resolved = resolveParserKind(kind);
+        EXPECT_TRUE(parserKindSupported(resolved));
+        if (parserKindSupported(kind)) {
+            EXPECT_EQ(resolved, kind);
+        }
+    }
+}
+
+// Unit Test: Every kind produces the scalar tree
+TEST_F(ParserFactoryTest, AllKindsAgree) {
+    Node expected = createParser(ParserKind::Scalar)->parse(sample());
+    for (ParserKind kind : {ParserKind::Auto, ParserKind::Sse2, ParserKind::Avx2,
+                            ParserKind::Avx512, ParserKind::Neon}) {
+        SCOPED_TRACE(parserKindName(kind));
+        auto parser = createParser(kind);
+        ASSERT_NE(parser, nullptr);
+        Node actual = parser->parse(sample());
+        ASSERT_EQ(actual.children.size(), expected.children.size());
+        for (size_t i = 0; i < expected.children.size(); ++i) {
+            EXPECT_EQ(actual.children[i].type, expected.children[i].type);
+            EXPECT_EQ(actual.children[i].text, expected.children[i].text);
+            EXPECT_EQ(actual.children[i].attributes, expected.children[i].attributes);
+        }
+    }
+}
\ No newline at end of file
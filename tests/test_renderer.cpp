@@ -3,7 +3,13 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QSignalSpy>
+#include <QtTest>
 #include "renderer.h"
+#include "link_label.h"
+#include "image_cache.h"
+#include <QThreadPool>
+#include <fstream>
 
 // Test fixture for Renderer tests
 class RendererTest : public ::testing::Test {
@@ -15,6 +21,7 @@ protected:
     }
 
     static void TearDownTestSuite() {
+        ImageCache::instance().clear();
         delete app;
     }
 
@@ -148,4 +155,68 @@ TEST_F(RendererTest, Render_ManyChildren) {
     }
     renderer->render(root, layout);
     EXPECT_EQ(layout->count(), 6); // 5 параграфов + div
+}
+
+// Unit Test: Render a parsed document
+TEST_F(RendererTest, Render_Document) {
+    Document document = SimdParser().parseDocument("<h1>Title</h1><p>Body</p><a href=\"/x\">Link</a><img>");
+    renderer->render(document, layout);
+    EXPECT_EQ(layout->count(), 3); // header, paragraph, link; img without src is skipped
+}
+
+// Unit Test: Links are rendered as LinkLabels that report clicks
+TEST_F(RendererTest, Render_LinkLabel) {
+    renderer->render(SimdParser().parseDocument("<a href=\"http://example.com/\">Example</a>"), layout);
+    ASSERT_EQ(layout->count(), 1);
+    auto* link = qobject_cast<LinkLabel*>(layout->itemAt(0)->widget());
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(link->property("href").toString(), QString("http://example.com/"));
+    QSignalSpy spy(link, &LinkLabel::clicked);
+    QTest::mouseClick(link, Qt::LeftButton);
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.at(0).at(0).value<QLabel*>(), link);
+}
+
+// Unit Test: Rendering an image again reuses the decoded pixmap
+TEST_F(RendererTest, Render_ReusesDecodedImage) {
+    std::ofstream("shared_logo.svg") << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                                        "<rect width=\"10\" height=\"10\"/></svg>";
+    Node node;
+    node.type = "img";
+    node.attributes["src"] = "shared_logo.svg";
+    node.attributes["width"] = "20";
+    node.attributes["height"] = "20";
+    const ImageCacheStats before = ImageCache::instance().stats();
+    renderer->render(node, layout);
+    renderer->render(node, layout);
+    const ImageCacheStats after = ImageCache::instance().stats();
+    EXPECT_EQ(layout->count(), 2);
+    EXPECT_EQ(after.misses - before.misses, 1u);
+    EXPECT_EQ(after.hits - before.hits, 1u);
+    auto* first = qobject_cast<QLabel*>(layout->itemAt(0)->widget());
+    auto* second = qobject_cast<QLabel*>(layout->itemAt(1)->widget());
+    ASSERT_TRUE(first && second && first->pixmap() && second->pixmap());
+    EXPECT_EQ(first->pixmap()->cacheKey(), second->pixmap()->cacheKey()); // same shared pixels
+    std::remove("shared_logo.svg");
+}
+
+// Unit Test: With a decode group, an image first shows a placeholder of its final size
+TEST_F(RendererTest, Render_DecodesImageOffThread) {
+    std::ofstream("async_logo.svg") << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                                       "<rect width=\"10\" height=\"10\"/></svg>";
+    Document document = SimdParser().parseDocument("<img src=\"async_logo.svg\" width=\"24\" height=\"12\">");
+    ImageCache::instance().clear();
+    auto decodes = std::make_shared<DecodeGroup>();
+    renderer->render(document, layout, nullptr, decodes);
+    ASSERT_EQ(layout->count(), 1);
+    auto* label = qobject_cast<QLabel*>(layout->itemAt(0)->widget());
+    ASSERT_TRUE(label);
+    EXPECT_EQ(label->size(), QSize(24, 12));
+
+    QThreadPool::globalInstance()->waitForDone();
+    QCoreApplication::processEvents();
+    ASSERT_TRUE(label->pixmap() && !label->pixmap()->isNull());
+    EXPECT_EQ(label->pixmap()->size(), QSize(24, 12));
+    EXPECT_EQ(ImageCache::instance().stats().entries, static_cast<size_t>(1));
+    std::remove("async_logo.svg");
 }
\ No newline at end of file
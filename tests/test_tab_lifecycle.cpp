@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "tab_lifecycle.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// Test fixture for tab lifecycle tests; a fake /proc and /sys live under root
+class TabLifecycleTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        fs::remove_all(root);
+    }
+
+    void write(const std::string& path, const std::string& text) {
+        fs::create_directories(fs::path(root + path).parent_path());
+        std::ofstream(root + path) << text;
+    }
+
+    static TabLifecycle lifecycle(size_t budget, size_t min_live_tabs = 1) {
+        TabLifecycleOptions options;
+        options.budget_bytes = budget;
+        options.min_live_tabs = min_live_tabs;
+        return TabLifecycle(options);
+    }
+
+    std::string root = fs::absolute("lifecycle_test").string();
+};
+
+// Unit Test: Pressure stall averages are parsed from both lines
+TEST_F(TabLifecycleTest, ParsesPressure) {
+    double some = 0, full = 0;
+    ASSERT_TRUE(MemoryMonitor::parsePressure("some avg10=12.50 avg60=3.00 avg300=1.00 total=99\n"
+                                             "full avg10=4.25 avg60=1.00 avg300=0.00 total=10\n",
+                                             &some, &full));
+    EXPECT_DOUBLE_EQ(some, 12.5);
+    EXPECT_DOUBLE_EQ(full, 4.25);
+    EXPECT_FALSE(MemoryMonitor::parsePressure("garbage", &some, &full));
+}
+
+// Unit Test: cgroup v2 limits are read from the process's cgroup
+TEST_F(TabLifecycleTest, ReadsCgroupV2) {
+    write("/proc/pressure/memory", "some avg10=20.00 avg60=0.00 avg300=0.00 total=0\n");
+    write("/proc/self/cgroup", "0::/app.slice/browser\n");
+    write("/sys/fs/cgroup/app.slice/browser/memory.max", "1048576\n");
+    write("/sys/fs/cgroup/app.slice/browser/memory.current", "524288\n");
+    MemoryStatus status = MemoryMonitor(root).sample();
+    EXPECT_DOUBLE_EQ(status.pressure_some, 20.0);
+    EXPECT_EQ(status.cgroup_limit, static_cast<size_t>(1048576));
+    EXPECT_EQ(status.cgroup_usage, static_cast<size_t>(524288));
+}
+
+// Unit Test: cgroup v1 is read, and "unlimited" values mean no limit
+TEST_F(TabLifecycleTest, ReadsCgroupV1) {
+    write("/proc/self/cgroup", "4:memory:/docker/abc\n0::/\n");
+    write("/sys/fs/cgroup/memory/memory.limit_in_bytes", "9223372036854771712\n");
+    write("/sys/fs/cgroup/memory/memory.usage_in_bytes", "4096\n");
+    MemoryStatus status = MemoryMonitor(root).sample();
+    EXPECT_EQ(status.cgroup_limit, static_cast<size_t>(0));
+    EXPECT_EQ(status.cgroup_usage, static_cast<size_t>(4096));
+}
+
+// Unit Test: Without the files nothing is reported
+TEST_F(TabLifecycleTest, MissingFilesReportNothing) {
+    MemoryStatus status = MemoryMonitor(root).sample();
+    EXPECT_EQ(status.pressure_some, 0.0);
+    EXPECT_EQ(status.cgroup_limit, static_cast<size_t>(0));
+}
+
+// Unit Test: Within budget and without pressure every tab stays live
+TEST_F(TabLifecycleTest, KeepsTabsWithinBudget) {
+    TabLifecycle tabs = lifecycle(300);
+    for (uint64_t tab = 0; tab < 3; ++tab) {
+        tabs.touch(tab);
+        tabs.setFootprint(tab, 100);
+    }
+    EXPECT_TRUE(tabs.selectVictims(MemoryStatus()).empty());
+}
+
+// Unit Test: Over budget the least recently used tabs go first
+TEST_F(TabLifecycleTest, HibernatesLeastRecentlyUsed) {
+    TabLifecycle tabs = lifecycle(250);
+    for (uint64_t tab = 0; tab < 4; ++tab) {
+        tabs.touch(tab);
+        tabs.setFootprint(tab, 100);
+    }
+    tabs.touch(0); // the user went back to the first tab
+    EXPECT_EQ(tabs.selectVictims(MemoryStatus()), (std::vector<uint64_t>{1, 2}));
+    tabs.hibernated(1);
+    tabs.hibernated(2);
+    EXPECT_EQ(tabs.liveBytes(), static_cast<size_t>(200));
+    EXPECT_TRUE(tabs.selectVictims(MemoryStatus()).empty());
+}
+
+// Unit Test: The most recently used tabs are never hibernated
+TEST_F(TabLifecycleTest, KeepsMostRecentTabs) {
+    TabLifecycle tabs = lifecycle(0, 2);
+    for (uint64_t tab = 0; tab < 3; ++tab) {
+        tabs.touch(tab);
+        tabs.setFootprint(tab, 100);
+    }
+    EXPECT_EQ(tabs.selectVictims(MemoryStatus()), (std::vector<uint64_t>{0}));
+}
+
+// Unit Test: System pressure releases one tab per check
+TEST_F(TabLifecycleTest, PressureReleasesOneTab) {
+    TabLifecycle tabs = lifecycle(1000);
+    for (uint64_t tab = 0; tab < 3; ++tab) {
+        tabs.touch(tab);
+        tabs.setFootprint(tab, 100);
+    }
+    MemoryStatus status;
+    status.pressure_some = 50.0;
+    EXPECT_EQ(tabs.selectVictims(status), (std::vector<uint64_t>{0}));
+}
+
+// Unit Test: Nearing the cgroup limit frees enough to get back under it
+TEST_F(TabLifecycleTest, CgroupHighWater) {
+    TabLifecycle tabs = lifecycle(1000);
+    for (uint64_t tab = 0; tab < 4; ++tab) {
+        tabs.touch(tab);
+        tabs.setFootprint(tab, 100);
+    }
+    MemoryStatus status;
+    status.cgroup_limit = 1000;
+    status.cgroup_usage = 1050; // 150 over the 90% mark
+    EXPECT_EQ(tabs.selectVictims(status), (std::vector<uint64_t>{0, 1}));
+}
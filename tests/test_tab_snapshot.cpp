@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "tab_snapshot.h"
+#include "html_parser.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// Flattens a document in document order, for comparing two documents.
+static std::string Describe(const Document& document) {
+    std::string out;
+    std::vector<std::pair<NodeId, int>> stack{{document.root(), 0}};
+    while (!stack.empty()) {
+        auto [id, depth] = stack.back();
+        stack.pop_back();
+        out += std::to_string(depth) + ":" + std::to_string(static_cast<int>(document.node(id).tag)) + ":" +
+               std::string(document.text(id));
+        for (size_t a = 0; a < document.attributeCount(id); ++a) {
+            out += " " + std::string(document.attributeName(id, a)) + "=" + std::string(document.attributeValue(id, a));
+        }
+        out += "\n";
+        std::vector<NodeId> children;
+        for (NodeId child = document.node(id).first_child; child != kNoNode; child = document.node(child).next_sibling) {
+            children.push_back(child);
+        }
+        for (auto it = children.rbegin(); it != children.rend(); ++it) stack.push_back({*it, depth + 1});
+    }
+    return out;
+}
+
+// Test fixture for tab snapshot tests
+class TabSnapshotTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        fs::remove_all("snapshot_test");
+    }
+
+    static TabSnapshot snapshotOf(const std::string& html) {
+        TabSnapshot snapshot;
+        snapshot.url = "http://example.com/";
+        snapshot.document = SimdParser().parseDocument(html);
+        snapshot.media.push_back({"logo.png", "http://example.com/logo.png"});
+        snapshot.scroll_x = 3;
+        snapshot.scroll_y = 420;
+        return snapshot;
+    }
+
+    static TabSnapshot roundTrip(const TabSnapshot& snapshot, bool compress) {
+        TabSnapshot restored;
+        EXPECT_TRUE(decodeSnapshot(encodeSnapshot(snapshot, compress), &restored));
+        return restored;
+    }
+};
+
+// Unit Test: The rebuilt document matches the original node for node
+TEST_F(TabSnapshotTest, RoundTripsDocument) {
+    const std::string html = "<h1>Title</h1><p>Body <span>inner</span></p>"
+                             "<a href=\"/x\">Link</a><img src=\"logo.png\" width=\"10\">";
+    for (bool compress : {false, true}) {
+        TabSnapshot snapshot = snapshotOf(html);
+        TabSnapshot restored = roundTrip(snapshot, compress);
+        EXPECT_EQ(restored.url, snapshot.url);
+        EXPECT_EQ(restored.scroll_x, 3);
+        EXPECT_EQ(restored.scroll_y, 420);
+        ASSERT_EQ(restored.media.size(), static_cast<size_t>(1));
+        EXPECT_EQ(restored.media[0].src, "logo.png");
+        EXPECT_EQ(restored.media[0].url, "http://example.com/logo.png");
+        EXPECT_EQ(restored.document.nodeCount(), snapshot.document.nodeCount());
+        EXPECT_EQ(Describe(restored.document), Describe(snapshot.document));
+    }
+}
+
+// Unit Test: Repeated strings are stored once and unused source is dropped
+TEST_F(TabSnapshotTest, SmallerThanSource) {
+    std::string html = "<!-- a long comment that no node keeps -->";
+    for (int i = 0; i < 200; ++i) html += "<a href=\"/same\">Same link</a>";
+    TabSnapshot snapshot = snapshotOf(html);
+    const std::string plain = encodeSnapshot(snapshot, false);
+    const std::string packed = encodeSnapshot(snapshot, true);
+    EXPECT_LT(plain.size(), html.size() / 2);
+    EXPECT_LT(packed.size(), plain.size());
+}
+
+// Unit Test: Deeply nested documents do not exhaust the stack
+TEST_F(TabSnapshotTest, DeepNesting) {
+    Document document;
+    NodeId parent = document.root();
+    for (int i = 0; i < 100000; ++i) parent = document.appendChild(parent, TagAtom::Div);
+    TabSnapshot snapshot;
+    snapshot.document = std::move(document);
+    TabSnapshot restored = roundTrip(snapshot, true);
+    EXPECT_EQ(restored.document.nodeCount(), static_cast<size_t>(100001));
+}
+
+// Unit Test: Truncated or corrupt bytes are rejected
+TEST_F(TabSnapshotTest, RejectsCorruptBytes) {
+    const std::string bytes = encodeSnapshot(snapshotOf("<p>One</p><p>Two</p>"), false);
+    TabSnapshot restored;
+    EXPECT_FALSE(decodeSnapshot("", &restored));
+    EXPECT_FALSE(decodeSnapshot("QDSN", &restored));
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        EXPECT_FALSE(decodeSnapshot(std::string_view(bytes).substr(0, size), &restored));
+    }
+    std::string wrong_version = bytes;
+    wrong_version[4] = 9;
+    EXPECT_FALSE(decodeSnapshot(wrong_version, &restored));
+    EXPECT_FALSE(decodeSnapshot(bytes + "x", &restored));
+}
+
+// Unit Test: Snapshots are taken once and then gone
+TEST_F(TabSnapshotTest, StoreTakesOnce) {
+    SnapshotStore store("snapshot_test");
+    store.put(1, "first");
+    store.put(1, "second");
+    EXPECT_TRUE(store.contains(1));
+    EXPECT_EQ(store.memoryBytes(), static_cast<size_t>(6));
+    std::string bytes;
+    ASSERT_TRUE(store.take(1, &bytes));
+    EXPECT_EQ(bytes, "second");
+    EXPECT_FALSE(store.contains(1));
+    EXPECT_FALSE(store.take(1, &bytes));
+    EXPECT_EQ(store.memoryBytes(), static_cast<size_t>(0));
+}
+
+// Unit Test: Past the memory budget the oldest snapshots go to disk
+TEST_F(TabSnapshotTest, StoreSpillsOldest) {
+    {
+        SnapshotStore store("snapshot_test", 10);
+        store.put(1, std::string(8, 'a'));
+        store.put(2, std::string(8, 'b'));
+        EXPECT_EQ(store.spilledCount(), static_cast<size_t>(1));
+        EXPECT_EQ(store.memoryBytes(), static_cast<size_t>(8));
+        EXPECT_TRUE(fs::exists("snapshot_test/tab_1.snap"));
+        std::string bytes;
+        ASSERT_TRUE(store.take(1, &bytes));
+        EXPECT_EQ(bytes, std::string(8, 'a'));
+        EXPECT_FALSE(fs::exists("snapshot_test/tab_1.snap"));
+        store.put(3, std::string(8, 'c'));
+        EXPECT_TRUE(fs::exists("snapshot_test/tab_2.snap"));
+    }
+    EXPECT_FALSE(fs::exists("snapshot_test/tab_2.snap")); // removed with the store
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "tag_atoms.h"
+
+// Lookups are constexpr, so the table can be checked at compile time too.
+static_assert(lookupTag("div") == TagAtom::Div, "div must resolve at compile time");
+static_assert(lookupTag("bogus") == TagAtom::Unknown, "unknown names must miss");
+
+// Unit Test: Every tag in the vocabulary maps back to itself
+TEST(TagAtomsTest, AllTagsRoundTrip) {
+    for (size_t i = 1; i < static_cast<size_t>(TagAtom::Root); ++i) {
+        const TagAtom atom = static_cast<TagAtom>(i);
+        EXPECT_EQ(lookupTag(tagName(atom)), atom) << tagName(atom);
+    }
+}
+
+// Unit Test: Lookup is ASCII case-insensitive
+TEST(TagAtomsTest, CaseInsensitive) {
+    EXPECT_EQ(lookupTag("IMG"), TagAtom::Img);
+    EXPECT_EQ(lookupTag("Img"), TagAtom::Img);
+    EXPECT_EQ(lookupTag("H1"), TagAtom::H1);
+    EXPECT_EQ(lookupTag("BlockQuote"), TagAtom::Blockquote);
+}
+
+// Unit Test: Names outside the vocabulary are Unknown
+TEST(TagAtomsTest, UnknownNames) {
+    EXPECT_EQ(lookupTag(""), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("x"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("image"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("h7"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("custom-element"), TagAtom::Unknown);
+}
+
+// Unit Test: Near misses of real tags do not match
+TEST(TagAtomsTest, NearMisses) {
+    EXPECT_EQ(lookupTag("di"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("divv"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("spam"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("blockquotes"), TagAtom::Unknown);
+}
+
+// Unit Test: Pseudo atoms are not reachable from markup
+TEST(TagAtomsTest, PseudoAtomsNotMatched) {
+    EXPECT_EQ(lookupTag("#root"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("#text"), TagAtom::Unknown);
+    EXPECT_EQ(tagName(TagAtom::Unknown), "");
+}
+
+// Unit Test: Names with bytes that fold onto letters do not alias
+TEST(TagAtomsTest, FoldingDoesNotAlias) {
+    // '@' | 0x20 == '`' and 'A' | 0x20 == 'a'; only the latter is a letter.
+    EXPECT_EQ(lookupTag("@"), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag(std::string("a\0", 2)), TagAtom::Unknown);
+    EXPECT_EQ(lookupTag("A"), TagAtom::A);
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "text_normalizer.h"
+#include "html_parser.h"
+#include <random>
+
+// Unit Test: Normal runs are left alone and nothing is written
+TEST(TextNormalizerTest, NormalTextIsNotCopied) {
+    std::string out = "kept";
+    EXPECT_TRUE(normalizeText("Hello, World!", &out));
+    EXPECT_TRUE(normalizeText("caf\xC3\xA9 \xE2\x82\xAC 5 & 6 &unknown; &", &out));
+    EXPECT_TRUE(normalizeText("", &out));
+    EXPECT_EQ(out, "kept");
+}
+
+// Unit Test: Named and numeric references are decoded
+TEST(TextNormalizerTest, DecodesReferences) {
+    EXPECT_EQ(normalizedText("a &amp; b &lt;p&gt; &quot;q&quot;"), "a & b <p> \"q\"");
+    EXPECT_EQ(normalizedText("caf&eacute; &copy; &euro;&hellip;"), "caf\xC3\xA9 \xC2\xA9 \xE2\x82\xAC\xE2\x80\xA6");
+    EXPECT_EQ(normalizedText("&#65;&#x42;&#X43;&#100"), "ABCd");
+    EXPECT_EQ(normalizedText("&#x1F600;"), "\xF0\x9F\x98\x80");
+    EXPECT_EQ(normalizedText("&#150;"), "\xE2\x80\x93"); // Windows-1252 en dash
+    EXPECT_EQ(normalizedText("&#0;&#xD800;&#99999999;"), "\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD");
+    EXPECT_EQ(normalizedText("&amp &#; &#x; &nosuch; &amp;amp;"), "&amp &#; &#x; &nosuch; &amp;");
+}
+
+// Unit Test: Whitespace runs collapse to one space and the ends are trimmed
+TEST(TextNormalizerTest, CollapsesWhitespace) {
+    EXPECT_EQ(normalizedText("  Text  "), "Text");
+    EXPECT_EQ(normalizedText("a\n\t b\r\nc"), "a b c");
+    EXPECT_EQ(normalizedText("a  b"), "a b");
+    EXPECT_EQ(normalizedText("trailing "), "trailing");
+    EXPECT_EQ(normalizedText(" \n\t "), "");
+    EXPECT_EQ(normalizedText("a&#32;&#10; b"), "a b");
+    EXPECT_EQ(normalizedText("a&nbsp; b"), "a\xC2\xA0 b"); // no-break spaces stay
+}
+
+// Unit Test: Text that is not UTF-8 is read as Windows-1252
+TEST(TextNormalizerTest, TranscodesLatin1) {
+    EXPECT_EQ(normalizedText("caf\xE9"), "caf\xC3\xA9");
+    EXPECT_EQ(normalizedText("\x93quoted\x94 \x80"), "\xE2\x80\x9Cquoted\xE2\x80\x9D \xE2\x82\xAC");
+    // One invalid byte decides for the whole run, including earlier bytes.
+    EXPECT_EQ(normalizedText("\xC3\xA9 &amp; \xFF"), "\xC3\x83\xC2\xA9 & \xC3\xBF");
+    EXPECT_EQ(normalizedText("\xED\xA0\x80"), "\xC3\xAD\xC2\xA0\xE2\x82\xAC"); // encoded surrogate
+    EXPECT_EQ(normalizedText("\xE2\x82"), "\xC3\xA2\xE2\x80\x9A");             // truncated sequence
+}
+
+// Unit Test: UTF-8 sequences are measured, and malformed ones rejected
+TEST(TextNormalizerTest, Utf8SequenceLength) {
+    EXPECT_EQ(utf8SequenceLength("a", 0), static_cast<size_t>(1));
+    EXPECT_EQ(utf8SequenceLength("\xC3\xA9", 0), static_cast<size_t>(2));
+    EXPECT_EQ(utf8SequenceLength("\xE2\x82\xAC", 0), static_cast<size_t>(3));
+    EXPECT_EQ(utf8SequenceLength("\xF0\x9F\x98\x80", 0), static_cast<size_t>(4));
+    EXPECT_EQ(utf8SequenceLength("\xE9t\xE9", 0), static_cast<size_t>(0));     // Latin-1
+    EXPECT_EQ(utf8SequenceLength("\xC0\xAF", 0), static_cast<size_t>(0));       // overlong
+    EXPECT_EQ(utf8SequenceLength("\xED\xA0\x80", 0), static_cast<size_t>(0));  // surrogate
+    EXPECT_EQ(utf8SequenceLength("\xF4\x90\x80\x80", 0), static_cast<size_t>(0)); // past U+10FFFF
+    EXPECT_EQ(utf8SequenceLength("\xE2\x82", 0), static_cast<size_t>(0));       // truncated
+}
+
+// Unit Test: Results do not depend on where special bytes fall in the vector blocks
+TEST(TextNormalizerTest, SameAtEveryOffset) {
+    for (size_t offset = 1; offset < 70; ++offset) {
+        const std::string padding(offset, 'x');
+        EXPECT_EQ(normalizedText(padding + "  y"), padding + " y") << offset;
+        EXPECT_EQ(normalizedText(padding + "&lt;"), padding + "<") << offset;
+        EXPECT_EQ(normalizedText(padding + "\n"), padding) << offset;
+        EXPECT_EQ(normalizedText(padding + "\xE9"), padding + "\xC3\xA9") << offset;
+        std::string out;
+        EXPECT_TRUE(normalizeText(padding + " y \xC3\xA9", &out)) << offset;
+    }
+}
+
+// Unit Test: Random runs match a byte-at-a-time reference
+TEST(TextNormalizerTest, MatchesReferenceOnRandomText) {
+    // Byte-at-a-time model of the rules, for ASCII input without references.
+    auto reference = [](const std::string& text) {
+        std::string result;
+        bool space = false;
+        for (char c : text) {
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f') {
+                space = true;
+                continue;
+            }
+            if (space && !result.empty()) result.push_back(' ');
+            space = false;
+            result.push_back(c);
+        }
+        return result;
+    };
+    static const char kAlphabet[] = {'a', 'b', ' ', ' ', '\n', '\t', '.', '&'};
+    std::mt19937 random(7);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 1);
+    std::uniform_int_distribution<size_t> length(0, 200);
+    for (int i = 0; i < 500; ++i) {
+        std::string text(length(random), 'a');
+        for (char& c : text) c = kAlphabet[pick(random)];
+        EXPECT_EQ(normalizedText(text), reference(text)) << text;
+    }
+}
+
+// Unit Test: Parsers store normalized text, pointing into the source when it is already normal
+TEST(TextNormalizerTest, ParsersNormalizeText) {
+    const std::string html = "<p>  Fish &amp;\n chips </p><p>plain</p>";
+    const Document document = SimdParser().parseDocument(html);
+    const NodeId first = document.node(document.root()).first_child;
+    const NodeId second = document.node(first).next_sibling;
+    EXPECT_EQ(document.text(first), "Fish & chips");
+    EXPECT_EQ(document.text(second), "plain");
+    EXPECT_TRUE(document.text(second).data() >= document.source().data() &&
+                document.text(second).data() < document.source().data() + document.source().size());
+    EXPECT_EQ(ScalarParser().parse(html).children[0].text, "Fish & chips");
+}
\ No newline at end of file
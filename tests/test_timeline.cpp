@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "timeline.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Test fixture for timeline tests; each test starts with capture off and nothing captured
+class TimelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setTimelineEnabled(false);
+        clearTimeline();
+    }
+
+    void TearDown() override {
+        setTimelineEnabled(false);
+        clearTimeline();
+    }
+
+    static size_t count(const std::string& text, const std::string& part) {
+        size_t found = 0;
+        for (size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) ++found;
+        return found;
+    }
+};
+
+// Unit Test: Nothing is recorded while capture is off
+TEST_F(TimelineTest, RecordsNothingWhenOff) {
+    EXPECT_FALSE(timelineEnabled());
+    { TimelineSpan span("fetch", "load", "https://example.com/"); }
+    recordTimelineSpan("curl", "net", 1, 2, "https://example.com/");
+    EXPECT_EQ(count(timelineJson(), "\"ph\":\"X\""), 0u);
+}
+
+// Unit Test: Spans become complete events tagged with tab and URL
+TEST_F(TimelineTest, ExportsCompleteEvents) {
+    setTimelineEnabled(true);
+    {
+        TimelineTabScope tab(3);
+        TimelineSpan span("parse", "load", "https://example.com/\"quoted\"");
+    }
+    recordTimelineSpan("curl", "net", 1000, 3500, "https://example.com/a.png", kNoTimelineTab);
+    const std::string json = timelineJson();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"process_name\",\"ph\":\"M\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"parse\",\"cat\":\"load\",\"ph\":\"X\""), std::string::npos) << json;
+    EXPECT_NE(json.find("\"args\":{\"tab\":3,\"url\":\"https://example.com/\\\"quoted\\\"\"}"), std::string::npos) << json;
+    // Explicit times come out in microseconds, the earliest span at zero.
+    EXPECT_NE(json.find("{\"name\":\"curl\",\"cat\":\"net\",\"ph\":\"X\",\"ts\":0.000,\"dur\":2.500,"), std::string::npos)
+        << json;
+    EXPECT_NE(json.find("\"args\":{\"url\":\"https://example.com/a.png\"}"), std::string::npos);
+    // Exporting forgets what was exported.
+    EXPECT_EQ(count(timelineJson(), "\"ph\":\"X\""), 0u);
+}
+
+// Unit Test: Tab scopes nest and restore the previous tab
+TEST_F(TimelineTest, TabScopesNest) {
+    EXPECT_EQ(timelineTab(), kNoTimelineTab);
+    {
+        TimelineTabScope outer(1);
+        {
+            TimelineTabScope inner(2);
+            EXPECT_EQ(timelineTab(), 2u);
+        }
+        EXPECT_EQ(timelineTab(), 1u);
+    }
+    EXPECT_EQ(timelineTab(), kNoTimelineTab);
+}
+
+// Unit Test: Spans of several threads are collected, in start order
+TEST_F(TimelineTest, CollectsAllThreadsInStartOrder) {
+    setTimelineEnabled(true);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            TimelineTabScope tab(t);
+            for (uint64_t i = 0; i < 100; ++i) {
+                recordTimelineSpan("decode", "image", 1000 + (i * 4 + t) * 1000, 1000 + (i * 4 + t) * 1000 + 10, "x");
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    const std::string json = timelineJson();
+    EXPECT_EQ(count(json, "\"name\":\"decode\""), 400u);
+    EXPECT_EQ(count(json, "\"tab\":2,"), 100u);
+    EXPECT_LT(json.find("\"ts\":0.000,"), json.find("\"ts\":1.000,"));
+    EXPECT_LT(json.find("\"ts\":1.000,"), json.find("\"ts\":399.000,"));
+}
+
+// Unit Test: Long URLs are truncated rather than overflowing the record
+TEST_F(TimelineTest, TruncatesLongUrls) {
+    setTimelineEnabled(true);
+    const std::string url = "https://example.com/" + std::string(500, 'a');
+    recordTimelineSpan("fetch", "load", 1, 2, url);
+    const std::string json = timelineJson();
+    EXPECT_NE(json.find("\"url\":\"" + url.substr(0, TimelineRecord::kUrlBytes) + "\""), std::string::npos);
+}
+
+// Unit Test: Capture can be stopped and restarted; spans survive until exported
+TEST_F(TimelineTest, SwitchesAtRuntime) {
+    setTimelineEnabled(true);
+    recordTimelineSpan("media", "load", 1, 2, "a");
+    setTimelineEnabled(false);
+    recordTimelineSpan("media", "load", 3, 4, "b");
+    setTimelineEnabled(true);
+    recordTimelineSpan("media", "load", 5, 6, "c");
+    const std::string json = timelineJson();
+    EXPECT_EQ(count(json, "\"name\":\"media\""), 2u);
+    EXPECT_EQ(json.find("\"url\":\"b\""), std::string::npos);
+    EXPECT_EQ(timelineDroppedCount(), 0u);
+}
+
+// Unit Test: The timeline is written to a file
+TEST_F(TimelineTest, WritesFile) {
+    setTimelineEnabled(true);
+    { TimelineSpan span("render", "load", "https://example.com/"); }
+    ASSERT_TRUE(writeTimeline("timeline_test.json"));
+    std::ifstream file("timeline_test.json");
+    std::stringstream json;
+    json << file.rdbuf();
+    EXPECT_EQ(count(json.str(), "\"name\":\"render\""), 1u);
+    std::remove("timeline_test.json");
+    EXPECT_FALSE(writeTimeline("no_such_directory/timeline.json"));
+}
\ No newline at end of file
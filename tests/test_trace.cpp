@@ -0,0 +1,125 @@
+// Compile debug and info trace points out of this file; warn and error stay.
+#define QUICKDOM_TRACE_LEVEL 2
+#include <gtest/gtest.h>
+#include "trace.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test fixture that captures flushed trace output in a temporary file
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sink_ = std::tmpfile();
+        setTraceSink(sink_);
+        traceFlush(); // records left by other tests land before start_
+        start_ = std::ftell(sink_);
+    }
+
+    void TearDown() override {
+        stopTraceFlusher();
+        setTraceSink(stderr);
+        std::fclose(sink_);
+    }
+
+    // Flushes and returns everything written to the sink so far
+    std::string flushed() {
+        traceFlush();
+        std::string text;
+        std::fseek(sink_, start_, SEEK_SET);
+        char buffer[4096];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), sink_)) > 0) text.append(buffer, n);
+        return text;
+    }
+
+    FILE* sink_ = nullptr;
+    long start_ = 0;
+};
+
+// Unit Test: Levels above QUICKDOM_TRACE_LEVEL are compiled out
+TEST_F(TraceTest, LevelsCompiledOut) {
+    static_assert(traceEnabled(TraceLevel::Error), "error must be enabled");
+    static_assert(traceEnabled(TraceLevel::Warn), "warn must be enabled");
+    static_assert(!traceEnabled(TraceLevel::Info), "info must be compiled out");
+    static_assert(!traceEnabled(TraceLevel::Debug), "debug must be compiled out");
+    static_assert(!traceEnabled(TraceLevel::Off), "off is never enabled");
+}
+
+// Unit Test: Arguments of compiled-out trace points are not evaluated
+TEST_F(TraceTest, DisabledArgumentsNotEvaluated) {
+    int evaluated = 0;
+    auto expensive = [&evaluated] { ++evaluated; return std::string("x"); };
+    QUICKDOM_TRACE_DEBUG("debug", expensive());
+    QUICKDOM_TRACE_INFO("info", expensive());
+    EXPECT_EQ(evaluated, 0);
+    EXPECT_EQ(flushed(), "");
+}
+
+// Unit Test: Enabled trace points are written with level, event and detail
+TEST_F(TraceTest, RecordsFormatted) {
+    QUICKDOM_TRACE_WARN("HTTP error", 404, " for ", std::string("http://example.com"));
+    QUICKDOM_TRACE_ERROR("Fetch error", "timeout");
+    std::string text = flushed();
+    EXPECT_NE(text.find("[warn]"), std::string::npos);
+    EXPECT_NE(text.find("HTTP error: 404 for http://example.com\n"), std::string::npos);
+    EXPECT_NE(text.find("[error]"), std::string::npos);
+    EXPECT_NE(text.find("Fetch error: timeout\n"), std::string::npos);
+    EXPECT_LT(text.find("HTTP error"), text.find("Fetch error"));
+}
+
+// Unit Test: Nothing is written until a flush
+TEST_F(TraceTest, BufferedUntilFlush) {
+    QUICKDOM_TRACE_WARN("event", "detail");
+    std::fflush(sink_);
+    EXPECT_EQ(std::ftell(sink_), start_);
+    EXPECT_NE(flushed().find("event: detail"), std::string::npos);
+}
+
+// Unit Test: Long details are truncated to the record size
+TEST_F(TraceTest, LongDetailTruncated) {
+    QUICKDOM_TRACE_WARN("long", std::string(1000, 'a'));
+    std::string text = flushed();
+    EXPECT_NE(text.find("long: " + std::string(TraceRecord::kTextBytes, 'a') + "\n"), std::string::npos);
+}
+
+// Unit Test: A full ring drops and counts records instead of blocking
+TEST_F(TraceTest, OverflowDropsRecords) {
+    const uint64_t before = traceDroppedCount();
+    const size_t total = trace_detail::TraceRing::kCapacity + 10;
+    for (size_t i = 0; i < total; ++i) QUICKDOM_TRACE_WARN("spam", i);
+    EXPECT_EQ(traceDroppedCount() - before, static_cast<uint64_t>(10));
+    std::string text = flushed();
+    EXPECT_NE(text.find("records dropped"), std::string::npos);
+}
+
+// Unit Test: Records from several threads are all flushed
+TEST_F(TraceTest, MultipleThreads) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) QUICKDOM_TRACE_WARN("worker", t, ":", i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::string text = flushed();
+    size_t lines = 0;
+    for (size_t pos = text.find("worker: "); pos != std::string::npos; pos = text.find("worker: ", pos + 1)) ++lines;
+    EXPECT_EQ(lines, static_cast<size_t>(400));
+    EXPECT_NE(text.find("worker: 3:99\n"), std::string::npos);
+}
+
+// Unit Test: The background flusher writes without an explicit flush
+TEST_F(TraceTest, BackgroundFlusher) {
+    startTraceFlusher(std::chrono::milliseconds(5));
+    QUICKDOM_TRACE_WARN("background", "flushed");
+    bool seen = false;
+    for (int i = 0; i < 200 && !seen; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::fflush(sink_);
+        seen = std::ftell(sink_) > start_;
+    }
+    EXPECT_TRUE(seen);
+    stopTraceFlusher();
+    EXPECT_NE(flushed().find("background: flushed"), std::string::npos);
+}
\ No newline at end of file